@@ -9,26 +9,51 @@
 * 
 * 
 *      Summary: This file is used to implement our version of 2D bit
-*               array. It incorporates Hanson's Bit_T but index in
-*               different way to make 1D array into 2D array.
+*               array. Bits are kept in 64-bit words, bit k being bit
+*               k % 64 of word k / 64, and bit [i, j] is bit
+*               base + j * stride + i. A new bit array starts every row
+*               on a word boundary; a view uses the base and stride of
+*               the memory it looks at, which may be a caller's buffer
+*               or a rectangle of another bit array.
 *     
 **************************************************************************/
 
+/* for posix_memalign, and madvise with MADV_HUGEPAGE */
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+#include <sys/mman.h>
 #include "bit2.h"
-#include "bit.h"
+#include "bit2_inline.h"
+#include "bit2_atomic.h"
 #include "assert.h"
 #include "mem.h"
 
 #define T Bit2_T
 
-/* data that our bit array element holds */
-struct T {
-    int width;
-    int height;
-    Bit_T bit;
-};
+/* owner of a bit array from Bit2_new_aligned: one block, words first */
+#define OWNER_BLOCK 2
+/* owner of a bit array from Bit2_new_arena: the arena frees it */
+#define OWNER_ARENA 3
+
+/* put the low count bits of bits into row j from column i */
+static void store_bits(T bit2, int i, int j, int count, uint64_t bits);
+/* reverse the order of the 64 bits of a word */
+static uint64_t reverse_bits(uint64_t bits);
+/* transpose a 64 x 64 bit matrix, word r being row r */
+static void transpose_block(uint64_t block[64]);
+/* bring the summary in line with words first to last, if there is one */
+static void summary_update(T bit2, size_t first, size_t last);
+/* first set bit at or after pos in a summary level, or SIZE_MAX */
+static size_t summary_find(const Bit2_summary *summary, int level,
+                           size_t pos);
+/* number of words from the first to the last a bit array's bits touch */
+static size_t word_count(T bit2);
 
 /****************************************************************
  * Bit2_new
@@ -39,24 +64,183 @@ struct T {
  *         2) Integer value of height of the desired bit array
  *         3) Integer value of byte-size of each array element holds
  * Output: Bit2_T type array
- * Implementation: 
+ * Implementation: Round the width up to whole words for the stride
+ *                 and allocate zeroed words for every row.
  *****************************************************************/
 T Bit2_new(int width, int height)
 {
     assert(width >= 0 && height >= 0);
 
+    /* Mem_calloc multiplies longs; raise Mem_Failed rather than wrap */
+    uint64_t row_words = ((uint64_t) width + 63) / 64;
+    if (row_words * height >= LONG_MAX / sizeof(uint64_t)) {
+        RAISE(Mem_Failed);
+    }
+
     T bit2;
     /* allocates a new 2D Bit */
     NEW(bit2);
 
     /* store bit information */
-    bit2->bit = Bit_new(width * height);
+    bit2->words = CALLOC((long) (row_words * height) + 1, sizeof(uint64_t));
     bit2->width = width;
     bit2->height = height;
+    bit2->base = 0;
+    bit2->stride = row_words * 64;
+    bit2->owner = 1;
+    bit2->summary = NULL;
 
     return bit2;
 }
 
+/****************************************************************
+ * Bit2_new_aligned
+ * Description: Create a new 2D bit array in one aligned block
+ * Inputs: 1) Integer width and height of the bit array
+ *         2) Alignment of the block in bytes
+ * Output: Bit2_T type array
+ * Implementation: Same as UArray2_new_aligned: rows are padded to
+ *                 whole aligned words, the words come first and
+ *                 the header after them, and huge pages are asked
+ *                 for before the words are zeroed.
+ *****************************************************************/
+T Bit2_new_aligned(int width, int height, size_t alignment)
+{
+    assert(width >= 0 && height >= 0);
+    assert(alignment >= sizeof(uint64_t) &&
+           (alignment & (alignment - 1)) == 0);
+
+    size_t row_alignment = alignment < Bit2_CACHE_LINE ?
+                           alignment : Bit2_CACHE_LINE;
+    size_t align_words = row_alignment / sizeof(uint64_t);
+    size_t row_words = ((size_t) width + 63) / 64;
+    row_words = (row_words + align_words - 1) / align_words * align_words;
+    if (height != 0 &&
+        row_words > (size_t) LONG_MAX / sizeof(uint64_t) / height) {
+        RAISE(Mem_Failed);
+    }
+    size_t header_at = row_words * height * sizeof(uint64_t);
+
+    void *block;
+    if (posix_memalign(&block, alignment, header_at + sizeof(struct T))
+        != 0) {
+        RAISE(Mem_Failed);
+    }
+#ifdef MADV_HUGEPAGE
+    if (alignment % Bit2_HUGE_PAGE == 0) {
+        madvise(block, header_at, MADV_HUGEPAGE);
+    }
+#endif
+    memset(block, 0, header_at);
+
+    T bit2 = (T) ((char *) block + header_at);
+    bit2->words = block;
+    bit2->width = width;
+    bit2->height = height;
+    bit2->base = 0;
+    bit2->stride = row_words * 64;
+    bit2->owner = OWNER_BLOCK;
+    bit2->summary = NULL;
+
+    return bit2;
+}
+
+/****************************************************************
+ * Bit2_new_arena
+ * Description: Create a new 2D bit array in an arena
+ * Inputs: 1) Arena_T to allocate from
+ *         2) Integer width and height of the bit array
+ * Output: Bit2_T type array
+ * Implementation: Same as Bit2_new, with the header and zeroed
+ *                 words from the arena. The owner tells Bit2_free
+ *                 to leave both alone.
+ *****************************************************************/
+T Bit2_new_arena(Arena_T arena, int width, int height)
+{
+    assert(arena != NULL);
+    assert(width >= 0 && height >= 0);
+
+    uint64_t row_words = ((uint64_t) width + 63) / 64;
+    if (row_words * height >= LONG_MAX / sizeof(uint64_t)) {
+        RAISE(Mem_Failed);
+    }
+
+    T bit2 = Arena_alloc(arena, sizeof(*bit2), __FILE__, __LINE__);
+    bit2->words = Arena_calloc(arena, (long) (row_words * height) + 1,
+                               sizeof(uint64_t), __FILE__, __LINE__);
+    bit2->width = width;
+    bit2->height = height;
+    bit2->base = 0;
+    bit2->stride = row_words * 64;
+    bit2->owner = OWNER_ARENA;
+    bit2->summary = NULL;
+
+    return bit2;
+}
+
+/****************************************************************
+ * Bit2_wrap
+ * Description: Create a 2D bit array over a caller's words
+ * Inputs: 1) Pointer to the caller's words
+ *         2) Integer width and height of the bit array
+ *         3) Integer stride, bits from one row to the next
+ * Output: Bit2_T type array that uses the words in place
+ * Implementation: Only the header is allocated, and owner is 0 so
+ *                 Bit2_free leaves the words alone.
+ *****************************************************************/
+T Bit2_wrap(uint64_t *words, int width, int height, int stride)
+{
+    assert(width >= 0 && height >= 0);
+    assert(stride >= width);
+    assert(words != NULL || width == 0 || height == 0);
+
+    T bit2;
+    NEW(bit2);
+
+    bit2->words = words;
+    bit2->width = width;
+    bit2->height = height;
+    bit2->base = 0;
+    bit2->stride = (size_t) stride;
+    bit2->owner = 0;
+    bit2->summary = NULL;
+
+    return bit2;
+}
+
+/****************************************************************
+ * Bit2_view
+ * Description: Create a 2D bit array for a rectangle of another
+ *              one, without copying
+ * Inputs: 1) Bit2_T type array being viewed
+ *         2) Integer column i and row j of the rectangle's corner
+ *         3) Integer width and height of the rectangle
+ * Output: Bit2_T type array whose [0, 0] is [i, j] of the other
+ * Implementation: Check the rectangle is inside the bit array, then
+ *                 share its words, stride and summary, moving the
+ *                 base to bit [i, j].
+ *****************************************************************/
+T Bit2_view(T bit2, int i, int j, int width, int height)
+{
+    assert(bit2 != NULL);
+    assert(width >= 0 && height >= 0);
+    assert(i >= 0 && j >= 0);
+    assert(i + width <= bit2->width && j + height <= bit2->height);
+
+    T view;
+    NEW(view);
+
+    view->words = bit2->words;
+    view->width = width;
+    view->height = height;
+    view->base = bit2->base + j * bit2->stride + i;
+    view->stride = bit2->stride;
+    view->owner = 0;
+    view->summary = bit2->summary;
+
+    return view;
+}
+
 /******************************************************************
  * Bit2_width
  * Description: Get width value of bit array which is the
@@ -92,22 +276,13 @@ int Bit2_height(T bit2)
  *         2) Integer value i which is column index of bit array
  *         3) Integer value j which is row index of bit array
  *         4) Integer value value which is the value we are inserting
- * Output: Integer value of the inserted value
- * Implementation: 
+ * Output: Integer value of the bit before it was replaced
+ * Implementation: Same code as Bit2_put_fast in bit2_inline.h, for
+ *                 clients that only see bit2.h.
  ******************************************************************/
 int Bit2_put(T bit2, int i, int j, int value)
 {
-    assert(bit2 != NULL);
-    assert(value == 0 || value == 1);
-
-    int width = Bit2_width(bit2);
-    int height = Bit2_height(bit2);
-
-    assert(i >= 0 && i < width && j >= 0 && j < height);
-
-    int index = width * j + i;
-
-    return Bit_put(bit2->bit, index, value);
+    return Bit2_put_fast(bit2, i, j, value);
 }
 
 /******************************************************************
@@ -117,20 +292,11 @@ int Bit2_put(T bit2, int i, int j, int value)
  *         2) Integer value i which is column index of bit array
  *         3) Integer value j which is row index of bit array
  * Output: Integer value of the bit array element at index [i,j]
- * Implementation: 
+ * Implementation: Same code as Bit2_get_fast in bit2_inline.h.
  ******************************************************************/
 int Bit2_get(T bit2, int i, int j)
 {
-    assert(bit2 != NULL);
-
-    int width = Bit2_width(bit2);
-    int height = Bit2_height(bit2);
-
-    assert(i >= 0 && i < width && j >= 0 && j < height);
-
-    int index = width * j + i;
-
-    return Bit_get(bit2->bit, index);
+    return Bit2_get_fast(bit2, i, j);
 }
 
 /*****************************************************************
@@ -157,7 +323,7 @@ void Bit2_map_col_major(T bit2, void apply(int i, int j, T bit2,
 
     for (int idx = 0; idx < width; idx++) {
         for (int jdx = 0; jdx < height; jdx++) {
-            apply(idx, jdx, bit2, Bit2_get(bit2, idx, jdx), cl);
+            apply(idx, jdx, bit2, Bit2_get_fast(bit2, idx, jdx), cl);
         }
     }
 }
@@ -186,7 +352,489 @@ void Bit2_map_row_major(T bit2, void apply(int i, int j, T bit2,
 
     for (int jdx = 0; jdx < height; jdx++) {
         for (int idx = 0; idx < width; idx++) {
-            apply(idx, jdx, bit2, Bit2_get(bit2, idx, jdx), cl);
+            apply(idx, jdx, bit2, Bit2_get_fast(bit2, idx, jdx), cl);
+        }
+    }
+}
+
+/******************************************************************
+ * Bit2_map_row_major_until
+ * Description: Apply a function to the bits row by row until it
+ *              asks to stop
+ * Inputs: 1) Bit2_T type bit array
+ *         2) An int apply function, nonzero meaning stop
+ *         3) A void pointer closure
+ *         4) Integer pointers for where it stopped, or null
+ * Output: 1 if apply stopped the traversal, 0 if it did not
+ * Implementation: Return as soon as apply returns nonzero.
+ ******************************************************************/
+int Bit2_map_row_major_until(T bit2, int apply(int i, int j, T bit2,
+                             int value, void *cl), void *cl,
+                             int *stop_i, int *stop_j)
+{
+    assert(bit2 != NULL);
+    assert(apply != NULL);
+
+    for (int jdx = 0; jdx < bit2->height; jdx++) {
+        for (int idx = 0; idx < bit2->width; idx++) {
+            if (apply(idx, jdx, bit2, Bit2_get_fast(bit2, idx, jdx), cl)) {
+                if (stop_i != NULL) {
+                    *stop_i = idx;
+                }
+                if (stop_j != NULL) {
+                    *stop_j = jdx;
+                }
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+/******************************************************************
+ * Bit2_map_col_major_until
+ * Description: Apply a function to the bits column by column until
+ *              it asks to stop
+ * Inputs: Same as Bit2_map_row_major_until
+ * Output: 1 if apply stopped the traversal, 0 if it did not
+ * Implementation: Return as soon as apply returns nonzero.
+ ******************************************************************/
+int Bit2_map_col_major_until(T bit2, int apply(int i, int j, T bit2,
+                             int value, void *cl), void *cl,
+                             int *stop_i, int *stop_j)
+{
+    assert(bit2 != NULL);
+    assert(apply != NULL);
+
+    for (int idx = 0; idx < bit2->width; idx++) {
+        for (int jdx = 0; jdx < bit2->height; jdx++) {
+            if (apply(idx, jdx, bit2, Bit2_get_fast(bit2, idx, jdx), cl)) {
+                if (stop_i != NULL) {
+                    *stop_i = idx;
+                }
+                if (stop_j != NULL) {
+                    *stop_j = jdx;
+                }
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+/******************************************************************
+ * Bit2_orient
+ * Description: Make a transposed, rotated or flipped copy of a bit
+ *              array
+ * Inputs: 1) Bit2_T type bit array
+ *         2) Bit2_orientation saying how to turn it
+ * Output: New Bit2_T type bit array
+ * Implementation: Turns that swap rows and columns give a height by
+ *                 width bit array. Bit2_orient_into fills it.
+ ******************************************************************/
+T Bit2_orient(T bit2, Bit2_orientation how)
+{
+    assert(bit2 != NULL);
+
+    int swap = how == Bit2_TRANSPOSE || how == Bit2_ROTATE_90 ||
+               how == Bit2_ROTATE_270;
+    T result = Bit2_new(swap ? bit2->height : bit2->width,
+                        swap ? bit2->width : bit2->height);
+
+    Bit2_orient_into(result, bit2, how);
+    return result;
+}
+
+/******************************************************************
+ * Bit2_orient_into
+ * Description: Write a transposed, rotated or flipped copy of a bit
+ *              array into another
+ * Inputs: 1) Bit2_T type bit array to write
+ *         2) Bit2_T type bit array to read
+ *         3) Bit2_orientation saying how to turn it
+ * Output: Void
+ * Implementation: Destination bit [i, j] is source bit [u, v], where
+ *                 (u, v) is (i, j) or (j, i), and u or v may be
+ *                 mirrored. Without the swap, each destination row
+ *                 is a source row, copied 64 bits at a time and bit
+ *                 reversed if mirrored. With it, the destination is
+ *                 done in 64 x 64 blocks: the block is read as 64
+ *                 source rows of 64 bits, which makes word r hold
+ *                 destination column r, then transposed so word c
+ *                 holds destination row c.
+ ******************************************************************/
+void Bit2_orient_into(T dest, T source, Bit2_orientation how)
+{
+    assert(dest != NULL && source != NULL);
+
+    int swap = 0, mirror_u = 0, mirror_v = 0;
+    switch (how) {
+    case Bit2_TRANSPOSE:       swap = 1;                   break;
+    case Bit2_ROTATE_90:       swap = 1; mirror_v = 1;     break;
+    case Bit2_ROTATE_180:      mirror_u = 1; mirror_v = 1; break;
+    case Bit2_ROTATE_270:      swap = 1; mirror_u = 1;     break;
+    case Bit2_FLIP_HORIZONTAL: mirror_u = 1;               break;
+    case Bit2_FLIP_VERTICAL:   mirror_v = 1;               break;
+    default:                   assert(0);
+    }
+
+    int width = dest->width;
+    int height = dest->height;
+    int source_width = source->width;
+    int source_height = source->height;
+    assert(width == (swap ? source_height : source_width));
+    assert(height == (swap ? source_width : source_height));
+
+    if (!swap) {
+        for (int j = 0; j < height; j++) {
+            int v = mirror_v ? source_height - 1 - j : j;
+            for (int i = 0; i < width; i += 64) {
+                int count = width - i < 64 ? width - i : 64;
+                if (mirror_u) {
+                    uint64_t bits = Bit2_load_bits(source,
+                                                   width - i - count, v,
+                                                   count);
+                    bits = reverse_bits(bits) >> (64 - count);
+                    store_bits(dest, i, j, count, bits);
+                }
+                else {
+                    store_bits(dest, i, j, count,
+                               Bit2_load_bits(source, i, v, count));
+                }
+            }
+        }
+        return;
+    }
+
+    uint64_t block[64];
+    for (int j = 0; j < height; j += 64) {
+        int rows = height - j < 64 ? height - j : 64;
+        int u = mirror_u ? source_width - j - rows : j;
+        for (int i = 0; i < width; i += 64) {
+            int cols = width - i < 64 ? width - i : 64;
+            for (int r = 0; r < 64; r++) {
+                block[r] = 0;
+                if (r >= cols) {
+                    continue;
+                }
+                int v = mirror_v ? source_height - 1 - (i + r) : i + r;
+                block[r] = Bit2_load_bits(source, u, v, rows);
+                if (mirror_u) {
+                    block[r] = reverse_bits(block[r]) >> (64 - rows);
+                }
+            }
+            transpose_block(block);
+            for (int c = 0; c < rows; c++) {
+                store_bits(dest, i, j + c, cols, block[c]);
+            }
+        }
+    }
+}
+
+/******************************************************************
+ * Bit2_fill
+ * Description: Set every bit of a rectangle to one value
+ * Inputs: 1) Bit2_T type bit array
+ *         2) Integer column i and row j of the rectangle's corner
+ *         3) Integer width and height of the rectangle
+ *         4) Integer value, 0 or 1
+ * Output: Void
+ * Implementation: For each row, mask the value into the bits of the
+ *                 first and last words the row covers and store
+ *                 the words in between whole, then update the
+ *                 summary for those words.
+ ******************************************************************/
+void Bit2_fill(T bit2, int i, int j, int width, int height, int value)
+{
+    assert(bit2 != NULL);
+    assert(value == 0 || value == 1);
+    assert(width >= 0 && height >= 0 && i >= 0 && j >= 0);
+    assert(i + width <= bit2->width && j + height <= bit2->height);
+
+    if (width == 0) {
+        return;
+    }
+
+    uint64_t fill = value ? ~(uint64_t) 0 : 0;
+    for (int row = 0; row < height; row++) {
+        size_t first = bit2->base + (j + row) * bit2->stride + i;
+        size_t last = first + width - 1;
+        uint64_t *words = bit2->words;
+        uint64_t head = ~(uint64_t) 0 << (first % 64);
+        uint64_t tail = ~(uint64_t) 0 >> (63 - last % 64);
+
+        if (first / 64 == last / 64) {
+            uint64_t mask = head & tail;
+            words[first / 64] = (words[first / 64] & ~mask) | (fill & mask);
+        }
+        else {
+            words[first / 64] = (words[first / 64] & ~head) | (fill & head);
+            for (size_t w = first / 64 + 1; w < last / 64; w++) {
+                words[w] = fill;
+            }
+            words[last / 64] = (words[last / 64] & ~tail) | (fill & tail);
+        }
+        summary_update(bit2, first / 64, last / 64);
+    }
+}
+
+/******************************************************************
+ * Bit2_copy
+ * Description: Copy a rectangle of one bit array into another
+ * Inputs: 1) Bit2_T type bit array to write, and the corner to write
+ *            at
+ *         2) Bit2_T type bit array to read, and the corner to read
+ *            from
+ *         3) Integer width and height of the rectangle
+ * Output: Void
+ * Implementation: Move each row in runs of 64 bits with
+ *                 Bit2_load_bits and store_bits, which handle runs
+ *                 that start anywhere in a word.
+ ******************************************************************/
+void Bit2_copy(T dest, int i, int j, T source, int source_i,
+               int source_j, int width, int height)
+{
+    assert(dest != NULL && source != NULL);
+    assert(width >= 0 && height >= 0);
+    assert(i >= 0 && j >= 0 && source_i >= 0 && source_j >= 0);
+    assert(i + width <= dest->width && j + height <= dest->height);
+    assert(source_i + width <= source->width &&
+           source_j + height <= source->height);
+
+    for (int row = 0; row < height; row++) {
+        for (int col = 0; col < width; col += 64) {
+            int count = width - col < 64 ? width - col : 64;
+            store_bits(dest, i + col, j + row, count,
+                       Bit2_load_bits(source, source_i + col,
+                                      source_j + row, count));
+        }
+    }
+}
+
+/******************************************************************
+ * Bit2_clone
+ * Description: Make a copy of a whole bit array
+ * Inputs: Bit2_T type bit array
+ * Output: New Bit2_T type bit array owning a copy of the bits
+ * Implementation: Make a new bit array of the same shape and copy
+ *                 the whole of the old one into it.
+ ******************************************************************/
+T Bit2_clone(T bit2)
+{
+    assert(bit2 != NULL);
+
+    T clone = Bit2_new(bit2->width, bit2->height);
+    Bit2_copy(clone, 0, 0, bit2, 0, 0, bit2->width, bit2->height);
+    return clone;
+}
+
+/******************************************************************
+ * Bit2_summarize
+ * Description: Make or rebuild the occupancy summary of a bit array
+ * Inputs: Bit2_T type bit array
+ * Output: Void
+ * Implementation: Level 0 has a bit for every word the bit array
+ *                 touches, and each level above a bit per word of
+ *                 the one below, up to a level of one word. All the
+ *                 levels are one allocation. A summary the bit
+ *                 array already has, maybe shared from the array it
+ *                 views, is rebuilt in place over the words it was
+ *                 made for.
+ ******************************************************************/
+void Bit2_summarize(T bit2)
+{
+    assert(bit2 != NULL);
+
+    Bit2_summary *summary = bit2->summary;
+    if (summary == NULL) {
+        NEW(summary);
+        summary->owner = bit2;
+        summary->length[0] = word_count(bit2);
+
+        size_t total = 0;
+        int levels = 0;
+        for (;;) {
+            size_t words = (summary->length[levels] + 63) / 64;
+            total += words > 0 ? words : 1;
+            levels++;
+            if (words <= 1) {
+                break;
+            }
+            summary->length[levels] = words;
+        }
+        summary->levels = levels;
+        summary->level[0] = ALLOC((long) (total * sizeof(uint64_t)));
+        for (int l = 1; l < levels; l++) {
+            size_t below = (summary->length[l - 1] + 63) / 64;
+            summary->level[l] = summary->level[l - 1] +
+                                (below > 0 ? below : 1);
+        }
+        bit2->summary = summary;
+    }
+
+    /* each level from the words, or from the level below */
+    const uint64_t *below = bit2->words;
+    for (int l = 0; l < summary->levels; l++) {
+        size_t length = summary->length[l];
+        uint64_t *level = summary->level[l];
+        for (size_t w = 0; w < (length + 63) / 64 || w == 0; w++) {
+            level[w] = 0;
+        }
+        for (size_t k = 0; k < length; k++) {
+            if (below[k] != 0) {
+                level[k / 64] |= (uint64_t) 1 << (k % 64);
+            }
+        }
+        below = level;
+    }
+}
+
+/******************************************************************
+ * Bit2_summary_note
+ * Description: Record that a word became zero or stopped being zero
+ * Inputs: 1) The summary
+ *         2) Index of the word
+ *         3) Integer, nonzero if the word is now not zero
+ * Output: Void
+ * Implementation: Set or clear the word's bit in level 0. If that
+ *                 made its level word go from zero to not zero, or
+ *                 back, do the same for that word in the level
+ *                 above, and so on.
+ ******************************************************************/
+void Bit2_summary_note(Bit2_summary *summary, size_t w, int nonzero)
+{
+    for (int l = 0; l < summary->levels && w < summary->length[l]; l++) {
+        uint64_t *word = &summary->level[l][w / 64];
+        uint64_t bit = (uint64_t) 1 << (w % 64);
+        uint64_t old = *word;
+
+        *word = nonzero ? old | bit : old & ~bit;
+        if ((old == 0) == (*word == 0)) {
+            return;
+        }
+        w /= 64;
+    }
+}
+
+/******************************************************************
+ * Bit2_summary_mark_atomic
+ * Description: Record that a word stopped being zero, safely against
+ *              other threads doing the same
+ * Inputs: 1) The summary
+ *         2) Index of the word
+ * Output: Void
+ * Implementation: Or the word's bit into level 0 atomically, and
+ *                 carry on up while the level word it went into was
+ *                 zero before. Summary bits are only ever set here,
+ *                 so the order of the ors does not matter.
+ ******************************************************************/
+void Bit2_summary_mark_atomic(Bit2_summary *summary, size_t w)
+{
+    for (int l = 0; l < summary->levels && w < summary->length[l]; l++) {
+        uint64_t bit = (uint64_t) 1 << (w % 64);
+        uint64_t old = __atomic_fetch_or(&summary->level[l][w / 64], bit,
+                                         __ATOMIC_RELAXED);
+        if (old != 0) {
+            return;
+        }
+        w /= 64;
+    }
+}
+
+/******************************************************************
+ * Bit2_next_set
+ * Description: Find the next 1 bit in row-major order
+ * Inputs: 1) Bit2_T type bit array
+ *         2) Integer pointers to the column and row to start at
+ * Output: 1 if a 1 bit was found, its place in *i and *j, or 0
+ * Implementation: Look in the rest of the word holding the start.
+ *                 If it is all 0, find the next word that is not:
+ *                 through the summary if there is one, or one word
+ *                 after another. A bit found past the end of the
+ *                 row may be in a later row, or in the gap between
+ *                 rows, in which case the search goes on from the
+ *                 start of the next row. A summary bit over a word
+ *                 that turns out to be zero is passed over.
+ ******************************************************************/
+int Bit2_next_set(T bit2, int *i, int *j)
+{
+    assert(bit2 != NULL && i != NULL && j != NULL);
+    assert((*i >= 0 && *i < bit2->width && *j >= 0 &&
+            *j < bit2->height) || (*i == 0 && *j == bit2->height));
+
+    if (bit2->width == 0) {
+        return 0;
+    }
+
+    size_t end = word_count(bit2);
+    const Bit2_summary *summary = bit2->summary;
+    int col = *i;
+    int row = *j;
+
+    while (row < bit2->height) {
+        size_t row_start = bit2->base + row * bit2->stride;
+        size_t first = row_start + col;
+        size_t w = first / 64;
+        uint64_t bits = bit2->words[w] & (~(uint64_t) 0 << (first % 64));
+
+        /* a summary bit may be left over a word that atomics cleared */
+        while (bits == 0) {
+            if (summary != NULL) {
+                w = summary_find(summary, 0, w + 1);
+                if (w > end) {
+                    w = end;
+                }
+            }
+            else {
+                for (w++; w < end && bit2->words[w] == 0; w++) {
+                }
+            }
+            if (w >= end) {
+                return 0;
+            }
+            bits = bit2->words[w];
+        }
+
+        size_t k = w * 64 + __builtin_ctzll(bits);
+        if (k < row_start + bit2->width) {
+            *i = (int) (k - row_start);
+            *j = row;
+            return 1;
+        }
+        size_t offset = k - bit2->base;
+        row = (int) (offset / bit2->stride);
+        col = (int) (offset % bit2->stride);
+        if (col >= bit2->width) {
+            row++;
+            col = 0;
+        }
+    }
+    return 0;
+}
+
+/******************************************************************
+ * Bit2_map_ones
+ * Description: Apply a function to every 1 bit, row by row
+ * Inputs: 1) Bit2_T type bit array
+ *         2) The apply function
+ *         3) A void pointer closure
+ * Output: Void
+ * Implementation: Step from one 1 bit to the next with
+ *                 Bit2_next_set.
+ ******************************************************************/
+void Bit2_map_ones(T bit2, void apply(int i, int j, T bit2, int value,
+                   void *cl), void *cl)
+{
+    assert(bit2 != NULL);
+    assert(apply != NULL);
+
+    int i = 0;
+    int j = 0;
+    while (Bit2_next_set(bit2, &i, &j)) {
+        apply(i, j, bit2, 1, cl);
+        if (++i == bit2->width) {
+            i = 0;
+            j++;
         }
     }
 }
@@ -196,13 +844,186 @@ void Bit2_map_row_major(T bit2, void apply(int i, int j, T bit2,
  * Description: Deallocate memory used by bit array
  * Inputs: An address to bit array
  * Output: Void
- * Implementation: 
+ * Implementation: Free the words if this bit array allocated them,
+ *                 then the bit array itself. A bit array from
+ *                 Bit2_new_aligned is one block, freed all at once,
+ *                 and one from Bit2_new_arena is left for its arena.
+ *                 A summary is freed by the bit array that made it,
+ *                 not by views sharing it.
  ******************************************************************/
 void Bit2_free(T *bit2)
 {
     assert(bit2 != NULL && *bit2 != NULL);
-    assert((*bit2)->bit != NULL);
 
-    Bit_free(&((*bit2)->bit));
+    Bit2_summary *summary = (*bit2)->summary;
+    if (summary != NULL && summary->owner == *bit2) {
+        FREE(summary->level[0]);
+        FREE(summary);
+    }
+    if ((*bit2)->owner == OWNER_ARENA) {
+        return;
+    }
+    if ((*bit2)->owner == OWNER_BLOCK) {
+        free((*bit2)->words);
+        return;
+    }
+    if ((*bit2)->owner) {
+        FREE((*bit2)->words);
+    }
     free(*bit2);
-}
\ No newline at end of file
+}
+
+/******************************************************************
+ * store_bits
+ * Description: Write a run of bits into one row of a bit array
+ * Inputs: 1) Bit2_T type bit array
+ *         2) Integer column i and row j of the first bit
+ *         3) Integer count of bits, 1 to 64, inside the row
+ *         4) The bits, bit 0 going to column i, zero above count
+ * Output: Void
+ * Implementation: Mask the run into the one or two words it covers,
+ *                 leaving the other bits of those words alone, and
+ *                 update the summary for them.
+ ******************************************************************/
+static void store_bits(T bit2, int i, int j, int count, uint64_t bits)
+{
+    size_t index = bit2->base + j * bit2->stride + i;
+    uint64_t *word = &bit2->words[index / 64];
+    unsigned offset = index % 64;
+    uint64_t mask = count < 64 ? ((uint64_t) 1 << count) - 1 : ~(uint64_t) 0;
+
+    word[0] = (word[0] & ~(mask << offset)) | (bits << offset);
+    if (offset + count > 64) {
+        word[1] = (word[1] & ~(mask >> (64 - offset))) |
+                  (bits >> (64 - offset));
+        summary_update(bit2, index / 64, index / 64 + 1);
+    }
+    else {
+        summary_update(bit2, index / 64, index / 64);
+    }
+}
+
+/******************************************************************
+ * reverse_bits
+ * Description: Reverse the order of the bits of a word
+ * Inputs: The word
+ * Output: The word with bit k moved to bit 63 - k
+ * Implementation: Swap halves, then quarters, and so on down to
+ *                 single bits.
+ ******************************************************************/
+static uint64_t reverse_bits(uint64_t bits)
+{
+    bits = (bits >> 32) | (bits << 32);
+    bits = ((bits >> 16) & 0x0000FFFF0000FFFFull) |
+           ((bits & 0x0000FFFF0000FFFFull) << 16);
+    bits = ((bits >> 8) & 0x00FF00FF00FF00FFull) |
+           ((bits & 0x00FF00FF00FF00FFull) << 8);
+    bits = ((bits >> 4) & 0x0F0F0F0F0F0F0F0Full) |
+           ((bits & 0x0F0F0F0F0F0F0F0Full) << 4);
+    bits = ((bits >> 2) & 0x3333333333333333ull) |
+           ((bits & 0x3333333333333333ull) << 2);
+    bits = ((bits >> 1) & 0x5555555555555555ull) |
+           ((bits & 0x5555555555555555ull) << 1);
+    return bits;
+}
+
+/******************************************************************
+ * transpose_block
+ * Description: Transpose a 64 x 64 bit matrix in place
+ * Inputs: Array of 64 words, bit c of word r being entry [r, c]
+ * Output: Void, bit c of word r is now what bit r of word c was
+ * Implementation: Swap the top-right and bottom-left 32 x 32
+ *                 quarters, then do the same inside every 32 x 32
+ *                 quarter at once with masks, and so on down to
+ *                 1 x 1, six rounds of 32 word pairs.
+ ******************************************************************/
+static void transpose_block(uint64_t block[64])
+{
+    uint64_t mask = 0x00000000FFFFFFFFull;
+
+    for (int half = 32; half != 0; half >>= 1, mask ^= mask << half) {
+        for (int r = 0; r < 64; r = ((r | half) + 1) & ~half) {
+            uint64_t swap = ((block[r] >> half) ^ block[r | half]) & mask;
+            block[r] ^= swap << half;
+            block[r | half] ^= swap;
+        }
+    }
+}
+
+/******************************************************************
+ * summary_update
+ * Description: Bring a bit array's summary in line with some words
+ * Inputs: 1) Bit2_T type bit array
+ *         2) Index of the first and last words written
+ * Output: Void
+ * Implementation: Nothing without a summary. Otherwise note each
+ *                 word whose summary bit is wrong.
+ ******************************************************************/
+static void summary_update(T bit2, size_t first, size_t last)
+{
+    Bit2_summary *summary = bit2->summary;
+    if (summary == NULL) {
+        return;
+    }
+    for (size_t w = first; w <= last && w < summary->length[0]; w++) {
+        int nonzero = bit2->words[w] != 0;
+        int marked = (summary->level[0][w / 64] >> (w % 64)) & 1;
+        if (nonzero != marked) {
+            Bit2_summary_note(summary, w, nonzero);
+        }
+    }
+}
+
+/******************************************************************
+ * summary_find
+ * Description: Find the first set bit at or after a position in one
+ *              level of a summary
+ * Inputs: 1) The summary
+ *         2) Integer level
+ *         3) Bit position to start at
+ * Output: Position of the set bit, or SIZE_MAX if there is none
+ * Implementation: Look in the rest of the word holding pos. If it is
+ *                 all 0, the next word of this level that is not is
+ *                 the next set bit of the level above, so find that
+ *                 and take the lowest bit of its word here. The top
+ *                 level is one word, so the search ends there.
+ ******************************************************************/
+static size_t summary_find(const Bit2_summary *summary, int level,
+                           size_t pos)
+{
+    if (pos >= summary->length[level]) {
+        return SIZE_MAX;
+    }
+
+    const uint64_t *bits = summary->level[level];
+    uint64_t word = bits[pos / 64] & (~(uint64_t) 0 << (pos % 64));
+    if (word != 0) {
+        return pos / 64 * 64 + __builtin_ctzll(word);
+    }
+    if (level + 1 == summary->levels) {
+        return SIZE_MAX;
+    }
+
+    size_t next = summary_find(summary, level + 1, pos / 64 + 1);
+    if (next == SIZE_MAX) {
+        return SIZE_MAX;
+    }
+    return next * 64 + __builtin_ctzll(bits[next]);
+}
+
+/******************************************************************
+ * word_count
+ * Description: Count the words a bit array's bits are in
+ * Inputs: Bit2_T type bit array
+ * Output: Index of the word after the one holding its last bit, 0
+ *         for an empty bit array
+ ******************************************************************/
+static size_t word_count(T bit2)
+{
+    if (bit2->width == 0 || bit2->height == 0) {
+        return 0;
+    }
+    size_t last = bit2->base + (bit2->height - 1) * bit2->stride +
+                  bit2->width - 1;
+    return last / 64 + 1;
+}
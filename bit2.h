@@ -9,17 +9,45 @@
 * 
 * 
 *      Summary: This is the header file for the bit2 data structure. 
-*               Our Bit2 incorporate Bit_T bit vectors, allowing 
+*               Our Bit2 keeps bits packed in 64-bit words, allowing 
 *               for a representation of a 2D bitmap.
+*               bit2_inline.h has inlined Bit2_get and Bit2_put for
+*               hot loops.
+*               Bit positions are computed in size_t, so a bit array
+*               may hold more than 2^31 bits as long as each side is
+*               under 2^31.
+*               A bit array may also keep an occupancy summary, made
+*               by Bit2_summarize, so searches for 1 bits skip white
+*               regions a block at a time.
 *     
 **************************************************************************/
 
 #ifndef BIT2_INCLUDED
 #define BIT2_INCLUDED
 
+#include <stddef.h>
+#include <stdint.h>
+#include "arena.h"
+
 #define T Bit2_T
 typedef struct T *T;
 
+/* alignments for Bit2_new_aligned */
+enum {
+    Bit2_CACHE_LINE = 64,               /* rows start on cache lines */
+    Bit2_HUGE_PAGE = 2 * 1024 * 1024    /* and the block on a huge page */
+};
+
+/* how Bit2_orient turns a bit array; rotations are clockwise */
+typedef enum {
+    Bit2_TRANSPOSE,             /* [i, j] goes to [j, i] */
+    Bit2_ROTATE_90,
+    Bit2_ROTATE_180,
+    Bit2_ROTATE_270,
+    Bit2_FLIP_HORIZONTAL,       /* mirror left to right */
+    Bit2_FLIP_VERTICAL          /* mirror top to bottom */
+} Bit2_orientation;
+
 /****************************************************************
  * Bit2_new
  * Description: Create a new 2D bit array with size of width
@@ -34,9 +62,84 @@ typedef struct T *T;
  *.             exit with assert.
  *              Otherwise, return an 2D bit array of given width
  *              & height with each element of given size.
+ *              If the words cannot be allocated, or their total
+ *              bytes do not fit in a long, raise Mem_Failed.
  *****************************************************************/
 extern T Bit2_new(int width, int height);
 
+/****************************************************************
+ * Bit2_new_aligned
+ * Description: Same as Bit2_new, but the bit array and its words are
+ *              one allocation, and the first word is aligned
+ * Inputs: 1) Integer width and height of the bit array
+ *         2) Alignment in bytes, a power of two at least the size of
+ *            a word, such as Bit2_CACHE_LINE
+ * Expectation: Width and height must not be negative and the
+ *              alignment must be a power of two, or exit with assert.
+ * Output: Bit2_T type array. Every row starts on a boundary of the
+ *         alignment or 64 bytes, whichever is smaller. With
+ *         Bit2_HUGE_PAGE (or any multiple of it) the words are also
+ *         marked for transparent huge pages where the system has
+ *         them.
+ * Expectation: If the block cannot be allocated, raise Mem_Failed.
+ *****************************************************************/
+extern T Bit2_new_aligned(int width, int height, size_t alignment);
+
+/****************************************************************
+ * Bit2_new_arena
+ * Description: Same as Bit2_new, but the bit array and its words are
+ *              allocated from a Hanson arena
+ * Inputs: 1) Arena_T to allocate from
+ *         2) Integer width and height of the bit array
+ * Expectation: Same as Bit2_new, and the arena must not be null.
+ * Output: Bit2_T type array, released with everything else in the
+ *         arena by Arena_free or Arena_dispose. Bit2_free may be
+ *         called on it but frees nothing.
+ * Expectation: If the arena cannot grow, raise Arena_Failed.
+ *****************************************************************/
+extern T Bit2_new_arena(Arena_T arena, int width, int height);
+
+/****************************************************************
+ * Bit2_wrap
+ * Description: Create a 2D bit array over words owned by the
+ *              caller, without copying them. Bit k of the words is
+ *              bit k % 64 of word k / 64, and bit [i, j] of the
+ *              array is bit j * stride + i.
+ * Inputs: 1) Pointer to the caller's words
+ *         2) Integer value of width of the bit array
+ *         3) Integer value of height of the bit array
+ *         4) Integer value of stride, the number of bits from the
+ *            start of one row to the start of the next
+ * Expectation: Width and height must not be negative and stride at
+ *              least width. The words must hold height rows and
+ *              outlive the bit array.
+ * Output: Bit2_T type array that reads and writes the words
+ * Expectation: If a parameter is out of range, exit with assert.
+ *              Bit2_free frees the bit array but not the words.
+ *****************************************************************/
+extern T Bit2_wrap(uint64_t *words, int width, int height, int stride);
+
+/****************************************************************
+ * Bit2_view
+ * Description: Create a 2D bit array for a rectangle of another
+ *              bit array, without copying it
+ * Inputs: 1) Bit2_T type array being viewed
+ *         2) Integer value i, column of the rectangle's left side
+ *         3) Integer value j, row of the rectangle's top side
+ *         4) Integer value of width of the rectangle
+ *         5) Integer value of height of the rectangle
+ * Expectation: Parameter bit array must not be null and the
+ *              rectangle must be inside it. The bit array must
+ *              outlive the view.
+ * Output: Bit2_T type array whose bit [0, 0] is bit [i, j] of the
+ *         bit array being viewed
+ * Expectation: If the bit array is null or the rectangle is not
+ *              inside it, exit with assert.
+ *              Writes through the view change the viewed bit array.
+ *              Bit2_free frees the view but not the bit array.
+ *****************************************************************/
+extern T Bit2_view(T bit2, int i, int j, int width, int height);
+
 /******************************************************************
  * Bit2_width
  * Description: Get width value of bit array which is the
@@ -143,6 +246,158 @@ extern void Bit2_map_col_major(T bit2, void apply(int i, int j, T bit2,
 extern void Bit2_map_row_major(T bit2, void apply(int i, int j, T bit2, 
                         int value, void *cl), void *cl);
 
+/******************************************************************
+ * Bit2_map_row_major_until, Bit2_map_col_major_until
+ * Description: Same as Bit2_map_row_major and Bit2_map_col_major,
+ *              except that apply returns nonzero to stop the
+ *              traversal there
+ * Inputs: 1) Bit2_T type bit array
+ *         2) An int apply function with the same parameters as for
+ *            the maps, returning 0 to go on or nonzero to stop
+ *         3) A void pointer closure
+ *         4) Integer pointers stop_i and stop_j, which may be null
+ * Expectation: Parameter bit array and apply must not be null.
+ * Output: 1 if apply stopped the traversal, with the column and row
+ *         where it stopped stored in stop_i and stop_j, and 0 if
+ *         every bit was visited, with stop_i and stop_j left alone.
+ * Expectation: If the parameter array or apply function is null,
+ *              exit with assert.
+ ******************************************************************/
+extern int Bit2_map_row_major_until(T bit2, int apply(int i, int j, T bit2,
+                                    int value, void *cl), void *cl,
+                                    int *stop_i, int *stop_j);
+extern int Bit2_map_col_major_until(T bit2, int apply(int i, int j, T bit2,
+                                    int value, void *cl), void *cl,
+                                    int *stop_i, int *stop_j);
+
+/******************************************************************
+ * Bit2_orient
+ * Description: Make a transposed, rotated or flipped copy of a bit
+ *              array
+ * Inputs: 1) Bit2_T type bit array
+ *         2) Bit2_orientation saying how to turn it
+ * Expectation: Parameter bit array must not be null.
+ * Output: New Bit2_T type bit array. It is height by width for a
+ *         transpose or a 90 or 270 degree rotation, and width by
+ *         height otherwise.
+ * Expectation: If the parameter array is null, exit with assert.
+ *              Bits are moved 64 at a time; turns that swap rows
+ *              and columns go through 64 x 64 blocks.
+ ******************************************************************/
+extern T Bit2_orient(T bit2, Bit2_orientation how);
+
+/******************************************************************
+ * Bit2_orient_into
+ * Description: Same as Bit2_orient, but writes into an existing bit
+ *              array, which may be a view or a wrap
+ * Inputs: 1) Bit2_T type bit array to write
+ *         2) Bit2_T type bit array to read
+ *         3) Bit2_orientation saying how to turn it
+ * Expectation: Neither bit array may be null, and the destination
+ *              must have the width and height of the result. The two
+ *              must not overlap.
+ * Output: Void
+ * Expectation: If an expectation is not met, exit with assert.
+ ******************************************************************/
+extern void Bit2_orient_into(T dest, T source, Bit2_orientation how);
+
+/******************************************************************
+ * Bit2_fill
+ * Description: Set every bit of a rectangle to one value
+ * Inputs: 1) Bit2_T type bit array
+ *         2) Integer column i and row j of the rectangle's corner
+ *         3) Integer width and height of the rectangle
+ *         4) Integer value, 0 or 1
+ * Expectation: Parameter bit array must not be null, the rectangle
+ *              must be inside it, and value must be 0 or 1.
+ * Output: Void
+ * Expectation: If an expectation is not met, exit with assert.
+ *              Whole words are set at once, and the words at the
+ *              ends of each row are masked.
+ ******************************************************************/
+extern void Bit2_fill(T bit2, int i, int j, int width, int height,
+                      int value);
+
+/******************************************************************
+ * Bit2_copy
+ * Description: Copy a rectangle of one bit array into another
+ * Inputs: 1) Bit2_T type bit array to write, and column i and row j
+ *            of the corner to write at
+ *         2) Bit2_T type bit array to read, and column and row of
+ *            the corner to read from
+ *         3) Integer width and height of the rectangle
+ * Expectation: Neither bit array may be null, both rectangles must
+ *              be inside their bit arrays, and the rectangles must
+ *              not overlap.
+ * Output: Void
+ * Expectation: If an expectation is not met, exit with assert.
+ *              Bits are moved 64 at a time whatever their offsets.
+ ******************************************************************/
+extern void Bit2_copy(T dest, int i, int j, T source, int source_i,
+                      int source_j, int width, int height);
+
+/******************************************************************
+ * Bit2_clone
+ * Description: Make a copy of a whole bit array
+ * Inputs: Bit2_T type bit array, which may be a view
+ * Expectation: Parameter bit array must not be null.
+ * Output: New Bit2_T type bit array with the same width, height and
+ *         bits, which owns its words
+ * Expectation: If the parameter bit array is null, exit with assert.
+ ******************************************************************/
+extern T Bit2_clone(T bit2);
+
+/******************************************************************
+ * Bit2_summarize
+ * Description: Give a bit array an occupancy summary, or rebuild
+ *              the one it has
+ * Inputs: Bit2_T type bit array
+ * Expectation: Parameter bit array must not be null.
+ * Output: Void. The summary is a pyramid of bits: one per word of the
+ *         bit array, set if the word is not all 0, then one per 64
+ *         of those, and so on up to a single word, about 1/63 of the
+ *         size of the bit array. Bit2_next_set and Bit2_map_ones use
+ *         it to pass 64, 4096, ... words of 0 bits in one step.
+ * Expectation: Bit2_put, Bit2_put_fast, Bit2_fill, Bit2_copy and
+ *              Bit2_orient_into keep the summary up to date, as do
+ *              writes through views made after this call, which
+ *              share it. Writes through views made before it, or
+ *              to wrapped words behind the bit array's back, need
+ *              another call. So do writes through the array a view
+ *              views, if the summary was made on the view: it is
+ *              the view's own, covering the array's words up to the
+ *              view's last, and the array does not know of it.
+ *              Bit2_free frees the summary.
+ ******************************************************************/
+extern void Bit2_summarize(T bit2);
+
+/******************************************************************
+ * Bit2_next_set
+ * Description: Find the next 1 bit in row-major order
+ * Inputs: 1) Bit2_T type bit array
+ *         2) Integer pointers to a column and row to start at
+ * Expectation: Neither the bit array nor the pointers may be null,
+ *              and the start must be inside the bit array or one
+ *              past its last row at column 0, or exit with assert.
+ * Output: 1 with *i and *j set to the first 1 bit at or after the
+ *         start, or 0 if there is none
+ * Expectation: Without a summary, runs of 0 bits are passed a word
+ *              at a time.
+ ******************************************************************/
+extern int Bit2_next_set(T bit2, int *i, int *j);
+
+/******************************************************************
+ * Bit2_map_ones
+ * Description: Same as Bit2_map_row_major, but only for the 1 bits
+ * Inputs: Same as Bit2_map_row_major; value is always 1
+ * Expectation: Same as Bit2_map_row_major.
+ * Output: Void
+ * Expectation: Bits are found with Bit2_next_set, so a mostly white
+ *              bit array costs little more than its 1 bits.
+ ******************************************************************/
+extern void Bit2_map_ones(T bit2, void apply(int i, int j, T bit2,
+                          int value, void *cl), void *cl);
+
 /******************************************************************
  * Bit2_free
  * Description: Deallocate memory used by bit array
@@ -0,0 +1,169 @@
+/*************************************************************************
+*                              bit2_atomic.h
+*
+*
+*      Authors: Jae Hyun Cheigh (jcheig01), Khanh Nguyen (cnguye10)
+*
+*      Fall 2020 - COMP40
+*      HW 2 - Part D
+*
+*
+*      Summary: This header defines atomic operations on the bits of a
+*               Bit2_T, for algorithms where several threads write one
+*               bit array. Bit2_put reads a word, changes one bit and
+*               writes the word back, so two threads putting bits of
+*               the same word can lose each other's writes; these
+*               functions change the word with one atomic instruction
+*               instead, and say whether the bit was already set, so
+*               a thread can claim a pixel in a parallel flood fill
+*               without a lock. Each takes the memory order it needs,
+*               relaxed for plain claiming or acquire/release to also
+*               order the thread's other reads and writes. They are
+*               static inline, built on the GCC __atomic builtins.
+*
+*               Plain Bit2_put, Bit2_fill and the like must not run
+*               on the same words at the same time as these.
+*
+**************************************************************************/
+
+#ifndef BIT2_ATOMIC_INCLUDED
+#define BIT2_ATOMIC_INCLUDED
+
+#include <stddef.h>
+#include <stdint.h>
+#include "bit2.h"
+#include "bit2_inline.h"
+#include "assert.h"
+
+#define T Bit2_T
+
+/* memory orders for the atomic operations, as in C11 */
+typedef enum {
+    Bit2_RELAXED = __ATOMIC_RELAXED,    /* only the bit itself */
+    Bit2_ACQUIRE = __ATOMIC_ACQUIRE,    /* later accesses stay after */
+    Bit2_RELEASE = __ATOMIC_RELEASE,    /* earlier accesses stay before */
+    Bit2_ACQ_REL = __ATOMIC_ACQ_REL,    /* both */
+    Bit2_SEQ_CST = __ATOMIC_SEQ_CST     /* and one order for all threads */
+} Bit2_order;
+
+/*
+ * set the summary bits over word w, which another thread may be
+ * setting too; defined in bit2.c
+ */
+extern void Bit2_summary_mark_atomic(Bit2_summary *summary, size_t w);
+
+/******************************************************************
+ * Bit2_get_atomic
+ * Description: Read bit [i, j] atomically
+ * Inputs: 1) Bit2_T type bit array
+ *         2) Integer column i and row j
+ *         3) Bit2_order: Bit2_RELAXED, Bit2_ACQUIRE or Bit2_SEQ_CST
+ * Expectation: Same bounds as Bit2_get, or exit with assert.
+ * Output: Integer value of the bit
+ ******************************************************************/
+static inline int Bit2_get_atomic(T bit2, int i, int j, Bit2_order order)
+{
+    assert(bit2 != NULL);
+    assert(i >= 0 && i < bit2->width && j >= 0 && j < bit2->height);
+    assert(order != Bit2_RELEASE && order != Bit2_ACQ_REL);
+
+    size_t index = bit2->base + j * bit2->stride + i;
+    uint64_t word = __atomic_load_n(&bit2->words[index / 64], order);
+
+    return (int) ((word >> (index % 64)) & 1);
+}
+
+/******************************************************************
+ * Bit2_test_and_set, Bit2_test_and_clear
+ * Description: Set or clear bit [i, j] atomically
+ * Inputs: 1) Bit2_T type bit array
+ *         2) Integer column i and row j
+ *         3) Bit2_order for the change
+ * Expectation: Same bounds as Bit2_put, or exit with assert.
+ * Output: Integer value of the bit just before the change, so of
+ *         several threads setting one bit, exactly one sees 0
+ * Implementation: One atomic or, or and, of the bit's word. A set
+ *                 that makes the word not zero also sets its summary
+ *                 bits, atomically; a clear leaves them, which the
+ *                 summary allows.
+ ******************************************************************/
+static inline int Bit2_test_and_set(T bit2, int i, int j, Bit2_order order)
+{
+    assert(bit2 != NULL);
+    assert(i >= 0 && i < bit2->width && j >= 0 && j < bit2->height);
+
+    size_t index = bit2->base + j * bit2->stride + i;
+    uint64_t bit = (uint64_t) 1 << (index % 64);
+    uint64_t old = __atomic_fetch_or(&bit2->words[index / 64], bit, order);
+
+    if (old == 0 && bit2->summary != NULL) {
+        Bit2_summary_mark_atomic(bit2->summary, index / 64);
+    }
+    return (old & bit) != 0;
+}
+
+static inline int Bit2_test_and_clear(T bit2, int i, int j,
+                                      Bit2_order order)
+{
+    assert(bit2 != NULL);
+    assert(i >= 0 && i < bit2->width && j >= 0 && j < bit2->height);
+
+    size_t index = bit2->base + j * bit2->stride + i;
+    uint64_t bit = (uint64_t) 1 << (index % 64);
+    uint64_t old = __atomic_fetch_and(&bit2->words[index / 64], ~bit,
+                                      order);
+
+    return (old & bit) != 0;
+}
+
+/******************************************************************
+ * Bit2_fetch_or
+ * Description: Or a run of up to 64 bits into one row atomically
+ * Inputs: 1) Bit2_T type bit array
+ *         2) Integer column i and row j of the first bit
+ *         3) Integer count of bits, 1 to 64, inside the row
+ *         4) The bits, bit 0 going to column i, zero above count
+ *         5) Bit2_order for the change
+ * Expectation: The run must be inside the row and the bits above
+ *              count zero, or exit with assert.
+ * Output: The run's bits just before the or, bit 0 being column i
+ * Implementation: The run is in one word or two. Each word is one
+ *                 atomic or, so a run over two words is two atomic
+ *                 changes, not one; a run starting at a multiple of
+ *                 64 bits from the base never is. Words made not
+ *                 zero get their summary bits set.
+ ******************************************************************/
+static inline uint64_t Bit2_fetch_or(T bit2, int i, int j, int count,
+                                     uint64_t bits, Bit2_order order)
+{
+    assert(bit2 != NULL);
+    assert(count >= 1 && count <= 64);
+    assert(i >= 0 && i <= bit2->width - count && j >= 0 &&
+           j < bit2->height);
+    assert(count == 64 || (bits >> count) == 0);
+
+    size_t index = bit2->base + j * bit2->stride + i;
+    uint64_t *word = &bit2->words[index / 64];
+    unsigned offset = index % 64;
+    uint64_t old = __atomic_fetch_or(&word[0], bits << offset, order);
+    uint64_t result = old >> offset;
+
+    if (old == 0 && (bits << offset) != 0 && bit2->summary != NULL) {
+        Bit2_summary_mark_atomic(bit2->summary, index / 64);
+    }
+    if (offset + count > 64) {
+        uint64_t high = bits >> (64 - offset);
+        uint64_t old_high = __atomic_fetch_or(&word[1], high, order);
+        result |= old_high << (64 - offset);
+        if (old_high == 0 && high != 0 && bit2->summary != NULL) {
+            Bit2_summary_mark_atomic(bit2->summary, index / 64 + 1);
+        }
+    }
+    if (count < 64) {
+        result &= ((uint64_t) 1 << count) - 1;
+    }
+    return result;
+}
+
+#undef T
+#endif
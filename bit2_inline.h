@@ -0,0 +1,161 @@
+/*************************************************************************
+*                              bit2_inline.h
+*
+*
+*      Authors: Jae Hyun Cheigh (jcheig01), Khanh Nguyen (cnguye10)
+*
+*      Fall 2020 - COMP40
+*      HW 2 - Part B
+*
+*
+*      Summary: This header shows the representation of Bit2_T so that
+*               hot loops such as the unblackedges search can use
+*               Bit2_get_fast and Bit2_put_fast, static inline copies
+*               of Bit2_get and Bit2_put that need no call per pixel,
+*               and Bit2_load_bits, which reads 64 of a row at once.
+*               Clients should use the accessors only and never the
+*               fields. Bounds are checked with CII assert, so the
+*               checks go away when compiled with -DNDEBUG
+*               (make RELEASE=1). A bit array with a summary (see
+*               Bit2_summarize) has it kept up to date by these puts.
+*
+**************************************************************************/
+
+#ifndef BIT2_INLINE_INCLUDED
+#define BIT2_INLINE_INCLUDED
+
+#include <stddef.h>
+#include <stdint.h>
+#include "bit2.h"
+#include "assert.h"
+
+#define T Bit2_T
+
+/* levels a summary may have; 64 to the 10 words is more than any array */
+#define BIT2_SUMMARY_LEVELS 11
+
+/*
+ * occupancy summary of the words of a bit array: bit w of level 0 is
+ * set when word w is not zero, and bit w of each level above is set
+ * when word w of the level below is not zero. The top level is one
+ * word. length[l] is the number of bits in level l. It belongs to the
+ * bit array owner, and views of that array made after it share it.
+ * The atomic clears in bit2_atomic.h leave summary bits alone, so a
+ * set bit may sit over a zero word, but never a clear bit over a word
+ * that is not zero.
+ */
+typedef struct Bit2_summary {
+    struct T *owner;
+    int levels;
+    size_t length[BIT2_SUMMARY_LEVELS];
+    uint64_t *level[BIT2_SUMMARY_LEVELS];
+} Bit2_summary;
+
+/*
+ * data that our bit array holds. Bit k is bit k % 64 of words[k / 64]
+ * and bit [i, j] is bit base + j * stride + i. The words are freed
+ * with the bit array only when owner is set; it is 2 when this header
+ * sits at the end of the words' block, and 3 when both came from an
+ * arena and are freed with it. summary is null unless Bit2_summarize
+ * made one.
+ */
+struct T {
+    int width;
+    int height;
+    uint64_t *words;
+    size_t base;
+    size_t stride;
+    int owner;
+    Bit2_summary *summary;
+};
+
+/*
+ * set or clear the summary bit of word w, and the bits above it that
+ * change with it; for the inlined puts, which call it only when a
+ * word goes from zero to not zero or back
+ */
+extern void Bit2_summary_note(Bit2_summary *summary, size_t w, int nonzero);
+
+/******************************************************************
+ * Bit2_get_fast
+ * Description: Same as Bit2_get, but inlined into the caller
+ * Inputs: 1) Bit2_T type bit array
+ *         2) Integer value i which is column index of bit array
+ *         3) Integer value j which is row index of bit array
+ * Output: Integer value of the bit at index [i, j]
+ * Implementation: Shift the word holding bit [i, j] down to it.
+ ******************************************************************/
+static inline int Bit2_get_fast(T bit2, int i, int j)
+{
+    assert(bit2 != NULL);
+    assert(i >= 0 && i < bit2->width && j >= 0 && j < bit2->height);
+
+    size_t index = bit2->base + j * bit2->stride + i;
+
+    return (int) ((bit2->words[index / 64] >> (index % 64)) & 1);
+}
+
+/******************************************************************
+ * Bit2_load_bits
+ * Description: Read a run of up to 64 bits from one row at once
+ * Inputs: 1) Bit2_T type bit array
+ *         2) Integer column i and row j of the first bit
+ *         3) Integer count of bits, 1 to 64, inside the row
+ * Output: The bits, bit 0 being column i and the rest zero
+ * Implementation: The run starts at some bit of one word and may
+ *                 end in the next.
+ ******************************************************************/
+static inline uint64_t Bit2_load_bits(T bit2, int i, int j, int count)
+{
+    assert(bit2 != NULL);
+    assert(count >= 1 && count <= 64);
+    assert(i >= 0 && i <= bit2->width - count && j >= 0 &&
+           j < bit2->height);
+
+    size_t index = bit2->base + j * bit2->stride + i;
+    const uint64_t *word = &bit2->words[index / 64];
+    unsigned offset = index % 64;
+    uint64_t bits = word[0] >> offset;
+
+    if (offset + count > 64) {
+        bits |= word[1] << (64 - offset);
+    }
+    if (count < 64) {
+        bits &= ((uint64_t) 1 << count) - 1;
+    }
+    return bits;
+}
+
+/******************************************************************
+ * Bit2_put_fast
+ * Description: Same as Bit2_put, but inlined into the caller
+ * Inputs: 1) Bit2_T type bit array
+ *         2) Integer value i which is column index of bit array
+ *         3) Integer value j which is row index of bit array
+ *         4) Integer value value, 0 or 1
+ * Output: Integer value of the bit before it was replaced
+ * Implementation: Clear the bit, then or in the new value, so there
+ *                 is no branch on the value. With a summary, tell it
+ *                 when the word has become zero or stopped being.
+ ******************************************************************/
+static inline int Bit2_put_fast(T bit2, int i, int j, int value)
+{
+    assert(bit2 != NULL);
+    assert(value == 0 || value == 1);
+    assert(i >= 0 && i < bit2->width && j >= 0 && j < bit2->height);
+
+    size_t index = bit2->base + j * bit2->stride + i;
+    uint64_t *word = &bit2->words[index / 64];
+    unsigned shift = index % 64;
+    uint64_t old = *word;
+    int previous = (int) ((old >> shift) & 1);
+
+    *word = (old & ~((uint64_t) 1 << shift)) | ((uint64_t) value << shift);
+    if (bit2->summary != NULL && (old == 0) != (*word == 0)) {
+        Bit2_summary_note(bit2->summary, index / 64, *word != 0);
+    }
+    return previous;
+}
+
+#undef T
+#endif
@@ -0,0 +1,365 @@
+/*************************************************************************
+*                              bit2rle.c
+*
+*
+*      Authors: Jae Hyun Cheigh (jcheig01), Khanh Nguyen (cnguye10)
+*
+*      Fall 2020 - COMP40
+*      HW 2 - Part D
+*
+*
+*      Summary: This file implements Bit2RLE_T, the run-length encoded
+*               2D bit array. The runs of all rows are kept together in
+*               two growing arrays of first columns and end columns,
+*               with one more array giving the number of the first run
+*               of each row, so the representation is the runs plus
+*               one word per row.
+*
+**************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "bit2rle.h"
+#include "bit2_inline.h"
+#include "assert.h"
+#include "mem.h"
+
+#define T Bit2RLE_T
+
+/*
+ * data that our run-length encoded bit array holds. Run k covers
+ * columns starts[k] to ends[k] - 1 of its row. Runs are added in
+ * row-major order; rows up to last_row have their first run in
+ * row_first, and rows after it have none yet.
+ */
+struct T {
+    int width;
+    int height;
+    int *starts;
+    int *ends;
+    size_t count;
+    size_t capacity;
+    size_t *row_first;
+    int last_row;
+};
+
+/* number of the first run of row j, whether or not rows are done */
+static size_t first_run(T bit2rle, int j);
+
+/****************************************************************
+ * Bit2RLE_new
+ * Description: Create a new run-length encoded bit array
+ * Inputs: Integer width and height
+ * Output: Bit2RLE_T type array with no runs
+ * Implementation: Start with room for one run per row, which the
+ *                 run arrays double from as they fill.
+ *****************************************************************/
+T Bit2RLE_new(int width, int height)
+{
+    assert(width >= 0 && height >= 0);
+
+    T bit2rle;
+    NEW(bit2rle);
+
+    bit2rle->width = width;
+    bit2rle->height = height;
+    bit2rle->count = 0;
+    bit2rle->capacity = height > 0 ? height : 1;
+    bit2rle->starts = ALLOC((long) (bit2rle->capacity * sizeof(int)));
+    bit2rle->ends = ALLOC((long) (bit2rle->capacity * sizeof(int)));
+    bit2rle->row_first = CALLOC((long) height + 1, sizeof(size_t));
+    bit2rle->last_row = -1;
+
+    return bit2rle;
+}
+
+/****************************************************************
+ * Bit2RLE_add_run
+ * Description: Add a run of 1 bits
+ * Inputs: 1) Bit2RLE_T type bit array
+ *         2) Integer row, first column and column after the last
+ * Output: Void
+ * Implementation: Rows skipped since the last run start where the
+ *                 runs end now. A run touching the last one in the
+ *                 same row extends it.
+ *****************************************************************/
+void Bit2RLE_add_run(T bit2rle, int j, int start, int end)
+{
+    assert(bit2rle != NULL);
+    assert(j >= 0 && j < bit2rle->height);
+    assert(start >= 0 && start < end && end <= bit2rle->width);
+    assert(j >= bit2rle->last_row);
+
+    if (j == bit2rle->last_row && bit2rle->count > first_run(bit2rle, j)) {
+        size_t last = bit2rle->count - 1;
+        assert(start >= bit2rle->ends[last]);
+        if (start == bit2rle->ends[last]) {
+            bit2rle->ends[last] = end;
+            return;
+        }
+    }
+    while (bit2rle->last_row < j) {
+        bit2rle->row_first[++bit2rle->last_row] = bit2rle->count;
+    }
+    if (bit2rle->count == bit2rle->capacity) {
+        bit2rle->capacity *= 2;
+        RESIZE(bit2rle->starts, (long) (bit2rle->capacity * sizeof(int)));
+        RESIZE(bit2rle->ends, (long) (bit2rle->capacity * sizeof(int)));
+    }
+    bit2rle->starts[bit2rle->count] = start;
+    bit2rle->ends[bit2rle->count] = end;
+    bit2rle->count++;
+}
+
+/****************************************************************
+ * Bit2RLE_from_bit2
+ * Description: Encode a dense bit array
+ * Inputs: Bit2_T type bit array
+ * Output: New Bit2RLE_T type array
+ * Implementation: Scan each row for the columns where the bits
+ *                 change, adding a run at every change back to 0.
+ *****************************************************************/
+T Bit2RLE_from_bit2(Bit2_T bit2)
+{
+    assert(bit2 != NULL);
+
+    int width = Bit2_width(bit2);
+    int height = Bit2_height(bit2);
+    T bit2rle = Bit2RLE_new(width, height);
+
+    for (int j = 0; j < height; j++) {
+        int start = -1;
+        for (int i = 0; i < width; i++) {
+            int bit = Bit2_get_fast(bit2, i, j);
+            if (bit && start < 0) {
+                start = i;
+            }
+            else if (!bit && start >= 0) {
+                Bit2RLE_add_run(bit2rle, j, start, i);
+                start = -1;
+            }
+        }
+        if (start >= 0) {
+            Bit2RLE_add_run(bit2rle, j, start, width);
+        }
+    }
+    return bit2rle;
+}
+
+/****************************************************************
+ * Bit2RLE_to_bit2
+ * Description: Decode into a dense bit array
+ * Inputs: 1) Bit2_T type bit array to write
+ *         2) Bit2RLE_T type bit array to read
+ * Output: Void
+ * Implementation: Clear the dense array, then fill each run, which
+ *                 Bit2_fill does a word at a time.
+ *****************************************************************/
+void Bit2RLE_to_bit2(Bit2_T dest, T source)
+{
+    assert(dest != NULL && source != NULL);
+    assert(Bit2_width(dest) == source->width &&
+           Bit2_height(dest) == source->height);
+
+    Bit2_fill(dest, 0, 0, source->width, source->height, 0);
+    for (int j = 0; j < source->height; j++) {
+        size_t end = first_run(source, j + 1);
+        for (size_t run = first_run(source, j); run < end; run++) {
+            Bit2_fill(dest, source->starts[run], j,
+                      source->ends[run] - source->starts[run], 1, 1);
+        }
+    }
+}
+
+/******************************************************************
+ * Bit2RLE_width, Bit2RLE_height, Bit2RLE_run_count
+ * Description: Get the number of columns, rows, or runs
+ * Inputs: Bit2RLE_T type bit array
+ * Output: The count
+ ******************************************************************/
+int Bit2RLE_width(T bit2rle)
+{
+    assert(bit2rle != NULL);
+    return bit2rle->width;
+}
+
+int Bit2RLE_height(T bit2rle)
+{
+    assert(bit2rle != NULL);
+    return bit2rle->height;
+}
+
+size_t Bit2RLE_run_count(T bit2rle)
+{
+    assert(bit2rle != NULL);
+    return bit2rle->count;
+}
+
+/******************************************************************
+ * Bit2RLE_get
+ * Description: Get the value of bit [i, j]
+ * Inputs: Bit2RLE_T type bit array, integer column i and row j
+ * Output: Integer value of the bit
+ * Implementation: Binary search for the last run of the row that
+ *                 starts at or before i; the bit is 1 if that run
+ *                 has not ended by i.
+ ******************************************************************/
+int Bit2RLE_get(T bit2rle, int i, int j)
+{
+    assert(bit2rle != NULL);
+    assert(i >= 0 && i < bit2rle->width && j >= 0 && j < bit2rle->height);
+
+    size_t low = first_run(bit2rle, j);
+    size_t high = first_run(bit2rle, j + 1);
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (bit2rle->starts[middle] <= i) {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+    return low > first_run(bit2rle, j) && i < bit2rle->ends[low - 1];
+}
+
+/******************************************************************
+ * Bit2RLE_row_first
+ * Description: Get the number of the first run of a row
+ * Inputs: Bit2RLE_T type bit array, integer row from 0 to height
+ * Output: Run number
+ ******************************************************************/
+size_t Bit2RLE_row_first(T bit2rle, int j)
+{
+    assert(bit2rle != NULL);
+    assert(j >= 0 && j <= bit2rle->height);
+    return first_run(bit2rle, j);
+}
+
+/******************************************************************
+ * Bit2RLE_run
+ * Description: Read a run by number
+ * Inputs: Bit2RLE_T type bit array, run number, pointers for the
+ *         first column and the column after the last
+ * Output: Void
+ ******************************************************************/
+void Bit2RLE_run(T bit2rle, size_t run, int *start, int *end)
+{
+    assert(bit2rle != NULL && start != NULL && end != NULL);
+    assert(run < bit2rle->count);
+
+    *start = bit2rle->starts[run];
+    *end = bit2rle->ends[run];
+}
+
+/******************************************************************
+ * Bit2RLE_remove_runs
+ * Description: Clear the marked runs
+ * Inputs: Bit2RLE_T type bit array, one flag per run
+ * Output: Void
+ * Implementation: Slide the kept runs down in one pass, moving each
+ *                 row's first run number down by the runs removed
+ *                 before it.
+ ******************************************************************/
+void Bit2RLE_remove_runs(T bit2rle, const unsigned char *remove)
+{
+    assert(bit2rle != NULL && remove != NULL);
+
+    size_t kept = 0;
+    int row = 0;
+    for (size_t run = 0; run < bit2rle->count; run++) {
+        while (row <= bit2rle->last_row && bit2rle->row_first[row] == run) {
+            bit2rle->row_first[row++] = kept;
+        }
+        if (!remove[run]) {
+            bit2rle->starts[kept] = bit2rle->starts[run];
+            bit2rle->ends[kept] = bit2rle->ends[run];
+            kept++;
+        }
+    }
+    while (row <= bit2rle->last_row) {
+        bit2rle->row_first[row++] = kept;
+    }
+    bit2rle->count = kept;
+}
+
+/******************************************************************
+ * Bit2RLE_map_row_major
+ * Description: Apply a function to every bit, row by row
+ * Inputs: The bit array, the apply function and a closure
+ * Output: Void
+ * Implementation: Within a row, give 0 up to the next run, 1 along
+ *                 it, and 0 after the last run.
+ ******************************************************************/
+void Bit2RLE_map_row_major(T bit2rle, void apply(int i, int j,
+                           T bit2rle, int value, void *cl), void *cl)
+{
+    assert(bit2rle != NULL);
+    assert(apply != NULL);
+
+    for (int j = 0; j < bit2rle->height; j++) {
+        size_t end = first_run(bit2rle, j + 1);
+        int i = 0;
+        for (size_t run = first_run(bit2rle, j); run < end; run++) {
+            for (; i < bit2rle->starts[run]; i++) {
+                apply(i, j, bit2rle, 0, cl);
+            }
+            for (; i < bit2rle->ends[run]; i++) {
+                apply(i, j, bit2rle, 1, cl);
+            }
+        }
+        for (; i < bit2rle->width; i++) {
+            apply(i, j, bit2rle, 0, cl);
+        }
+    }
+}
+
+/******************************************************************
+ * Bit2RLE_map_runs
+ * Description: Apply a function to every run
+ * Inputs: The bit array, the apply function and a closure
+ * Output: Void
+ ******************************************************************/
+void Bit2RLE_map_runs(T bit2rle, void apply(int j, int start, int end,
+                      T bit2rle, void *cl), void *cl)
+{
+    assert(bit2rle != NULL);
+    assert(apply != NULL);
+
+    for (int j = 0; j < bit2rle->height; j++) {
+        size_t end = first_run(bit2rle, j + 1);
+        for (size_t run = first_run(bit2rle, j); run < end; run++) {
+            apply(j, bit2rle->starts[run], bit2rle->ends[run], bit2rle, cl);
+        }
+    }
+}
+
+/******************************************************************
+ * Bit2RLE_free
+ * Description: Free a run-length encoded bit array
+ * Inputs: Pointer to a Bit2RLE_T
+ * Output: Void
+ ******************************************************************/
+void Bit2RLE_free(T *bit2rle)
+{
+    assert(bit2rle != NULL && *bit2rle != NULL);
+
+    FREE((*bit2rle)->starts);
+    FREE((*bit2rle)->ends);
+    FREE((*bit2rle)->row_first);
+    FREE(*bit2rle);
+}
+
+/******************************************************************
+ * first_run
+ * Description: Number of the first run of row j
+ * Inputs: Bit2RLE_T type bit array, integer row from 0 to height
+ * Output: Run number
+ * Implementation: Rows after the last one given a run have none,
+ *                 so their runs start after all the others.
+ ******************************************************************/
+static size_t first_run(T bit2rle, int j)
+{
+    return j <= bit2rle->last_row ? bit2rle->row_first[j] : bit2rle->count;
+}
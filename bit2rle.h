@@ -0,0 +1,165 @@
+/*************************************************************************
+*                              bit2rle.h
+*
+*
+*      Authors: Jae Hyun Cheigh (jcheig01), Khanh Nguyen (cnguye10)
+*
+*      Fall 2020 - COMP40
+*      HW 2 - Part D
+*
+*
+*      Summary: This is the header file for Bit2RLE_T, a 2D bit array
+*               kept as runs of 1 bits, row by row. A scanned page is
+*               mostly long white runs with a few short black ones, so
+*               the runs take a small fraction of width * height bits,
+*               and passes over rows cost per run instead of per bit.
+*               A Bit2RLE_T is built a run at a time in row order (or
+*               converted from a Bit2_T), read through get and the
+*               maps, and edited by removing whole runs. Runs are
+*               numbered in row-major order, so the runs of row j are
+*               numbers Bit2RLE_row_first(j) up to, but not including,
+*               Bit2RLE_row_first(j + 1).
+*
+**************************************************************************/
+
+#ifndef BIT2RLE_INCLUDED
+#define BIT2RLE_INCLUDED
+
+#include <stddef.h>
+#include "bit2.h"
+
+#define T Bit2RLE_T
+typedef struct T *T;
+
+/****************************************************************
+ * Bit2RLE_new
+ * Description: Create a new run-length encoded bit array with every
+ *              bit 0, ready for Bit2RLE_add_run
+ * Inputs: Integer width and height of the bit array
+ * Expectation: Width and height must not be negative, or exit with
+ *              assert.
+ * Output: Bit2RLE_T type array, freed with Bit2RLE_free
+ *****************************************************************/
+extern T Bit2RLE_new(int width, int height);
+
+
+/****************************************************************
+ * Bit2RLE_add_run
+ * Description: Set bits start to end - 1 of row j to 1
+ * Inputs: 1) Bit2RLE_T type bit array
+ *         2) Integer row j
+ *         3) Integer first column of the run and the column after
+ *            its last
+ * Expectation: Runs must be added in row-major order: j must not be
+ *              less than the row of the last run, and in the same
+ *              row start must not be less than the last run's end.
+ *              The run must be inside the array and not empty. If
+ *              not, exit with assert.
+ * Output: Void. A run that starts where the last one ended is
+ *         merged with it.
+ *****************************************************************/
+extern void Bit2RLE_add_run(T bit2rle, int j, int start, int end);
+
+
+/****************************************************************
+ * Bit2RLE_from_bit2, Bit2RLE_to_bit2
+ * Description: Convert from and to a dense Bit2_T
+ * Inputs: Bit2RLE_from_bit2: Bit2_T type bit array, may be a view
+ *         Bit2RLE_to_bit2: Bit2_T to write, which must have the
+ *         same width and height, and the Bit2RLE_T to read
+ * Expectation: No array may be null, or exit with assert.
+ * Output: A new Bit2RLE_T with the same bits, or void
+ *****************************************************************/
+extern T Bit2RLE_from_bit2(Bit2_T bit2);
+extern void Bit2RLE_to_bit2(Bit2_T dest, T source);
+
+
+/****************************************************************
+ * Bit2RLE_width, Bit2RLE_height, Bit2RLE_run_count
+ * Description: Get the number of columns, rows, or runs
+ * Inputs: Bit2RLE_T type bit array, not null
+ * Output: The count
+ *****************************************************************/
+extern int Bit2RLE_width(T bit2rle);
+extern int Bit2RLE_height(T bit2rle);
+extern size_t Bit2RLE_run_count(T bit2rle);
+
+
+/****************************************************************
+ * Bit2RLE_get
+ * Description: Get the value of bit [i, j]
+ * Inputs: Bit2RLE_T type bit array, integer column i and row j
+ * Expectation: The indices must be inside the array, or exit with
+ *              assert.
+ * Output: Integer 1 if a run covers the bit, 0 if not
+ * Implementation note: binary search of row j's runs
+ *****************************************************************/
+extern int Bit2RLE_get(T bit2rle, int i, int j);
+
+
+/****************************************************************
+ * Bit2RLE_row_first, Bit2RLE_run
+ * Description: Find and read runs by number
+ * Inputs: Bit2RLE_row_first: the array and an integer row j from 0
+ *         to height, height giving the number of runs
+ *         Bit2RLE_run: the array, a run number, and pointers for
+ *         the run's first column and the column after its last
+ * Expectation: Row and run must be in range, or exit with assert.
+ * Output: Number of the first run of row j (or of the first run
+ *         after it, if row j has none), or void
+ *****************************************************************/
+extern size_t Bit2RLE_row_first(T bit2rle, int j);
+extern void Bit2RLE_run(T bit2rle, size_t run, int *start, int *end);
+
+
+/****************************************************************
+ * Bit2RLE_remove_runs
+ * Description: Clear every run that is marked
+ * Inputs: 1) Bit2RLE_T type bit array
+ *         2) Array of one flag per run, nonzero to remove the run
+ * Expectation: Neither may be null, or exit with assert.
+ * Output: Void. The remaining runs are renumbered in order.
+ *****************************************************************/
+extern void Bit2RLE_remove_runs(T bit2rle, const unsigned char *remove);
+
+
+/****************************************************************
+ * Bit2RLE_map_row_major
+ * Description: Same as Bit2_map_row_major
+ * Inputs: The bit array, an apply function getting the column, row,
+ *         array, bit value and closure, and a void pointer closure
+ * Expectation: Array and apply must not be null, or exit with assert.
+ * Output: Void
+ * Implementation note: the values come from walking the runs, so no
+ *                      bit is looked up.
+ *****************************************************************/
+extern void Bit2RLE_map_row_major(T bit2rle, void apply(int i, int j,
+                                  T bit2rle, int value, void *cl),
+                                  void *cl);
+
+
+/****************************************************************
+ * Bit2RLE_map_runs
+ * Description: Apply a function to every run, in row-major order
+ * Inputs: The bit array, an apply function getting the row, the
+ *         run's first column and the column after its last, the
+ *         array and closure, and a void pointer closure
+ * Expectation: Array and apply must not be null, or exit with assert.
+ * Output: Void
+ *****************************************************************/
+extern void Bit2RLE_map_runs(T bit2rle, void apply(int j, int start,
+                             int end, T bit2rle, void *cl), void *cl);
+
+
+/****************************************************************
+ * Bit2RLE_free
+ * Description: Free a run-length encoded bit array
+ * Inputs: Pointer to a Bit2RLE_T, set to NULL afterwards
+ * Expectation: Neither the pointer nor the array may be null, or
+ *              exit with assert.
+ * Output: Void
+ *****************************************************************/
+extern void Bit2RLE_free(T *bit2rle);
+
+#undef T
+#endif
@@ -0,0 +1,248 @@
+/*************************************************************************
+*                              bit2sum.c
+*
+*
+*      Authors: Jae Hyun Cheigh (jcheig01), Khanh Nguyen (cnguye10)
+*
+*      Fall 2020 - COMP40
+*      HW 2 - Part D
+*
+*
+*      Summary: This file implements Bit2Sum_T, the summed-area table of
+*               a bit array. Entry [i, j] of the table is the number of
+*               1 bits in columns before i and rows before j, so the
+*               table has one more row and column than the bit array,
+*               and a rectangle's count is four entries added and
+*               subtracted. Entries are 32 bits and wrap past 2^32;
+*               the four-entry sum is still exact for any rectangle of
+*               fewer than 2^32 bits, and bigger rectangles are counted
+*               in pieces.
+*
+**************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <limits.h>
+#include "bit2sum.h"
+#include "bit2_inline.h"
+#include "assert.h"
+#include "mem.h"
+
+#define T Bit2Sum_T
+
+/* data that our summed-area table holds; entry [i, j] is at
+   counts[j * stride + i], and stride is width + 1 */
+struct T {
+    int width;
+    int height;
+    size_t stride;
+    uint32_t *counts;
+};
+
+/* fill table row j + 1 from row j of the bit array and table row j */
+static void build_row(T sum, Bit2_T bit2, int j);
+
+/****************************************************************
+ * Bit2Sum_new
+ * Description: Build the summed-area table of a bit array
+ * Inputs: Bit2_T type bit array
+ * Output: New Bit2Sum_T
+ * Implementation: Table row 0 and column 0 are zero; each later row
+ *                 is built from the row above it.
+ *****************************************************************/
+T Bit2Sum_new(Bit2_T bit2)
+{
+    assert(bit2 != NULL);
+
+    int width = Bit2_width(bit2);
+    int height = Bit2_height(bit2);
+    size_t stride = (size_t) width + 1;
+
+    /* Mem_alloc takes a long; raise Mem_Failed rather than wrap */
+    size_t rows = (size_t) height + 1;
+    if (stride > (size_t) LONG_MAX / sizeof(uint32_t) / rows) {
+        RAISE(Mem_Failed);
+    }
+
+    T sum;
+    NEW(sum);
+    sum->width = width;
+    sum->height = height;
+    sum->stride = stride;
+    sum->counts = ALLOC((long) (stride * rows * sizeof(uint32_t)));
+
+    for (size_t i = 0; i < stride; i++) {
+        sum->counts[i] = 0;
+    }
+    for (int j = 0; j < height; j++) {
+        build_row(sum, bit2, j);
+    }
+    return sum;
+}
+
+/****************************************************************
+ * Bit2Sum_update
+ * Description: Bring the table up to date after a band is edited
+ * Inputs: 1) Bit2Sum_T type table
+ *         2) The edited bit array
+ *         3) Integer first row and number of rows of the band
+ * Output: Void
+ * Implementation: Keep the old table row at the bottom of the band,
+ *                 rebuild the band's rows, and add the difference
+ *                 between the new and old bottom rows to every row
+ *                 below, since each of those counts the band too.
+ *                 Differences are taken modulo 2^32, as the entries
+ *                 are.
+ *****************************************************************/
+void Bit2Sum_update(T sum, Bit2_T bit2, int first_row, int rows)
+{
+    assert(sum != NULL && bit2 != NULL);
+    assert(Bit2_width(bit2) == sum->width &&
+           Bit2_height(bit2) == sum->height);
+    assert(first_row >= 0 && rows >= 0 && first_row <= sum->height - rows);
+
+    if (rows == 0) {
+        return;
+    }
+
+    int end_row = first_row + rows;
+    size_t stride = sum->stride;
+    uint32_t *bottom = &sum->counts[end_row * stride];
+    uint32_t *before = ALLOC((long) (stride * sizeof(uint32_t)));
+
+    for (size_t i = 0; i < stride; i++) {
+        before[i] = bottom[i];
+    }
+    for (int j = first_row; j < end_row; j++) {
+        build_row(sum, bit2, j);
+    }
+
+    int changed = 0;
+    for (size_t i = 0; i < stride; i++) {
+        before[i] = bottom[i] - before[i];
+        changed |= before[i] != 0;
+    }
+    if (changed) {
+        for (int j = end_row + 1; j <= sum->height; j++) {
+            uint32_t *row = &sum->counts[j * stride];
+            for (size_t i = 0; i < stride; i++) {
+                row[i] += before[i];
+            }
+        }
+    }
+    FREE(before);
+}
+
+/****************************************************************
+ * Bit2Sum_count
+ * Description: Count the 1 bits in a rectangle
+ * Inputs: Bit2Sum_T type table, and the rectangle's column, row,
+ *         width and height
+ * Output: Number of 1 bits
+ * Implementation: The corner below and right of the rectangle,
+ *                 minus the corners beside it, plus the one the
+ *                 two subtractions both took off. A rectangle of
+ *                 2^32 bits or more is split into top and bottom
+ *                 halves, so each four-entry sum is exact.
+ *****************************************************************/
+uint64_t Bit2Sum_count(T sum, int i, int j, int width, int height)
+{
+    assert(sum != NULL);
+    assert(i >= 0 && j >= 0 && width >= 0 && height >= 0);
+    assert(i <= sum->width - width && j <= sum->height - height);
+
+    if ((uint64_t) width * height > UINT32_MAX) {
+        int half = height / 2;
+        return Bit2Sum_count(sum, i, j, width, half) +
+               Bit2Sum_count(sum, i, j + half, width, height - half);
+    }
+
+    const uint32_t *top = &sum->counts[j * sum->stride];
+    const uint32_t *bottom = &sum->counts[(j + height) * sum->stride];
+
+    return (uint32_t) (bottom[i + width] - bottom[i] - top[i + width] +
+                       top[i]);
+}
+
+/******************************************************************
+ * Bit2Sum_width, Bit2Sum_height
+ * Description: Get the size of the bit array
+ * Inputs: Bit2Sum_T type table
+ * Output: Integer width or height
+ ******************************************************************/
+int Bit2Sum_width(T sum)
+{
+    assert(sum != NULL);
+    return sum->width;
+}
+
+int Bit2Sum_height(T sum)
+{
+    assert(sum != NULL);
+    return sum->height;
+}
+
+/******************************************************************
+ * Bit2Sum_free
+ * Description: Free a summed-area table
+ * Inputs: Pointer to a Bit2Sum_T
+ * Output: Void
+ ******************************************************************/
+void Bit2Sum_free(T *sum)
+{
+    assert(sum != NULL && *sum != NULL);
+
+    FREE((*sum)->counts);
+    FREE(*sum);
+}
+
+/******************************************************************
+ * build_row
+ * Description: Fill one row of the table
+ * Inputs: 1) Bit2Sum_T type table, whose row j is up to date
+ *         2) The bit array
+ *         3) Integer row j of the bit array
+ * Output: Void
+ * Implementation: Entry [i + 1, j + 1] is entry [i + 1, j] plus
+ *                 the 1 bits of row j up to column i. Take the row
+ *                 64 bits at a time, keeping the count before the
+ *                 word: a word of all 0 bits adds that count to each
+ *                 entry, and a word of all 1 bits one more at each
+ *                 column, so only mixed words go bit by bit. Each
+ *                 word's popcount moves the count on.
+ ******************************************************************/
+static void build_row(T sum, Bit2_T bit2, int j)
+{
+    const uint32_t *above = &sum->counts[j * sum->stride + 1];
+    uint32_t *row = &sum->counts[(j + 1) * sum->stride];
+    uint32_t before = 0;
+
+    row[0] = 0;
+    row++;
+    for (int col = 0; col < sum->width; col += 64) {
+        int count = sum->width - col < 64 ? sum->width - col : 64;
+        uint64_t bits = Bit2_load_bits(bit2, col, j, count);
+        uint64_t all = count < 64 ? ((uint64_t) 1 << count) - 1
+                                  : ~(uint64_t) 0;
+
+        if (bits == 0) {
+            for (int t = 0; t < count; t++) {
+                row[col + t] = above[col + t] + before;
+            }
+        }
+        else if (bits == all) {
+            for (int t = 0; t < count; t++) {
+                row[col + t] = above[col + t] + before + t + 1;
+            }
+        }
+        else {
+            uint32_t running = before;
+            for (int t = 0; t < count; t++) {
+                running += (bits >> t) & 1;
+                row[col + t] = above[col + t] + running;
+            }
+        }
+        before += __builtin_popcountll(bits);
+    }
+}
@@ -0,0 +1,97 @@
+/*************************************************************************
+*                              bit2sum.h
+*
+*
+*      Authors: Jae Hyun Cheigh (jcheig01), Khanh Nguyen (cnguye10)
+*
+*      Fall 2020 - COMP40
+*      HW 2 - Part D
+*
+*
+*      Summary: This is the header file for Bit2Sum_T, a summed-area
+*               table (integral image) of a Bit2_T. It is built in one
+*               pass over the bit array and then counts the 1 bits in
+*               any rectangle in constant time, which is what deciding
+*               whether to despeckle or crop a region needs. It does
+*               not follow later puts into the bit array; after
+*               editing a band of rows, Bit2Sum_update brings it back
+*               in line without rebuilding the rows above the band.
+*
+**************************************************************************/
+
+#ifndef BIT2SUM_INCLUDED
+#define BIT2SUM_INCLUDED
+
+#include <stdint.h>
+#include "bit2.h"
+
+#define T Bit2Sum_T
+typedef struct T *T;
+
+/****************************************************************
+ * Bit2Sum_new
+ * Description: Build the summed-area table of a bit array
+ * Inputs: Bit2_T type bit array, which may be a view
+ * Expectation: The bit array must not be null, or exit with assert.
+ *              Raises Mem_Failed if the table, one 32-bit count per
+ *              pixel plus a row and column, is too big to allocate.
+ * Output: Bit2Sum_T for the bit array, freed with Bit2Sum_free
+ *****************************************************************/
+extern T Bit2Sum_new(Bit2_T bit2);
+
+
+/****************************************************************
+ * Bit2Sum_update
+ * Description: Bring the table up to date after changes to a band
+ *              of rows
+ * Inputs: 1) Bit2Sum_T type table
+ *         2) The bit array it was built from, now edited
+ *         3) Integer first row of the band and its number of rows
+ * Expectation: The bit array must have the table's width and height,
+ *              and the band must be inside it, or exit with assert.
+ *              Bits outside the band must not have changed since
+ *              the table was built or last updated.
+ * Output: Void
+ * Implementation note: the band's rows are rebuilt, and the rows
+ *                      below it only have the change in the band's
+ *                      counts added, which is skipped when the band's
+ *                      column totals did not change.
+ *****************************************************************/
+extern void Bit2Sum_update(T sum, Bit2_T bit2, int first_row, int rows);
+
+
+/****************************************************************
+ * Bit2Sum_count
+ * Description: Count the 1 bits in a rectangle
+ * Inputs: 1) Bit2Sum_T type table
+ *         2) Integer column i and row j of the top left corner, and
+ *            the width and height of the rectangle, as for Bit2_fill
+ * Expectation: The rectangle must be inside the bit array, or exit
+ *              with assert. It may be empty.
+ * Output: Number of 1 bits in the rectangle
+ *****************************************************************/
+extern uint64_t Bit2Sum_count(T sum, int i, int j, int width, int height);
+
+
+/****************************************************************
+ * Bit2Sum_width, Bit2Sum_height
+ * Description: Get the size of the bit array the table was built from
+ * Inputs: Bit2Sum_T type table, not null
+ * Output: Integer width or height
+ *****************************************************************/
+extern int Bit2Sum_width(T sum);
+extern int Bit2Sum_height(T sum);
+
+
+/****************************************************************
+ * Bit2Sum_free
+ * Description: Free a summed-area table
+ * Inputs: Pointer to a Bit2Sum_T, set to NULL afterwards
+ * Expectation: Neither the pointer nor the table may be null, or
+ *              exit with assert.
+ * Output: Void
+ *****************************************************************/
+extern void Bit2Sum_free(T *sum);
+
+#undef T
+#endif
@@ -0,0 +1,262 @@
+/*************************************************************************
+*                              bit2z.c
+*
+*
+*      Authors: Jae Hyun Cheigh (jcheig01), Khanh Nguyen (cnguye10)
+*
+*      Fall 2020 - COMP40
+*      HW 2 - Part D
+*
+*
+*      Summary: This file implements Bit2Z_T, the Morton-order 2D bit
+*               array. Each dimension is rounded up to a power of two
+*               and bit [i, j] lives at the index made by interleaving
+*               the bits of i and j, as described in bit2z_inline.h.
+*               The accessors are inline; this file makes, converts,
+*               maps and frees the bit arrays.
+*
+**************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <limits.h>
+#include "bit2z.h"
+#include "bit2z_inline.h"
+#include "bit2_inline.h"
+#include "assert.h"
+#include "mem.h"
+
+#define T Bit2Z_T
+
+/* smallest b with 2 to the b at least length */
+static int index_bits(int length);
+/* undo Bit2Z_spread: the even bits of a word, packed together */
+static uint32_t gather_bits(uint64_t bits);
+
+/****************************************************************
+ * Bit2Z_new
+ * Description: Create a new Morton-order 2D bit array
+ * Inputs: Integer width and height of the bit array
+ * Output: Bit2Z_T type array with every bit 0
+ * Implementation: Interleave as many bits as the shorter dimension
+ *                 needs, and give the bits above them to the longer
+ *                 one in its mask, so carries in the neighbor
+ *                 helpers run on into them. Allocate zeroed words
+ *                 for every index.
+ *****************************************************************/
+T Bit2Z_new(int width, int height)
+{
+    assert(width >= 0 && height >= 0);
+
+    /* the bits, rounded up, must be countable in a long for CALLOC */
+    int bits_i = index_bits(width);
+    int bits_j = index_bits(height);
+    if (bits_i + bits_j >= (int) sizeof(long) * CHAR_BIT - 1) {
+        RAISE(Mem_Failed);
+    }
+
+    T bit2z;
+    NEW(bit2z);
+
+    int shared = bits_i < bits_j ? bits_i : bits_j;
+    size_t low = ((size_t) 1 << (2 * shared)) - 1;
+
+    bit2z->width = width;
+    bit2z->height = height;
+    bit2z->shared = shared;
+    bit2z->i_mask = (size_t) 0x5555555555555555ull & low;
+    bit2z->j_mask = (size_t) 0xAAAAAAAAAAAAAAAAull & low;
+    if (bits_i > bits_j) {
+        bit2z->i_mask |= ~low;
+    }
+    else if (bits_j > bits_i) {
+        bit2z->j_mask |= ~low;
+    }
+    bit2z->length = (size_t) 1 << (bits_i + bits_j);
+    bit2z->words = CALLOC((long) (bit2z->length / 64) + 1, sizeof(uint64_t));
+
+    return bit2z;
+}
+
+/****************************************************************
+ * Bit2Z_from_bit2
+ * Description: Make a Morton-order copy of a row-major bit array
+ * Inputs: Bit2_T type bit array
+ * Output: New Bit2Z_T type array
+ * Implementation: Only the 1 bits need writing into the new, zeroed
+ *                 bit array.
+ *****************************************************************/
+T Bit2Z_from_bit2(Bit2_T bit2)
+{
+    assert(bit2 != NULL);
+
+    int width = Bit2_width(bit2);
+    int height = Bit2_height(bit2);
+    T bit2z = Bit2Z_new(width, height);
+
+    for (int j = 0; j < height; j++) {
+        for (int i = 0; i < width; i++) {
+            if (Bit2_get_fast(bit2, i, j)) {
+                Bit2Z_put_fast(bit2z, i, j, 1);
+            }
+        }
+    }
+    return bit2z;
+}
+
+/****************************************************************
+ * Bit2Z_to_bit2
+ * Description: Copy a Morton-order bit array into a row-major one
+ * Inputs: 1) Bit2_T type bit array to write
+ *         2) Bit2Z_T type bit array to read
+ * Output: Void
+ * Implementation: Write every bit, row by row.
+ *****************************************************************/
+void Bit2Z_to_bit2(Bit2_T dest, T source)
+{
+    assert(dest != NULL && source != NULL);
+    assert(Bit2_width(dest) == source->width &&
+           Bit2_height(dest) == source->height);
+
+    for (int j = 0; j < source->height; j++) {
+        for (int i = 0; i < source->width; i++) {
+            Bit2_put_fast(dest, i, j, Bit2Z_get_fast(source, i, j));
+        }
+    }
+}
+
+/******************************************************************
+ * Bit2Z_width
+ * Description: Get the number of columns
+ * Inputs: Bit2Z_T type bit array
+ * Output: Integer width
+ ******************************************************************/
+int Bit2Z_width(T bit2z)
+{
+    assert(bit2z != NULL);
+    return bit2z->width;
+}
+
+/******************************************************************
+ * Bit2Z_height
+ * Description: Get the number of rows
+ * Inputs: Bit2Z_T type bit array
+ * Output: Integer height
+ ******************************************************************/
+int Bit2Z_height(T bit2z)
+{
+    assert(bit2z != NULL);
+    return bit2z->height;
+}
+
+/******************************************************************
+ * Bit2Z_get
+ * Description: Get the value of bit [i, j]
+ * Inputs: Bit2Z_T type bit array, integer column i and row j
+ * Output: Integer value of the bit
+ * Implementation: Same as Bit2Z_get_fast
+ ******************************************************************/
+int Bit2Z_get(T bit2z, int i, int j)
+{
+    return Bit2Z_get_fast(bit2z, i, j);
+}
+
+/******************************************************************
+ * Bit2Z_put
+ * Description: Set the value of bit [i, j]
+ * Inputs: Bit2Z_T type bit array, integer column i and row j, and
+ *         integer value 0 or 1
+ * Output: Integer value of the bit before the put
+ * Implementation: Same as Bit2Z_put_fast
+ ******************************************************************/
+int Bit2Z_put(T bit2z, int i, int j, int value)
+{
+    return Bit2Z_put_fast(bit2z, i, j, value);
+}
+
+/******************************************************************
+ * Bit2Z_map
+ * Description: Apply a function to every bit in Morton order
+ * Inputs: 1) Bit2Z_T type bit array
+ *         2) The apply function
+ *         3) A void pointer closure
+ * Output: Void
+ * Implementation: Walk the indices in order, turning each back into
+ *                 [i, j] and skipping those outside the array, which
+ *                 are there only to round the dimensions up.
+ ******************************************************************/
+void Bit2Z_map(T bit2z, void apply(int i, int j, T bit2z, int value,
+                                  void *cl), void *cl)
+{
+    assert(bit2z != NULL);
+    assert(apply != NULL);
+
+    int shared = bit2z->shared;
+    size_t low = ((size_t) 1 << (2 * shared)) - 1;
+    int high_is_i = (bit2z->i_mask & ~low) != 0;
+
+    for (size_t index = 0; index < bit2z->length; index++) {
+        int i = (int) gather_bits(index & low);
+        int j = (int) gather_bits((index & low) >> 1);
+        int high = (int) (index >> (2 * shared)) << shared;
+        if (high_is_i) {
+            i |= high;
+        }
+        else {
+            j |= high;
+        }
+        if (i < bit2z->width && j < bit2z->height) {
+            apply(i, j, bit2z, Bit2Z_get_at(bit2z, index), cl);
+        }
+    }
+}
+
+/******************************************************************
+ * Bit2Z_free
+ * Description: Free a Morton-order bit array
+ * Inputs: Pointer to a Bit2Z_T
+ * Output: Void
+ * Implementation: Free the words, then the bit array, and set the
+ *                 pointer to NULL.
+ ******************************************************************/
+void Bit2Z_free(T *bit2z)
+{
+    assert(bit2z != NULL && *bit2z != NULL);
+
+    FREE((*bit2z)->words);
+    FREE(*bit2z);
+}
+
+/******************************************************************
+ * index_bits
+ * Description: Number of bits needed for the indices of a dimension
+ * Inputs: Integer length of the dimension
+ * Output: Smallest b with 2 to the b at least the length
+ ******************************************************************/
+static int index_bits(int length)
+{
+    int bits = 0;
+    while (bits < 31 && (1 << bits) < length) {
+        bits++;
+    }
+    return bits;
+}
+
+/******************************************************************
+ * gather_bits
+ * Description: Pack the even bits of a word into 32 bits
+ * Inputs: The word
+ * Output: The packed bits
+ * Implementation: Bit2Z_spread run backwards.
+ ******************************************************************/
+static uint32_t gather_bits(uint64_t bits)
+{
+    bits &= 0x5555555555555555ull;
+    bits = (bits | (bits >> 1)) & 0x3333333333333333ull;
+    bits = (bits | (bits >> 2)) & 0x0F0F0F0F0F0F0F0Full;
+    bits = (bits | (bits >> 4)) & 0x00FF00FF00FF00FFull;
+    bits = (bits | (bits >> 8)) & 0x0000FFFF0000FFFFull;
+    bits = (bits | (bits >> 16)) & 0x00000000FFFFFFFFull;
+    return (uint32_t) bits;
+}
@@ -0,0 +1,119 @@
+/*************************************************************************
+*                              bit2z.h
+*
+*
+*      Authors: Jae Hyun Cheigh (jcheig01), Khanh Nguyen (cnguye10)
+*
+*      Fall 2020 - COMP40
+*      HW 2 - Part D
+*
+*
+*      Summary: This is the header file for Bit2Z_T, a 2D bit array
+*               stored in Morton (Z) order. The bits of i and j are
+*               interleaved, so bits that are close in both directions
+*               are close in memory: an 8 x 8 square shares one 64-bit
+*               word, where a row-major Bit2_T puts the pixels above
+*               and below a pixel a whole row away. Searches that move
+*               up and down as often as sideways, like the unblackedges
+*               DFS, touch fewer cache lines. bit2z_inline.h has the
+*               inlined accessors and the neighbor helpers that step
+*               between Morton indices without going back to [i, j].
+*
+**************************************************************************/
+
+#ifndef BIT2Z_INCLUDED
+#define BIT2Z_INCLUDED
+
+#include "bit2.h"
+
+#define T Bit2Z_T
+typedef struct T *T;
+
+/****************************************************************
+ * Bit2Z_new
+ * Description: Create a new 2D bit array in Morton order, with all
+ *              bits 0
+ * Inputs: Integer width and height of the bit array
+ * Expectation: Width and height must not be negative.
+ * Output: Bit2Z_T type array
+ * Expectation: If a dimension is negative, exit with assert.
+ *              Storage is rounded up to powers of two in each
+ *              direction, so it is at most four times the bits.
+ *****************************************************************/
+extern T Bit2Z_new(int width, int height);
+
+
+/****************************************************************
+ * Bit2Z_from_bit2
+ * Description: Make a Morton-order copy of a row-major bit array
+ * Inputs: Bit2_T type bit array, which may be a view
+ * Expectation: Bit array must not be null.
+ * Output: New Bit2Z_T type array with the same bits
+ *****************************************************************/
+extern T Bit2Z_from_bit2(Bit2_T bit2);
+
+
+/****************************************************************
+ * Bit2Z_to_bit2
+ * Description: Copy a Morton-order bit array into a row-major one
+ * Inputs: 1) Bit2_T type bit array to write, which may be a view
+ *         2) Bit2Z_T type bit array to read
+ * Expectation: Neither may be null and both must have the same
+ *              width and height, or exit with assert.
+ * Output: Void
+ *****************************************************************/
+extern void Bit2Z_to_bit2(Bit2_T dest, T source);
+
+
+/****************************************************************
+ * Bit2Z_width, Bit2Z_height
+ * Description: Get the number of columns or rows
+ * Inputs: Bit2Z_T type bit array, not null
+ * Output: Integer width or height
+ *****************************************************************/
+extern int Bit2Z_width(T bit2z);
+extern int Bit2Z_height(T bit2z);
+
+
+/****************************************************************
+ * Bit2Z_get, Bit2Z_put
+ * Description: Same as Bit2_get and Bit2_put
+ * Inputs: 1) Bit2Z_T type bit array
+ *         2) Integer column i and row j
+ *         3) Integer value, 0 or 1 (Bit2Z_put only)
+ * Expectation: The bit array must not be null, the indices must be
+ *              inside it and the value 0 or 1, or exit with assert.
+ * Output: Integer value of the bit, before the put for Bit2Z_put
+ *****************************************************************/
+extern int Bit2Z_get(T bit2z, int i, int j);
+extern int Bit2Z_put(T bit2z, int i, int j, int value);
+
+
+/****************************************************************
+ * Bit2Z_map
+ * Description: Apply a function to every bit in Morton order,
+ *              which is the order the bits are stored in
+ * Inputs: 1) Bit2Z_T type bit array
+ *         2) apply, which gets the column, row, bit array, value
+ *            of the bit and closure
+ *         3) A void pointer closure
+ * Expectation: Bit array and apply must not be null, or exit with
+ *              assert.
+ * Output: Void
+ *****************************************************************/
+extern void Bit2Z_map(T bit2z, void apply(int i, int j, T bit2z, int value,
+                                         void *cl), void *cl);
+
+
+/****************************************************************
+ * Bit2Z_free
+ * Description: Free a bit array and its storage
+ * Inputs: Pointer to a Bit2Z_T, set to NULL afterwards
+ * Expectation: Neither the pointer nor the bit array may be null,
+ *              or exit with assert.
+ * Output: Void
+ *****************************************************************/
+extern void Bit2Z_free(T *bit2z);
+
+#undef T
+#endif
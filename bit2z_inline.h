@@ -0,0 +1,178 @@
+/*************************************************************************
+*                              bit2z_inline.h
+*
+*
+*      Authors: Jae Hyun Cheigh (jcheig01), Khanh Nguyen (cnguye10)
+*
+*      Fall 2020 - COMP40
+*      HW 2 - Part D
+*
+*
+*      Summary: This header shows the representation of Bit2Z_T and
+*               defines its inlined accessors. Bit2Z_index turns [i, j]
+*               into a Morton index, Bit2Z_get_at and Bit2Z_put_at read
+*               and write the bit at an index, and Bit2Z_east, _west,
+*               _south and _north give the index of a neighbor with a
+*               few masks and one add, so a search can move around the
+*               array without interleaving bits at every step. As with
+*               bit2_inline.h, clients should use the functions only
+*               and never the fields.
+*
+**************************************************************************/
+
+#ifndef BIT2Z_INLINE_INCLUDED
+#define BIT2Z_INLINE_INCLUDED
+
+#include <stddef.h>
+#include <stdint.h>
+#include "bit2z.h"
+#include "assert.h"
+
+#define T Bit2Z_T
+
+/*
+ * data that our Morton-order bit array holds. The low shared bits of
+ * i and j are interleaved, i in the even positions and j in the odd,
+ * and the rest of the bits of the longer dimension sit above them, so
+ * a long thin array is a row or column of Z-ordered squares. i_mask
+ * and j_mask are the index bits that come from i and from j. Bit z is
+ * bit z % 64 of words[z / 64].
+ */
+struct T {
+    int width;
+    int height;
+    int shared;
+    size_t i_mask;
+    size_t j_mask;
+    size_t length;
+    uint64_t *words;
+};
+
+/******************************************************************
+ * Bit2Z_spread
+ * Description: Move the low 32 bits of a value to the even bit
+ *              positions of a 64-bit word
+ * Inputs: The value to spread
+ * Output: The spread value
+ * Implementation: Halve the distance the bits move at every step,
+ *                 with masks that keep each group in its place.
+ ******************************************************************/
+static inline uint64_t Bit2Z_spread(uint32_t value)
+{
+    uint64_t bits = value;
+    bits = (bits | (bits << 16)) & 0x0000FFFF0000FFFFull;
+    bits = (bits | (bits << 8)) & 0x00FF00FF00FF00FFull;
+    bits = (bits | (bits << 4)) & 0x0F0F0F0F0F0F0F0Full;
+    bits = (bits | (bits << 2)) & 0x3333333333333333ull;
+    bits = (bits | (bits << 1)) & 0x5555555555555555ull;
+    return bits;
+}
+
+/******************************************************************
+ * Bit2Z_index
+ * Description: Get the Morton index of bit [i, j]
+ * Inputs: 1) Bit2Z_T type bit array
+ *         2) Integer column i and row j, inside the array
+ * Output: Index of the bit, for Bit2Z_get_at and the neighbors
+ ******************************************************************/
+static inline size_t Bit2Z_index(T bit2z, int i, int j)
+{
+    assert(bit2z != NULL);
+    assert(i >= 0 && i < bit2z->width && j >= 0 && j < bit2z->height);
+
+    int shared = bit2z->shared;
+    uint32_t low = ((uint32_t) 1 << shared) - 1;
+
+    return (size_t) (Bit2Z_spread((uint32_t) i & low) |
+                     Bit2Z_spread((uint32_t) j & low) << 1) |
+           (size_t) (((uint32_t) i | (uint32_t) j) >> shared)
+           << (2 * shared);
+}
+
+/******************************************************************
+ * Bit2Z_get_at, Bit2Z_put_at
+ * Description: Read or write the bit at a Morton index
+ * Inputs: 1) Bit2Z_T type bit array
+ *         2) Index from Bit2Z_index or a neighbor helper
+ *         3) Integer value, 0 or 1 (Bit2Z_put_at only)
+ * Output: Integer value of the bit, before the put for Bit2Z_put_at
+ * Implementation: Same as Bit2_get_fast and Bit2_put_fast, without
+ *                 the branch on the value.
+ ******************************************************************/
+static inline int Bit2Z_get_at(T bit2z, size_t index)
+{
+    assert(bit2z != NULL && index < bit2z->length);
+
+    return (int) ((bit2z->words[index / 64] >> (index % 64)) & 1);
+}
+
+static inline int Bit2Z_put_at(T bit2z, size_t index, int value)
+{
+    assert(bit2z != NULL && index < bit2z->length);
+    assert(value == 0 || value == 1);
+
+    uint64_t *word = &bit2z->words[index / 64];
+    unsigned shift = index % 64;
+    int previous = (int) ((*word >> shift) & 1);
+
+    *word = (*word & ~((uint64_t) 1 << shift)) | ((uint64_t) value << shift);
+    return previous;
+}
+
+/******************************************************************
+ * Bit2Z_get_fast, Bit2Z_put_fast
+ * Description: Same as Bit2Z_get and Bit2Z_put, but inlined
+ * Inputs: As for Bit2Z_get and Bit2Z_put
+ * Output: As for Bit2Z_get and Bit2Z_put
+ ******************************************************************/
+static inline int Bit2Z_get_fast(T bit2z, int i, int j)
+{
+    return Bit2Z_get_at(bit2z, Bit2Z_index(bit2z, i, j));
+}
+
+static inline int Bit2Z_put_fast(T bit2z, int i, int j, int value)
+{
+    return Bit2Z_put_at(bit2z, Bit2Z_index(bit2z, i, j), value);
+}
+
+/******************************************************************
+ * Bit2Z_east, Bit2Z_west, Bit2Z_south, Bit2Z_north
+ * Description: Get the Morton index of the bit one column right or
+ *              left, or one row down or up
+ * Inputs: 1) Bit2Z_T type bit array
+ *         2) Index of a bit whose neighbor in that direction is
+ *            inside the array; the caller checks the bounds
+ * Output: Index of the neighbor
+ * Implementation: Add or subtract one in the bits of one dimension
+ *                 only. For a step in i, the j bits are set to 1
+ *                 before adding, so a carry runs straight through
+ *                 them to the next i bit, or masked off before
+ *                 subtracting, so a borrow does; then the j bits are
+ *                 put back.
+ ******************************************************************/
+static inline size_t Bit2Z_east(T bit2z, size_t index)
+{
+    return (((index | bit2z->j_mask) + 1) & bit2z->i_mask) |
+           (index & bit2z->j_mask);
+}
+
+static inline size_t Bit2Z_west(T bit2z, size_t index)
+{
+    return (((index & bit2z->i_mask) - 1) & bit2z->i_mask) |
+           (index & bit2z->j_mask);
+}
+
+static inline size_t Bit2Z_south(T bit2z, size_t index)
+{
+    return (((index | bit2z->i_mask) + 1) & bit2z->j_mask) |
+           (index & bit2z->i_mask);
+}
+
+static inline size_t Bit2Z_north(T bit2z, size_t index)
+{
+    return (((index & bit2z->j_mask) - 1) & bit2z->j_mask) |
+           (index & bit2z->i_mask);
+}
+
+#undef T
+#endif
@@ -0,0 +1,360 @@
+/*************************************************************************
+*                              bit2zbench.c
+*
+*
+*      Authors: Jae Hyun Cheigh (jcheig01), Khanh Nguyen (cnguye10)
+*
+*      Fall 2020 - COMP40
+*      HW 2 - Part D
+*
+*
+*      Summary: This program times the unblackedges search on a
+*               row-major Bit2_T and on a Morton-order Bit2Z_T. It
+*               reads a pbm file (or standard input) and runs the same
+*               DFS as unblack.c on each layout a few times: start
+*               from the black pixels on the edges, visit black
+*               neighbors in all four directions, and unblack every
+*               pixel reached. Both searches keep their pending pixels
+*               in the same growable array, so the difference in time
+*               is the layout. It prints the best time for each, and
+*               checks that both unblacked the same pixels.
+*
+*               Usage: bit2zbench [pbm file] [runs]
+*
+**************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "bit2.h"
+#include "bit2_inline.h"
+#include "bit2z.h"
+#include "bit2z_inline.h"
+#include "pnmrdr.h"
+#include "mem.h"
+
+/* each layout is timed this many times unless told otherwise */
+#define DEFAULT_RUNS 5
+
+/* a black pixel waiting to be searched; index is used by Bit2Z only */
+typedef struct Pixel {
+    int col;
+    int row;
+    size_t index;
+} Pixel;
+
+/* growable stack of pixels, so neither search allocates per pixel */
+typedef struct Pending {
+    Pixel *pixels;
+    int count;
+    int capacity;
+} Pending;
+
+/* read the pbm into a new Bit2_T, exiting if it is not a bitmap */
+Bit2_T read_bitmap(FILE *fp);
+/* unblack the edges of a row-major bitmap */
+void unblack_rows(Bit2_T bitmap, Pending *pending);
+/* unblack the edges of a Morton-order bitmap */
+void unblack_morton(Bit2Z_T bitmap, Pending *pending);
+/* push a pixel, growing the stack if it is full */
+void push_pixel(Pending *pending, int col, int row, size_t index);
+/* seconds on the monotonic clock */
+double now(void);
+
+int main(int argc, char *argv[])
+{
+    FILE *fp = stdin;
+    int runs = DEFAULT_RUNS;
+
+    if (argc > 3) {
+        fprintf(stderr, "Usage: %s [pbm file] [runs]\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+    if (argc >= 2) {
+        fp = fopen(argv[1], "rb");
+        if (fp == NULL) {
+            fprintf(stderr, "%s: %s\n", "Could not open file", argv[1]);
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (argc == 3) {
+        runs = atoi(argv[2]);
+        if (runs <= 0) {
+            fprintf(stderr, "Runs should be positive\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    Bit2_T original = read_bitmap(fp);
+    if (fp != stdin) {
+        fclose(fp);
+    }
+
+    Pending pending = { NULL, 0, 0 };
+    double best_rows = -1;
+    double best_morton = -1;
+    Bit2_T rows = NULL;
+    Bit2Z_T morton = NULL;
+
+    for (int run = 0; run < runs; run++) {
+        if (rows != NULL) {
+            Bit2_free(&rows);
+            Bit2Z_free(&morton);
+        }
+        rows = Bit2_clone(original);
+        morton = Bit2Z_from_bit2(original);
+
+        double start = now();
+        unblack_rows(rows, &pending);
+        double elapsed = now() - start;
+        if (best_rows < 0 || elapsed < best_rows) {
+            best_rows = elapsed;
+        }
+
+        start = now();
+        unblack_morton(morton, &pending);
+        elapsed = now() - start;
+        if (best_morton < 0 || elapsed < best_morton) {
+            best_morton = elapsed;
+        }
+    }
+
+    /* both searches must leave the same picture */
+    Bit2_T check = Bit2_new(Bit2_width(original), Bit2_height(original));
+    Bit2Z_to_bit2(check, morton);
+    int same = 1;
+    for (int row = 0; row < Bit2_height(check) && same; row++) {
+        for (int col = 0; col < Bit2_width(check); col++) {
+            if (Bit2_get_fast(check, col, row) !=
+                Bit2_get_fast(rows, col, row)) {
+                same = 0;
+                break;
+            }
+        }
+    }
+
+    printf("%d x %d, best of %d runs\n", Bit2_width(original),
+           Bit2_height(original), runs);
+    printf("row-major: %10.3f ms\n", best_rows * 1000);
+    printf("morton:    %10.3f ms\n", best_morton * 1000);
+    if (best_morton > 0) {
+        printf("speedup:   %10.2fx\n", best_rows / best_morton);
+    }
+
+    Bit2_free(&check);
+    Bit2_free(&rows);
+    Bit2Z_free(&morton);
+    Bit2_free(&original);
+    FREE(pending.pixels);
+
+    if (!same) {
+        fprintf(stderr, "Layouts disagree\n");
+        exit(EXIT_FAILURE);
+    }
+    return EXIT_SUCCESS;
+}
+
+/***********************************************************
+* read_bitmap
+* Description: Read a pbm file into a bit array
+* Input: File pointer fp
+* Output: New Bit2_T holding the pixels
+* Implementation: Same checks as unblackedges: the file must
+*                 be a pnm, a bitmap, and not empty.
+***********************************************************/
+Bit2_T read_bitmap(FILE *fp)
+{
+    Pnmrdr_T rdr;
+
+    TRY
+        rdr = Pnmrdr_new(fp);
+    EXCEPT(Pnmrdr_Badformat)
+        fprintf(stderr, "Not a pnm\n");
+        exit(EXIT_FAILURE);
+    END_TRY;
+
+    Pnmrdr_mapdata pnmdata = Pnmrdr_data(rdr);
+    if (pnmdata.type != Pnmrdr_bit) {
+        fprintf(stderr, "Not a bitmap\n");
+        exit(EXIT_FAILURE);
+    }
+    if (pnmdata.width == 0 || pnmdata.height == 0) {
+        fprintf(stderr, "Width/Height should not be 0\n");
+        exit(EXIT_FAILURE);
+    }
+
+    Bit2_T bitmap = Bit2_new(pnmdata.width, pnmdata.height);
+    for (int row = 0; row < (int) pnmdata.height; row++) {
+        for (int col = 0; col < (int) pnmdata.width; col++) {
+            Bit2_put_fast(bitmap, col, row, Pnmrdr_get(rdr));
+        }
+    }
+    Pnmrdr_free(&rdr);
+    return bitmap;
+}
+
+/***********************************************************
+* unblack_rows
+* Description: The unblackedges DFS on a row-major bitmap
+* Input: 1) Bit2_T bitmap, unblacked in place
+*        2) Pending stack to use, empty
+* Output: Void
+* Implementation: Push every black pixel on the edges, then
+*                 pop pixels until the stack is empty. A
+*                 pixel not yet visited is marked, its black
+*                 unvisited neighbors are pushed, and it is
+*                 unblacked, as in unblack.c.
+***********************************************************/
+void unblack_rows(Bit2_T bitmap, Pending *pending)
+{
+    int width = Bit2_width(bitmap);
+    int height = Bit2_height(bitmap);
+    Bit2_T visited = Bit2_new(width, height);
+
+    for (int col = 0; col < width; col++) {
+        push_pixel(pending, col, 0, 0);
+        push_pixel(pending, col, height - 1, 0);
+    }
+    for (int row = 0; row < height; row++) {
+        push_pixel(pending, 0, row, 0);
+        push_pixel(pending, width - 1, row, 0);
+    }
+
+    while (pending->count > 0) {
+        Pixel pixel = pending->pixels[--pending->count];
+        int col = pixel.col;
+        int row = pixel.row;
+
+        if (Bit2_get_fast(bitmap, col, row) == 0 ||
+            Bit2_put_fast(visited, col, row, 1) == 1) {
+            continue;
+        }
+        if (col > 0 && Bit2_get_fast(bitmap, col - 1, row) &&
+            !Bit2_get_fast(visited, col - 1, row)) {
+            push_pixel(pending, col - 1, row, 0);
+        }
+        if (col < width - 1 && Bit2_get_fast(bitmap, col + 1, row) &&
+            !Bit2_get_fast(visited, col + 1, row)) {
+            push_pixel(pending, col + 1, row, 0);
+        }
+        if (row > 0 && Bit2_get_fast(bitmap, col, row - 1) &&
+            !Bit2_get_fast(visited, col, row - 1)) {
+            push_pixel(pending, col, row - 1, 0);
+        }
+        if (row < height - 1 && Bit2_get_fast(bitmap, col, row + 1) &&
+            !Bit2_get_fast(visited, col, row + 1)) {
+            push_pixel(pending, col, row + 1, 0);
+        }
+        Bit2_put_fast(bitmap, col, row, 0);
+    }
+
+    Bit2_free(&visited);
+}
+
+/***********************************************************
+* unblack_morton
+* Description: The unblackedges DFS on a Morton-order bitmap
+* Input: 1) Bit2Z_T bitmap, unblacked in place
+*        2) Pending stack to use, empty
+* Output: Void
+* Implementation: Same as unblack_rows, but each pixel
+*                 carries its Morton index, and neighbors are
+*                 found with the Bit2Z neighbor helpers instead
+*                 of from the column and row.
+***********************************************************/
+void unblack_morton(Bit2Z_T bitmap, Pending *pending)
+{
+    int width = Bit2Z_width(bitmap);
+    int height = Bit2Z_height(bitmap);
+    Bit2Z_T visited = Bit2Z_new(width, height);
+
+    for (int col = 0; col < width; col++) {
+        push_pixel(pending, col, 0, Bit2Z_index(bitmap, col, 0));
+        push_pixel(pending, col, height - 1,
+                   Bit2Z_index(bitmap, col, height - 1));
+    }
+    for (int row = 0; row < height; row++) {
+        push_pixel(pending, 0, row, Bit2Z_index(bitmap, 0, row));
+        push_pixel(pending, width - 1, row,
+                   Bit2Z_index(bitmap, width - 1, row));
+    }
+
+    while (pending->count > 0) {
+        Pixel pixel = pending->pixels[--pending->count];
+        int col = pixel.col;
+        int row = pixel.row;
+        size_t index = pixel.index;
+
+        if (Bit2Z_get_at(bitmap, index) == 0 ||
+            Bit2Z_put_at(visited, index, 1) == 1) {
+            continue;
+        }
+        if (col > 0) {
+            size_t next = Bit2Z_west(bitmap, index);
+            if (Bit2Z_get_at(bitmap, next) && !Bit2Z_get_at(visited, next)) {
+                push_pixel(pending, col - 1, row, next);
+            }
+        }
+        if (col < width - 1) {
+            size_t next = Bit2Z_east(bitmap, index);
+            if (Bit2Z_get_at(bitmap, next) && !Bit2Z_get_at(visited, next)) {
+                push_pixel(pending, col + 1, row, next);
+            }
+        }
+        if (row > 0) {
+            size_t next = Bit2Z_north(bitmap, index);
+            if (Bit2Z_get_at(bitmap, next) && !Bit2Z_get_at(visited, next)) {
+                push_pixel(pending, col, row - 1, next);
+            }
+        }
+        if (row < height - 1) {
+            size_t next = Bit2Z_south(bitmap, index);
+            if (Bit2Z_get_at(bitmap, next) && !Bit2Z_get_at(visited, next)) {
+                push_pixel(pending, col, row + 1, next);
+            }
+        }
+        Bit2Z_put_at(bitmap, index, 0);
+    }
+
+    Bit2Z_free(&visited);
+}
+
+/***********************************************************
+* push_pixel
+* Description: Push a pixel onto a pending stack
+* Input: 1) Pending stack
+*        2) Integer column and row, and the Morton index
+* Output: Void
+* Implementation: Start with room for 1024 pixels and double
+*                 the capacity whenever the stack is full.
+***********************************************************/
+void push_pixel(Pending *pending, int col, int row, size_t index)
+{
+    if (pending->capacity == 0) {
+        pending->capacity = 1024;
+        pending->pixels = ALLOC((long) pending->capacity * sizeof(Pixel));
+    }
+    else if (pending->count == pending->capacity) {
+        pending->capacity *= 2;
+        RESIZE(pending->pixels, (long) pending->capacity * sizeof(Pixel));
+    }
+    Pixel *pixel = &pending->pixels[pending->count++];
+    pixel->col = col;
+    pixel->row = row;
+    pixel->index = index;
+}
+
+/***********************************************************
+* now
+* Description: Read the monotonic clock
+* Input: None
+* Output: Seconds, as a double
+***********************************************************/
+double now(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
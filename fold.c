@@ -0,0 +1,620 @@
+/*************************************************************************
+*                              fold.c
+*
+*
+*      Authors: Jae Hyun Cheigh (jcheig01), Khanh Nguyen (cnguye10)
+*
+*      Fall 2020 - COMP40
+*      HW 2 - Part B
+*
+*
+*      Summary: This file implements the parallel folds in fold.h. Every
+*               fold is a band function, which reduces a range of rows
+*               to a new accumulator, and a combine function. Band b
+*               runs on thread b (band 0 on the caller's thread), and
+*               when it is done thread b joins thread b + 1, b + 2,
+*               b + 4 and so on for as long as b is a multiple of twice
+*               the step, combining their accumulators into its own.
+*               So the combines also run in parallel, as a tree, and
+*               band 0 ends up with the result.
+*
+**************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "fold.h"
+#include "uarray2_inline.h"
+#include "bit2_inline.h"
+#include "assert.h"
+#include "mem.h"
+
+/* no band gets fewer elements than this, unless there is one band */
+#define MIN_BAND (1 << 16)
+
+/* reduces rows first_row to end_row - 1 to a new accumulator */
+typedef void *Band_fn(void *array, int first_row, int end_row, void *cl);
+typedef void *Combine_fn(void *left, void *right, void *cl);
+
+typedef struct Fold Fold;
+
+/* one band of rows and the thread that reduces it */
+typedef struct Band {
+    pthread_t thread;
+    int index;
+    Fold *fold;
+    void *acc;
+} Band;
+
+/* a fold in progress */
+struct Fold {
+    void *array;
+    int height;
+    int num_bands;
+    Band_fn *band;
+    Combine_fn *combine;
+    void *cl;
+    Band *bands;
+};
+
+/* the client's callbacks, for UArray2_fold and Bit2_fold */
+typedef struct Callbacks {
+    void *(*init)(void *cl);
+    void (*accumulate_uarray2)(int i, int j, UArray2_T uarray2,
+                               void *value, void *acc, void *cl);
+    void (*accumulate_bit2)(int i, int j, Bit2_T bit2, int value,
+                            void *acc, void *cl);
+    void *(*combine)(void *left, void *right, void *cl);
+    void *cl;
+} Callbacks;
+
+/* split the rows into bands and reduce them on num_threads threads */
+static void *run_fold(void *array, int height, size_t row_elements,
+                      int num_threads, Band_fn *band, Combine_fn *combine,
+                      void *cl);
+/* thread function: reduce one band, then combine with later bands */
+static void *run_band(void *arg);
+
+static void *uarray2_band(void *array, int first_row, int end_row, void *cl);
+static void *bit2_band(void *array, int first_row, int end_row, void *cl);
+static void *client_combine(void *left, void *right, void *cl);
+static void *count_band(void *array, int first_row, int end_row, void *cl);
+static void *sum_u8_band(void *array, int first_row, int end_row, void *cl);
+static void *sum_int_band(void *array, int first_row, int end_row,
+                          void *cl);
+static void *add_combine(void *left, void *right, void *cl);
+static void *histogram_u8_band(void *array, int first_row, int end_row,
+                               void *cl);
+static void *histogram_int_band(void *array, int first_row, int end_row,
+                                void *cl);
+static void *histogram_combine(void *left, void *right, void *cl);
+/* row j of an array as contiguous elements, gathered if need be */
+static const void *band_row(UArray2_T uarray2, int j, char **scratch);
+
+/****************************************************************
+ * UArray2_fold
+ * Description: Reduce an unboxed array to one value on several
+ *              threads
+ * Inputs: 1) UArray2_T type unboxed array
+ *         2) Integer number of threads
+ *         3) init, accumulate and combine callbacks and a closure
+ * Output: The accumulator for the whole array
+ * Implementation: Keep the callbacks in a closure for uarray2_band,
+ *                 which walks the rows of a band, and client_combine.
+ *****************************************************************/
+void *UArray2_fold(UArray2_T uarray2, int num_threads, void *init(void *cl),
+                   void accumulate(int i, int j, UArray2_T uarray2,
+                                   void *value, void *acc, void *cl),
+                   void *combine(void *left, void *right, void *cl),
+                   void *cl)
+{
+    assert(uarray2 != NULL);
+    assert(init != NULL && accumulate != NULL && combine != NULL);
+
+    Callbacks callbacks = { init, accumulate, NULL, combine, cl };
+
+    return run_fold(uarray2, uarray2->height, uarray2->width, num_threads,
+                    uarray2_band, client_combine, &callbacks);
+}
+
+/****************************************************************
+ * Bit2_fold
+ * Description: Reduce a bit array to one value on several threads
+ * Inputs: Same as UArray2_fold
+ * Output: The accumulator for the whole bit array
+ * Implementation: Same as UArray2_fold, with bit2_band.
+ *****************************************************************/
+void *Bit2_fold(Bit2_T bit2, int num_threads, void *init(void *cl),
+                void accumulate(int i, int j, Bit2_T bit2, int value,
+                                void *acc, void *cl),
+                void *combine(void *left, void *right, void *cl),
+                void *cl)
+{
+    assert(bit2 != NULL);
+    assert(init != NULL && accumulate != NULL && combine != NULL);
+
+    Callbacks callbacks = { init, NULL, accumulate, combine, cl };
+
+    return run_fold(bit2, bit2->height, bit2->width, num_threads,
+                    bit2_band, client_combine, &callbacks);
+}
+
+/****************************************************************
+ * Bit2_count
+ * Description: Count the bits set to 1
+ * Inputs: 1) Bit2_T type bit array
+ *         2) Integer number of threads
+ * Output: Number of 1 bits
+ * Implementation: Fold with count_band, which pops whole words, and
+ *                 add the counts of the bands.
+ *****************************************************************/
+uint64_t Bit2_count(Bit2_T bit2, int num_threads)
+{
+    assert(bit2 != NULL);
+
+    uint64_t *total = run_fold(bit2, bit2->height, bit2->width, num_threads,
+                               count_band, add_combine, NULL);
+    uint64_t count = *total;
+    FREE(total);
+    return count;
+}
+
+/****************************************************************
+ * UArray2_sum_u8
+ * Description: Add up the elements of an array of bytes
+ * Inputs: 1) UArray2_T type unboxed array of unsigned bytes
+ *         2) Integer number of threads
+ * Output: Sum of the elements
+ * Implementation: Fold with sum_u8_band and add the band sums.
+ *****************************************************************/
+uint64_t UArray2_sum_u8(UArray2_T uarray2, int num_threads)
+{
+    assert(uarray2 != NULL);
+    assert(uarray2->size == 1);
+
+    uint64_t *total = run_fold(uarray2, uarray2->height, uarray2->width,
+                               num_threads, sum_u8_band, add_combine, NULL);
+    uint64_t sum = *total;
+    FREE(total);
+    return sum;
+}
+
+/****************************************************************
+ * UArray2_sum_int
+ * Description: Add up the elements of an array of ints
+ * Inputs: 1) UArray2_T type unboxed array of ints
+ *         2) Integer number of threads
+ * Output: Sum of the elements
+ * Implementation: Fold with sum_int_band and add the band sums,
+ *                 which are kept as unsigned so adding wraps
+ *                 instead of overflowing.
+ *****************************************************************/
+int64_t UArray2_sum_int(UArray2_T uarray2, int num_threads)
+{
+    assert(uarray2 != NULL);
+    assert(uarray2->size == sizeof(int));
+
+    uint64_t *total = run_fold(uarray2, uarray2->height, uarray2->width,
+                               num_threads, sum_int_band, add_combine, NULL);
+    int64_t sum = (int64_t) *total;
+    FREE(total);
+    return sum;
+}
+
+/****************************************************************
+ * UArray2_histogram_u8
+ * Description: Count how many elements hold each byte value
+ * Inputs: 1) UArray2_T type unboxed array of unsigned bytes
+ *         2) Array of 256 counts to fill in
+ *         3) Integer number of threads
+ * Output: Void
+ * Implementation: Every band fills its own 256 counts, and combine
+ *                 adds them up.
+ *****************************************************************/
+void UArray2_histogram_u8(UArray2_T uarray2, uint64_t counts[256],
+                          int num_threads)
+{
+    assert(uarray2 != NULL && counts != NULL);
+    assert(uarray2->size == 1);
+
+    int bins = 256;
+    uint64_t *total = run_fold(uarray2, uarray2->height, uarray2->width,
+                               num_threads, histogram_u8_band,
+                               histogram_combine, &bins);
+    memcpy(counts, total, bins * sizeof(uint64_t));
+    FREE(total);
+}
+
+/****************************************************************
+ * UArray2_histogram_int
+ * Description: Count how many elements hold each int value from 0
+ *              to bins - 1
+ * Inputs: 1) UArray2_T type unboxed array of ints
+ *         2) Integer number of bins
+ *         3) Array of bins counts to fill in
+ *         4) Integer number of threads
+ * Output: Void
+ * Implementation: Same as UArray2_histogram_u8, skipping values
+ *                 that have no bin.
+ *****************************************************************/
+void UArray2_histogram_int(UArray2_T uarray2, int bins, uint64_t *counts,
+                           int num_threads)
+{
+    assert(uarray2 != NULL && counts != NULL);
+    assert(uarray2->size == sizeof(int));
+    assert(bins > 0);
+
+    uint64_t *total = run_fold(uarray2, uarray2->height, uarray2->width,
+                               num_threads, histogram_int_band,
+                               histogram_combine, &bins);
+    memcpy(counts, total, bins * sizeof(uint64_t));
+    FREE(total);
+}
+
+/****************************************************************
+ * run_fold
+ * Description: Reduce the rows of an array on several threads
+ * Inputs: 1) The array, and its height and width in elements
+ *         2) Integer number of threads, 0 for one per online CPU
+ *         3) Band function, combine function and their closure
+ * Output: The accumulator for all the rows
+ * Implementation: Use at most one band per thread and per row, and
+ *                 no more bands than keep MIN_BAND elements in
+ *                 each, so small arrays are done on the caller's
+ *                 thread alone. Start a thread for every band but
+ *                 the first, from the last band down, since a band
+ *                 joins bands below it, then run the first here. Its
+ *                 run_band returns only after all the other threads
+ *                 have been joined into it.
+ *****************************************************************/
+static void *run_fold(void *array, int height, size_t row_elements,
+                      int num_threads, Band_fn *band, Combine_fn *combine,
+                      void *cl)
+{
+    assert(num_threads >= 0);
+
+    if (num_threads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        num_threads = cpus > 0 ? (int) cpus : 1;
+    }
+
+    size_t elements = row_elements * height;
+    int num_bands = num_threads;
+    if ((size_t) num_bands > elements / MIN_BAND) {
+        num_bands = (int) (elements / MIN_BAND);
+    }
+    if (num_bands > height) {
+        num_bands = height;
+    }
+    if (num_bands < 1) {
+        num_bands = 1;
+    }
+
+    Fold fold = { array, height, num_bands, band, combine, cl, NULL };
+    fold.bands = ALLOC((long) num_bands * sizeof(Band));
+
+    for (int idx = 0; idx < num_bands; idx++) {
+        fold.bands[idx].index = idx;
+        fold.bands[idx].fold = &fold;
+        fold.bands[idx].acc = NULL;
+    }
+    /* last band first, so a band only ever joins threads that exist */
+    for (int idx = num_bands - 1; idx > 0; idx--) {
+        if (pthread_create(&fold.bands[idx].thread, NULL, run_band,
+                           &fold.bands[idx]) != 0) {
+            fprintf(stderr, "Could not start thread\n");
+            exit(1);
+        }
+    }
+    run_band(&fold.bands[0]);
+
+    void *acc = fold.bands[0].acc;
+    FREE(fold.bands);
+    return acc;
+}
+
+/****************************************************************
+ * run_band
+ * Description: Reduce one band, then fold later bands into it
+ * Inputs: Pointer to the Band
+ * Output: NULL
+ * Implementation: Rows are split evenly, band b getting rows
+ *                 height * b / num_bands up to the next band's
+ *                 first row. After step 1, 2, 4, ... a band that is
+ *                 a multiple of twice the step joins the band one
+ *                 step above it and combines that band's result on
+ *                 the right, so bands stay in row order. Every band
+ *                 but 0 is joined exactly once, by the band its
+ *                 lowest set bit away.
+ *****************************************************************/
+static void *run_band(void *arg)
+{
+    Band *band = arg;
+    Fold *fold = band->fold;
+    int idx = band->index;
+    int first_row = (int) ((int64_t) fold->height * idx / fold->num_bands);
+    int end_row = (int) ((int64_t) fold->height * (idx + 1) /
+                         fold->num_bands);
+
+    band->acc = fold->band(fold->array, first_row, end_row, fold->cl);
+
+    for (int step = 1; step < fold->num_bands; step *= 2) {
+        if (idx % (2 * step) != 0) {
+            break;
+        }
+        if (idx + step < fold->num_bands) {
+            Band *right = &fold->bands[idx + step];
+            pthread_join(right->thread, NULL);
+            band->acc = fold->combine(band->acc, right->acc, fold->cl);
+        }
+    }
+    return NULL;
+}
+
+/****************************************************************
+ * uarray2_band, bit2_band
+ * Description: Band functions for UArray2_fold and Bit2_fold
+ * Inputs: 1) The array
+ *         2) Integer first row and the row after the last
+ *         3) Pointer to the client's Callbacks
+ * Output: A new accumulator from init with the band's elements
+ *         added, row by row
+ *****************************************************************/
+static void *uarray2_band(void *array, int first_row, int end_row, void *cl)
+{
+    UArray2_T uarray2 = array;
+    Callbacks *callbacks = cl;
+    void *acc = callbacks->init(callbacks->cl);
+
+    for (int j = first_row; j < end_row; j++) {
+        for (int i = 0; i < uarray2->width; i++) {
+            callbacks->accumulate_uarray2(i, j, uarray2,
+                                          UArray2_at_fast(uarray2, i, j),
+                                          acc, callbacks->cl);
+        }
+    }
+    return acc;
+}
+
+static void *bit2_band(void *array, int first_row, int end_row, void *cl)
+{
+    Bit2_T bit2 = array;
+    Callbacks *callbacks = cl;
+    void *acc = callbacks->init(callbacks->cl);
+
+    for (int j = first_row; j < end_row; j++) {
+        for (int i = 0; i < bit2->width; i++) {
+            callbacks->accumulate_bit2(i, j, bit2,
+                                       Bit2_get_fast(bit2, i, j), acc,
+                                       callbacks->cl);
+        }
+    }
+    return acc;
+}
+
+/****************************************************************
+ * client_combine
+ * Description: Combine function for UArray2_fold and Bit2_fold
+ * Inputs: Left and right accumulators and the Callbacks
+ * Output: The client's combine of the two
+ *****************************************************************/
+static void *client_combine(void *left, void *right, void *cl)
+{
+    Callbacks *callbacks = cl;
+    return callbacks->combine(left, right, callbacks->cl);
+}
+
+/****************************************************************
+ * count_band
+ * Description: Count the 1 bits in a band of a bit array
+ * Inputs: 1) The Bit2_T
+ *         2) Integer first row and the row after the last
+ *         3) Unused closure
+ * Output: New uint64_t count
+ * Implementation: A row is bits first to last of the words. Mask off
+ *                 the bits before first in its word and after last
+ *                 in its word, and pop every word in between.
+ *****************************************************************/
+static void *count_band(void *array, int first_row, int end_row, void *cl)
+{
+    Bit2_T bit2 = array;
+    uint64_t *count;
+    NEW(count);
+    *count = 0;
+    (void) cl;
+
+    if (bit2->width == 0) {
+        return count;
+    }
+    for (int j = first_row; j < end_row; j++) {
+        size_t first = bit2->base + j * bit2->stride;
+        size_t last = first + bit2->width - 1;
+        const uint64_t *words = bit2->words;
+        uint64_t head = ~(uint64_t) 0 << (first % 64);
+        uint64_t tail = ~(uint64_t) 0 >> (63 - last % 64);
+
+        if (first / 64 == last / 64) {
+            *count += __builtin_popcountll(words[first / 64] & head & tail);
+            continue;
+        }
+        *count += __builtin_popcountll(words[first / 64] & head);
+        for (size_t w = first / 64 + 1; w < last / 64; w++) {
+            *count += __builtin_popcountll(words[w]);
+        }
+        *count += __builtin_popcountll(words[last / 64] & tail);
+    }
+    return count;
+}
+
+/****************************************************************
+ * sum_u8_band, sum_int_band
+ * Description: Add up the elements in a band of bytes or ints
+ * Inputs: 1) The UArray2_T
+ *         2) Integer first row and the row after the last
+ *         3) Unused closure
+ * Output: New uint64_t sum. Ints are added as unsigned, which gives
+ *         the same bits as a signed sum without overflow.
+ *****************************************************************/
+static void *sum_u8_band(void *array, int first_row, int end_row, void *cl)
+{
+    UArray2_T uarray2 = array;
+    char *scratch = NULL;
+    uint64_t *sum;
+    NEW(sum);
+    (void) cl;
+
+    uint64_t total = 0;
+    for (int j = first_row; j < end_row; j++) {
+        const uint8_t *row = band_row(uarray2, j, &scratch);
+        /* 2^24 bytes add up to less than 2^32, so sum in 32 bits */
+        for (int start = 0; start < uarray2->width; start += 1 << 24) {
+            int end = uarray2->width - start < (1 << 24) ?
+                      uarray2->width : start + (1 << 24);
+            uint32_t chunk = 0;
+            for (int i = start; i < end; i++) {
+                chunk += row[i];
+            }
+            total += chunk;
+        }
+    }
+    *sum = total;
+    FREE(scratch);
+    return sum;
+}
+
+static void *sum_int_band(void *array, int first_row, int end_row,
+                          void *cl)
+{
+    UArray2_T uarray2 = array;
+    char *scratch = NULL;
+    uint64_t *sum;
+    NEW(sum);
+    (void) cl;
+
+    uint64_t total = 0;
+    for (int j = first_row; j < end_row; j++) {
+        const int *row = band_row(uarray2, j, &scratch);
+        for (int i = 0; i < uarray2->width; i++) {
+            total += (uint64_t) (int64_t) row[i];
+        }
+    }
+    *sum = total;
+    FREE(scratch);
+    return sum;
+}
+
+/****************************************************************
+ * add_combine
+ * Description: Combine function for counts and sums
+ * Inputs: Left and right uint64_t accumulators, unused closure
+ * Output: Left, holding the total, after right is freed
+ *****************************************************************/
+static void *add_combine(void *left, void *right, void *cl)
+{
+    (void) cl;
+    *(uint64_t *) left += *(uint64_t *) right;
+    FREE(right);
+    return left;
+}
+
+/****************************************************************
+ * histogram_u8_band, histogram_int_band
+ * Description: Count the values in a band of bytes or ints
+ * Inputs: 1) The UArray2_T
+ *         2) Integer first row and the row after the last
+ *         3) Pointer to the integer number of bins
+ * Output: New array of counts, one per bin
+ *****************************************************************/
+static void *histogram_u8_band(void *array, int first_row, int end_row,
+                               void *cl)
+{
+    UArray2_T uarray2 = array;
+    char *scratch = NULL;
+    uint64_t *counts = CALLOC(*(int *) cl, sizeof(uint64_t));
+
+    for (int j = first_row; j < end_row; j++) {
+        const uint8_t *row = band_row(uarray2, j, &scratch);
+        for (int i = 0; i < uarray2->width; i++) {
+            counts[row[i]]++;
+        }
+    }
+    FREE(scratch);
+    return counts;
+}
+
+static void *histogram_int_band(void *array, int first_row, int end_row,
+                                void *cl)
+{
+    UArray2_T uarray2 = array;
+    char *scratch = NULL;
+    unsigned bins = *(int *) cl;
+    uint64_t *counts = CALLOC(bins, sizeof(uint64_t));
+
+    for (int j = first_row; j < end_row; j++) {
+        const int *row = band_row(uarray2, j, &scratch);
+        for (int i = 0; i < uarray2->width; i++) {
+            /* negative values wrap to large ones, so one test does */
+            unsigned value = (unsigned) row[i];
+            if (value < bins) {
+                counts[value]++;
+            }
+        }
+    }
+    FREE(scratch);
+    return counts;
+}
+
+/****************************************************************
+ * histogram_combine
+ * Description: Combine function for histograms
+ * Inputs: Left and right arrays of counts, pointer to the number of
+ *         bins
+ * Output: Left, holding the totals, after right is freed
+ *****************************************************************/
+static void *histogram_combine(void *left, void *right, void *cl)
+{
+    uint64_t *totals = left;
+    uint64_t *counts = right;
+    int bins = *(int *) cl;
+
+    for (int idx = 0; idx < bins; idx++) {
+        totals[idx] += counts[idx];
+    }
+    FREE(right);
+    return left;
+}
+
+/****************************************************************
+ * band_row
+ * Description: Get a row of an array as contiguous elements
+ * Inputs: 1) The UArray2_T
+ *         2) Integer row
+ *         3) Pointer to a scratch row, NULL until it is first needed,
+ *            which the caller frees
+ * Output: Pointer to the width elements of row j, in order
+ * Implementation: A row-major row is used in place. A row of a
+ *                 column-major array or a custom layout is copied
+ *                 into the scratch row, so the built-in reductions
+ *                 keep their simple inner loops for every order.
+ *****************************************************************/
+static const void *band_row(UArray2_T uarray2, int j, char **scratch)
+{
+    int size = uarray2->size;
+
+    if (uarray2->layout == NULL && uarray2->step == (size_t) size) {
+        return uarray2->elems + j * uarray2->stride;
+    }
+    if (*scratch == NULL) {
+        *scratch = ALLOC((long) uarray2->width * size + 1);
+    }
+    for (int i = 0; i < uarray2->width; i++) {
+        memcpy(*scratch + (size_t) i * size, UArray2_at_fast(uarray2, i, j),
+               size);
+    }
+    return *scratch;
+}
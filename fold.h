@@ -0,0 +1,115 @@
+/*************************************************************************
+*                              fold.h
+*
+*
+*      Authors: Jae Hyun Cheigh (jcheig01), Khanh Nguyen (cnguye10)
+*
+*      Fall 2020 - COMP40
+*      HW 2 - Part B
+*
+*
+*      Summary: This is the header file for fold.c, parallel reductions
+*               over UArray2_T and Bit2_T. A fold splits the array into
+*               bands of whole rows, one per thread; each band starts
+*               from its own accumulator, and the accumulators are then
+*               combined in pairs, as a tree, so nothing is shared
+*               while the elements are read. Counts, sums and
+*               histograms have built-in versions that skip the
+*               per-element callback. Clients link with -lpthread.
+*
+**************************************************************************/
+
+#ifndef FOLD_INCLUDED
+#define FOLD_INCLUDED
+
+#include <stdint.h>
+#include "uarray2.h"
+#include "bit2.h"
+
+/******************************************************************
+ * UArray2_fold
+ * Description: Reduce an unboxed array to one value on several
+ *              threads
+ * Inputs: 1) UArray2_T type unboxed array
+ *         2) Integer number of threads, 0 for one per online CPU
+ *         3) init, which returns a new empty accumulator
+ *         4) accumulate, which adds element [i, j] to an accumulator
+ *         5) combine, which returns the accumulator for two bands,
+ *            left being the band of lower rows; it may reuse left
+ *            and free right
+ *         6) A void pointer closure passed to all three
+ * Expectation: Parameter array and functions must not be null and
+ *              the number of threads must not be negative.
+ * Output: The accumulator for the whole array. An empty array gives
+ *         the accumulator from one call to init.
+ * Expectation: If an expectation is not met, exit with assert.
+ *              Within a band elements are visited row by row. The
+ *              callbacks run on several threads at once, so they
+ *              must not change anything shared through the closure.
+ *              If a thread cannot be started, exit with an error.
+ ******************************************************************/
+extern void *UArray2_fold(UArray2_T uarray2, int num_threads,
+                          void *init(void *cl),
+                          void accumulate(int i, int j, UArray2_T uarray2,
+                                          void *value, void *acc, void *cl),
+                          void *combine(void *left, void *right, void *cl),
+                          void *cl);
+
+
+/******************************************************************
+ * Bit2_fold
+ * Description: Reduce a bit array to one value on several threads
+ * Inputs: Same as UArray2_fold, except that accumulate gets the
+ *         value of bit [i, j]
+ * Expectation: Same as UArray2_fold.
+ * Output: The accumulator for the whole bit array
+ ******************************************************************/
+extern void *Bit2_fold(Bit2_T bit2, int num_threads,
+                       void *init(void *cl),
+                       void accumulate(int i, int j, Bit2_T bit2,
+                                       int value, void *acc, void *cl),
+                       void *combine(void *left, void *right, void *cl),
+                       void *cl);
+
+
+/******************************************************************
+ * Bit2_count
+ * Description: Count the bits set to 1
+ * Inputs: 1) Bit2_T type bit array
+ *         2) Integer number of threads, 0 for one per online CPU
+ * Output: Number of 1 bits, counted a word at a time
+ ******************************************************************/
+extern uint64_t Bit2_count(Bit2_T bit2, int num_threads);
+
+
+/******************************************************************
+ * UArray2_sum_u8, UArray2_sum_int
+ * Description: Add up the elements of an array of bytes or ints
+ * Inputs: 1) UArray2_T type unboxed array whose elements are one
+ *            unsigned byte, or one int
+ *         2) Integer number of threads, 0 for one per online CPU
+ * Expectation: The element size must match, or exit with assert.
+ * Output: Sum of the elements, in 64 bits
+ ******************************************************************/
+extern uint64_t UArray2_sum_u8(UArray2_T uarray2, int num_threads);
+extern int64_t UArray2_sum_int(UArray2_T uarray2, int num_threads);
+
+
+/******************************************************************
+ * UArray2_histogram_u8, UArray2_histogram_int
+ * Description: Count how many elements hold each value
+ * Inputs: 1) UArray2_T type unboxed array of unsigned bytes or ints
+ *         2) Integer number of bins (ints only; bytes have 256)
+ *         3) Array of one count per bin, which is overwritten
+ *         4) Integer number of threads, 0 for one per online CPU
+ * Expectation: The element size must match and counts must not be
+ *              null, or exit with assert.
+ * Output: Void. counts[v] is the number of elements equal to v. Int
+ *         elements outside 0 to bins - 1 are not counted.
+ ******************************************************************/
+extern void UArray2_histogram_u8(UArray2_T uarray2, uint64_t counts[256],
+                                 int num_threads);
+extern void UArray2_histogram_int(UArray2_T uarray2, int bins,
+                                  uint64_t *counts, int num_threads);
+
+#endif
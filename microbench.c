@@ -0,0 +1,477 @@
+/*************************************************************************
+*                              microbench.c
+*
+*
+*      Authors: Jae Hyun Cheigh (jcheig01), Khanh Nguyen (cnguye10)
+*
+*      Fall 2020 - COMP40
+*      HW 2 - Part D
+*
+*
+*      Summary: This program times the UArray2 and Bit2 primitives:
+*               element and bit access, the row- and column-major maps,
+*               and the bulk fill, copy and transpose, on square arrays
+*               from a few kilobytes (inside L1) to 64MB (bigger than
+*               the last-level cache of most machines). Every case is
+*               run a few times to warm up, then timed over a number
+*               of trials; a trial repeats the operation until it has
+*               touched about a million elements, so small arrays are
+*               not lost in the clock's resolution. For each case and
+*               size it reports the median and 99th percentile time
+*               per element in nanoseconds, as JSON on standard
+*               output, so runs can be saved and compared. With fewer
+*               than 100 trials the 99th percentile is the slowest.
+*               Each result also has the sum of what the reads saw,
+*               the "sink", which keeps the compiler from dropping
+*               them.
+*
+*               "make bench" builds this and writes bench.json; build
+*               with "make RELEASE=1" for numbers without the asserts.
+*
+*               Usage: microbench [trials]
+*
+**************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "uarray2.h"
+#include "uarray2_inline.h"
+#include "bit2.h"
+#include "bit2_inline.h"
+#include "bit2_atomic.h"
+#include "mem.h"
+
+/* untimed runs of each case, and timed ones unless told otherwise */
+#define WARMUP 2
+#define DEFAULT_TRIALS 11
+/* a trial repeats the operation until it touches this many elements */
+#define TRIAL_ELEMENTS (1 << 20)
+
+/* the arrays one size of one case works on, and the sum of the values
+   read from them, printed with the results */
+typedef struct Fixture {
+    int side;
+    UArray2_T array;
+    UArray2_T other;
+    Bit2_T bits;
+    Bit2_T other_bits;
+    long sink;
+} Fixture;
+
+/* a timed operation; bits is 1 if it works on the Bit2 arrays */
+typedef struct Bench {
+    const char *name;
+    int bits;
+    void (*run)(Fixture *fixture);
+} Bench;
+
+/* the cases, in bench_cases below */
+static void uarray2_at(Fixture *fixture);
+static void uarray2_at_fast(Fixture *fixture);
+static void uarray2_map_row(Fixture *fixture);
+static void uarray2_map_col(Fixture *fixture);
+static void uarray2_fill(Fixture *fixture);
+static void uarray2_copy(Fixture *fixture);
+static void uarray2_transpose(Fixture *fixture);
+static void bit2_get(Fixture *fixture);
+static void bit2_get_fast(Fixture *fixture);
+static void bit2_put(Fixture *fixture);
+static void bit2_put_fast(Fixture *fixture);
+static void bit2_test_and_set(Fixture *fixture);
+static void bit2_map_row(Fixture *fixture);
+static void bit2_map_col(Fixture *fixture);
+static void bit2_map_ones(Fixture *fixture);
+static void bit2_fill(Fixture *fixture);
+static void bit2_copy(Fixture *fixture);
+static void bit2_transpose(Fixture *fixture);
+
+static const Bench bench_cases[] = {
+    { "UArray2_at",          0, uarray2_at },
+    { "UArray2_at_fast",     0, uarray2_at_fast },
+    { "UArray2_map_row_major", 0, uarray2_map_row },
+    { "UArray2_map_col_major", 0, uarray2_map_col },
+    { "UArray2_fill",        0, uarray2_fill },
+    { "UArray2_copy",        0, uarray2_copy },
+    { "UArray2_orient_into", 0, uarray2_transpose },
+    { "Bit2_get",            1, bit2_get },
+    { "Bit2_get_fast",       1, bit2_get_fast },
+    { "Bit2_put",            1, bit2_put },
+    { "Bit2_put_fast",       1, bit2_put_fast },
+    { "Bit2_test_and_set",   1, bit2_test_and_set },
+    { "Bit2_map_row_major",  1, bit2_map_row },
+    { "Bit2_map_col_major",  1, bit2_map_col },
+    { "Bit2_map_ones",       1, bit2_map_ones },
+    { "Bit2_fill",           1, bit2_fill },
+    { "Bit2_copy",           1, bit2_copy },
+    { "Bit2_orient_into",    1, bit2_transpose }
+};
+
+/* sides of the square arrays: 16KB to 64MB of ints, 8KB to 32MB of bits */
+static const int uarray2_sides[] = { 64, 256, 1024, 4096 };
+static const int bit2_sides[] = { 256, 1024, 4096, 16384 };
+
+/* make the arrays for one case and size */
+static void setup(Fixture *fixture, int bits, int side);
+/* free them */
+static void teardown(Fixture *fixture, int bits);
+/* time one case and size and print its JSON object */
+static void run_bench(const Bench *bench, int side, int trials, int first);
+/* sort trial times for the percentiles */
+static int compare_doubles(const void *left, const void *right);
+/* seconds on the monotonic clock */
+static double now(void);
+
+int main(int argc, char *argv[])
+{
+    int trials = DEFAULT_TRIALS;
+
+    if (argc > 2) {
+        fprintf(stderr, "Usage: %s [trials]\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+    if (argc == 2) {
+        trials = atoi(argv[1]);
+        if (trials <= 0) {
+            fprintf(stderr, "Trials should be positive\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+#ifdef NDEBUG
+    int asserts = 0;
+#else
+    int asserts = 1;
+#endif
+    printf("{\n  \"asserts\": %s,\n  \"warmup\": %d,\n  \"trials\": %d,\n",
+           asserts ? "true" : "false", WARMUP, trials);
+    printf("  \"results\": [\n");
+
+    int first = 1;
+    int count = sizeof(bench_cases) / sizeof(bench_cases[0]);
+    for (int c = 0; c < count; c++) {
+        const int *sides = bench_cases[c].bits ? bit2_sides : uarray2_sides;
+        for (int s = 0; s < 4; s++) {
+            run_bench(&bench_cases[c], sides[s], trials, first);
+            first = 0;
+        }
+    }
+    printf("\n  ]\n}\n");
+    return EXIT_SUCCESS;
+}
+
+/***********************************************************
+* run_bench
+* Description: Time one case on one size of array
+* Input: 1) The case
+*        2) Integer side of the square arrays
+*        3) Integer number of timed trials
+*        4) Integer, 1 for the first result printed
+* Output: Void
+* Implementation: Make fresh arrays, run the case WARMUP
+*                 times, then time each trial of enough
+*                 repeats to touch TRIAL_ELEMENTS elements.
+*                 Print the median and the trial at the 99th
+*                 percentile by nearest rank, per element, and
+*                 the sink, which depends on every read.
+***********************************************************/
+static void run_bench(const Bench *bench, int side, int trials, int first)
+{
+    Fixture fixture;
+    setup(&fixture, bench->bits, side);
+
+    double elements = (double) side * side;
+    int repeats = TRIAL_ELEMENTS / (side * side);
+    if (repeats < 1) {
+        repeats = 1;
+    }
+
+    for (int w = 0; w < WARMUP; w++) {
+        bench->run(&fixture);
+    }
+
+    double *times = ALLOC((long) trials * sizeof(double));
+    for (int t = 0; t < trials; t++) {
+        double start = now();
+        for (int r = 0; r < repeats; r++) {
+            bench->run(&fixture);
+        }
+        times[t] = (now() - start) * 1e9 / (elements * repeats);
+    }
+    qsort(times, trials, sizeof(double), compare_doubles);
+
+    int p99 = (99 * trials + 99) / 100 - 1;
+    size_t bytes = bench->bits ? (size_t) side * side / 8
+                               : (size_t) side * side * sizeof(int);
+    printf("%s    {\"name\": \"%s\", \"width\": %d, \"height\": %d, "
+           "\"bytes\": %zu, \"repeats\": %d, "
+           "\"median_ns\": %.4f, \"p99_ns\": %.4f, \"sink\": %ld}",
+           first ? "" : ",\n", bench->name, side, side, bytes, repeats,
+           times[trials / 2], times[p99], fixture.sink);
+    fflush(stdout);
+
+    FREE(times);
+    teardown(&fixture, bench->bits);
+}
+
+/***********************************************************
+* setup
+* Description: Make the arrays for one case and size
+* Input: 1) Fixture to fill in
+*        2) Integer, 1 for Bit2 arrays, 0 for UArray2
+*        3) Integer side of the square arrays
+* Output: Void
+* Implementation: Two arrays, so copies have a source and a
+*                 destination. Ints hold i + j; about one bit
+*                 in 16 is set, from a fixed seed, so every
+*                 run sees the same picture.
+***********************************************************/
+static void setup(Fixture *fixture, int bits, int side)
+{
+    fixture->side = side;
+    fixture->sink = 0;
+    fixture->array = NULL;
+    fixture->other = NULL;
+    fixture->bits = NULL;
+    fixture->other_bits = NULL;
+
+    if (!bits) {
+        fixture->array = UArray2_new(side, side, sizeof(int));
+        fixture->other = UArray2_new(side, side, sizeof(int));
+        for (int j = 0; j < side; j++) {
+            for (int i = 0; i < side; i++) {
+                *(int *) UArray2_at_fast(fixture->array, i, j) = i + j;
+            }
+        }
+        return;
+    }
+
+    unsigned seed = 40;
+    fixture->bits = Bit2_new(side, side);
+    fixture->other_bits = Bit2_new(side, side);
+    for (int j = 0; j < side; j++) {
+        for (int i = 0; i < side; i++) {
+            seed = seed * 1103515245 + 12345;
+            Bit2_put_fast(fixture->bits, i, j, (seed >> 16) % 16 == 0);
+        }
+    }
+}
+
+/***********************************************************
+* teardown
+* Description: Free the arrays of a fixture
+* Input: 1) Fixture
+*        2) Integer, 1 for Bit2 arrays, 0 for UArray2
+* Output: Void
+***********************************************************/
+static void teardown(Fixture *fixture, int bits)
+{
+    if (bits) {
+        Bit2_free(&fixture->bits);
+        Bit2_free(&fixture->other_bits);
+    }
+    else {
+        UArray2_free(&fixture->array);
+        UArray2_free(&fixture->other);
+    }
+}
+
+/***********************************************************
+* sum_int, sum_bit
+* Description: Apply functions for the map cases, adding
+*              each value to the fixture's sink, which is
+*              printed, so the reads cannot be optimized away
+***********************************************************/
+static void sum_int(int i, int j, UArray2_T array, void *value, void *cl)
+{
+    (void) i;
+    (void) j;
+    (void) array;
+    ((Fixture *) cl)->sink += *(int *) value;
+}
+
+static void sum_bit(int i, int j, Bit2_T bits, int value, void *cl)
+{
+    (void) i;
+    (void) j;
+    (void) bits;
+    ((Fixture *) cl)->sink += value;
+}
+
+/***********************************************************
+* The UArray2 cases
+* Description: Read every int row by row through UArray2_at
+*              or UArray2_at_fast, map rows or columns, fill
+*              the array, copy it whole, or transpose it into
+*              the other array
+***********************************************************/
+static void uarray2_at(Fixture *fixture)
+{
+    long sum = 0;
+    for (int j = 0; j < fixture->side; j++) {
+        for (int i = 0; i < fixture->side; i++) {
+            sum += *(int *) UArray2_at(fixture->array, i, j);
+        }
+    }
+    fixture->sink += sum;
+}
+
+static void uarray2_at_fast(Fixture *fixture)
+{
+    long sum = 0;
+    for (int j = 0; j < fixture->side; j++) {
+        for (int i = 0; i < fixture->side; i++) {
+            sum += *(int *) UArray2_at_fast(fixture->array, i, j);
+        }
+    }
+    fixture->sink += sum;
+}
+
+static void uarray2_map_row(Fixture *fixture)
+{
+    UArray2_map_row_major(fixture->array, sum_int, fixture);
+}
+
+static void uarray2_map_col(Fixture *fixture)
+{
+    UArray2_map_col_major(fixture->array, sum_int, fixture);
+}
+
+static void uarray2_fill(Fixture *fixture)
+{
+    int value = (int) fixture->sink++;
+    UArray2_fill(fixture->array, 0, 0, fixture->side, fixture->side, &value);
+}
+
+static void uarray2_copy(Fixture *fixture)
+{
+    UArray2_copy(fixture->other, 0, 0, fixture->array, 0, 0, fixture->side,
+                 fixture->side);
+}
+
+static void uarray2_transpose(Fixture *fixture)
+{
+    UArray2_orient_into(fixture->other, fixture->array, UArray2_TRANSPOSE);
+}
+
+/***********************************************************
+* The Bit2 cases
+* Description: Read every bit row by row through Bit2_get or
+*              Bit2_get_fast; write every bit through
+*              Bit2_put, Bit2_put_fast or an atomic
+*              Bit2_test_and_set; map rows, columns or just
+*              the 1 bits; fill the array; copy it whole; or
+*              transpose it into the other array
+***********************************************************/
+static void bit2_get(Fixture *fixture)
+{
+    long sum = 0;
+    for (int j = 0; j < fixture->side; j++) {
+        for (int i = 0; i < fixture->side; i++) {
+            sum += Bit2_get(fixture->bits, i, j);
+        }
+    }
+    fixture->sink += sum;
+}
+
+static void bit2_get_fast(Fixture *fixture)
+{
+    long sum = 0;
+    for (int j = 0; j < fixture->side; j++) {
+        for (int i = 0; i < fixture->side; i++) {
+            sum += Bit2_get_fast(fixture->bits, i, j);
+        }
+    }
+    fixture->sink += sum;
+}
+
+static void bit2_put(Fixture *fixture)
+{
+    for (int j = 0; j < fixture->side; j++) {
+        for (int i = 0; i < fixture->side; i++) {
+            Bit2_put(fixture->other_bits, i, j, (i ^ j) & 1);
+        }
+    }
+}
+
+static void bit2_put_fast(Fixture *fixture)
+{
+    for (int j = 0; j < fixture->side; j++) {
+        for (int i = 0; i < fixture->side; i++) {
+            Bit2_put_fast(fixture->other_bits, i, j, (i ^ j) & 1);
+        }
+    }
+}
+
+static void bit2_test_and_set(Fixture *fixture)
+{
+    long sum = 0;
+    for (int j = 0; j < fixture->side; j++) {
+        for (int i = 0; i < fixture->side; i++) {
+            sum += Bit2_test_and_set(fixture->other_bits, i, j,
+                                     Bit2_RELAXED);
+        }
+    }
+    fixture->sink += sum;
+}
+
+static void bit2_map_row(Fixture *fixture)
+{
+    Bit2_map_row_major(fixture->bits, sum_bit, fixture);
+}
+
+static void bit2_map_col(Fixture *fixture)
+{
+    Bit2_map_col_major(fixture->bits, sum_bit, fixture);
+}
+
+static void bit2_map_ones(Fixture *fixture)
+{
+    Bit2_map_ones(fixture->bits, sum_bit, fixture);
+}
+
+static void bit2_fill(Fixture *fixture)
+{
+    Bit2_fill(fixture->other_bits, 0, 0, fixture->side, fixture->side,
+              (int) (fixture->sink++ & 1));
+}
+
+static void bit2_copy(Fixture *fixture)
+{
+    Bit2_copy(fixture->other_bits, 0, 0, fixture->bits, 0, 0, fixture->side,
+              fixture->side);
+}
+
+static void bit2_transpose(Fixture *fixture)
+{
+    Bit2_orient_into(fixture->other_bits, fixture->bits, Bit2_TRANSPOSE);
+}
+
+/***********************************************************
+* compare_doubles
+* Description: qsort comparison for trial times
+* Input: Pointers to two doubles
+* Output: Negative, zero or positive as the first is less,
+*         equal or greater
+***********************************************************/
+static int compare_doubles(const void *left, const void *right)
+{
+    double a = *(const double *) left;
+    double b = *(const double *) right;
+    return (a > b) - (a < b);
+}
+
+/***********************************************************
+* now
+* Description: Read the monotonic clock
+* Input: None
+* Output: Seconds, as a double
+***********************************************************/
+static double now(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
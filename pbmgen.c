@@ -0,0 +1,237 @@
+/*************************************************************************
+*                              pbmgen.c
+*
+*
+*      Authors: Jae Hyun Cheigh (jcheig01), Khanh Nguyen (cnguye10)
+*
+*      Fall 2020 - COMP40
+*      HW 2 - Part D
+*
+*
+*      Summary: This program writes synthetic scanned pages as raw
+*               (P4) pbm files on standard output, for timing
+*               unblackedges. The same arguments always give the same
+*               file. Kinds of page:
+*
+*               page    a black border of the given thickness (a scan
+*                       edge), lines of glyph-like blobs of text, and
+*                       specks of noise, the given number per thousand
+*                       pixels
+*               black   every pixel black, so everything is unblacked
+*               spiral  a one pixel wide black path from the corner
+*                       spiralling inward with one pixel gaps, so the
+*                       DFS has to follow about half the pixels in a
+*                       single chain
+*
+*               Usage: pbmgen kind width height [border] [noise] [seed]
+*
+**************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bit2.h"
+#include "bit2_inline.h"
+#include "mem.h"
+
+/* text lines are this many rows apart, and glyphs this tall */
+#define LINE_PITCH 24
+#define GLYPH_HEIGHT 12
+
+/* draw a scanned text page with a border and noise */
+void draw_page(Bit2_T page, int border, int noise, unsigned *seed);
+/* draw a spiral path from the top left corner inward */
+void draw_spiral(Bit2_T page);
+/* write the bit array as a raw pbm */
+void write_pbm(Bit2_T page, FILE *out);
+/* next value of a fixed linear congruential generator */
+unsigned next_random(unsigned *seed);
+
+int main(int argc, char *argv[])
+{
+    if (argc < 4 || argc > 7) {
+        fprintf(stderr, "Usage: %s page|black|spiral width height "
+                "[border] [noise] [seed]\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    int width = atoi(argv[2]);
+    int height = atoi(argv[3]);
+    int border = argc > 4 ? atoi(argv[4]) : 0;
+    int noise = argc > 5 ? atoi(argv[5]) : 0;
+    unsigned seed = argc > 6 ? (unsigned) atoi(argv[6]) : 1;
+
+    if (width <= 0 || height <= 0 || border < 0 || noise < 0 ||
+        noise > 1000) {
+        fprintf(stderr, "Width/Height should be positive, border not "
+                "negative, and noise 0 to 1000\n");
+        exit(EXIT_FAILURE);
+    }
+
+    Bit2_T page = Bit2_new(width, height);
+    if (strcmp(argv[1], "page") == 0) {
+        draw_page(page, border, noise, &seed);
+    }
+    else if (strcmp(argv[1], "black") == 0) {
+        Bit2_fill(page, 0, 0, width, height, 1);
+    }
+    else if (strcmp(argv[1], "spiral") == 0) {
+        draw_spiral(page);
+    }
+    else {
+        fprintf(stderr, "Unknown kind: %s\n", argv[1]);
+        Bit2_free(&page);
+        exit(EXIT_FAILURE);
+    }
+
+    write_pbm(page, stdout);
+    Bit2_free(&page);
+    return EXIT_SUCCESS;
+}
+
+/***********************************************************
+* draw_page
+* Description: Draw a scanned page of text
+* Input: 1) Bit2_T page, all white
+*        2) Integer border thickness in pixels
+*        3) Integer noise, black specks per 1000 pixels
+*        4) Pointer to the random seed
+* Output: Void
+* Implementation: Fill the border in from each edge. Inside
+*                 it, every LINE_PITCH rows starts a line of
+*                 glyphs: blocks GLYPH_HEIGHT tall and 4 to 11
+*                 wide with a gap of 2 to 5 after, each pixel
+*                 black with chance one half, and an occasional
+*                 wider gap between words. Then sprinkle the
+*                 noise over the whole page.
+***********************************************************/
+void draw_page(Bit2_T page, int border, int noise, unsigned *seed)
+{
+    int width = Bit2_width(page);
+    int height = Bit2_height(page);
+    int thick_x = border < width ? border : width;
+    int thick_y = border < height ? border : height;
+
+    Bit2_fill(page, 0, 0, width, thick_y, 1);
+    Bit2_fill(page, 0, height - thick_y, width, thick_y, 1);
+    Bit2_fill(page, 0, 0, thick_x, height, 1);
+    Bit2_fill(page, width - thick_x, 0, thick_x, height, 1);
+
+    int margin = border + LINE_PITCH;
+    for (int top = margin; top + GLYPH_HEIGHT < height - margin;
+         top += LINE_PITCH) {
+        int col = margin;
+        while (col < width - margin) {
+            int glyph = 4 + next_random(seed) % 8;
+            if (col + glyph > width - margin) {
+                break;
+            }
+            for (int row = top; row < top + GLYPH_HEIGHT; row++) {
+                for (int i = col; i < col + glyph; i++) {
+                    if (next_random(seed) % 2) {
+                        Bit2_put_fast(page, i, row, 1);
+                    }
+                }
+            }
+            col += glyph + 2 + next_random(seed) % 4;
+            if (next_random(seed) % 6 == 0) {
+                col += 8;
+            }
+        }
+    }
+
+    if (noise > 0) {
+        for (int row = 0; row < height; row++) {
+            for (int col = 0; col < width; col++) {
+                if ((int) (next_random(seed) % 1000) < noise) {
+                    Bit2_put_fast(page, col, row, 1);
+                }
+            }
+        }
+    }
+}
+
+/***********************************************************
+* draw_spiral
+* Description: Draw a spiral path from the top left corner
+* Input: Bit2_T page, all white
+* Output: Void
+* Implementation: Walk right, down, left and up in turn,
+*                 blackening each pixel. The first three legs
+*                 run the full width or height; after that each
+*                 leg is 2 shorter than the last one in the same
+*                 direction but one, which leaves a one pixel
+*                 gap beside the path already drawn. Stop when a
+*                 leg would have no length.
+***********************************************************/
+void draw_spiral(Bit2_T page)
+{
+    int width = Bit2_width(page);
+    int height = Bit2_height(page);
+    int step_col[4] = { 1, 0, -1, 0 };
+    int step_row[4] = { 0, 1, 0, -1 };
+    int legs[2] = { width - 1, height - 1 };
+    int col = 0;
+    int row = 0;
+
+    Bit2_put_fast(page, 0, 0, 1);
+    for (int leg = 0; ; leg++) {
+        int direction = leg % 4;
+        if (leg >= 3) {
+            legs[direction % 2] -= 2;
+        }
+        int length = legs[direction % 2];
+        if (length <= 0) {
+            break;
+        }
+        for (int k = 0; k < length; k++) {
+            col += step_col[direction];
+            row += step_row[direction];
+            Bit2_put_fast(page, col, row, 1);
+        }
+    }
+}
+
+/***********************************************************
+* write_pbm
+* Description: Write a bit array as a raw pbm
+* Input: 1) Bit2_T page
+*        2) File to write to
+* Output: Void
+* Implementation: The P4 header, then each row packed 8
+*                 pixels to a byte, first pixel in the high
+*                 bit, with the last byte of a row padded.
+***********************************************************/
+void write_pbm(Bit2_T page, FILE *out)
+{
+    int width = Bit2_width(page);
+    int height = Bit2_height(page);
+    int row_bytes = (width + 7) / 8;
+    unsigned char *bytes = ALLOC(row_bytes);
+
+    fprintf(out, "P4\n%d %d\n", width, height);
+    for (int row = 0; row < height; row++) {
+        memset(bytes, 0, row_bytes);
+        for (int col = 0; col < width; col++) {
+            if (Bit2_get_fast(page, col, row)) {
+                bytes[col / 8] |= 0x80 >> (col % 8);
+            }
+        }
+        fwrite(bytes, 1, row_bytes, out);
+    }
+    FREE(bytes);
+}
+
+/***********************************************************
+* next_random
+* Description: Step a linear congruential generator
+* Input: Pointer to the seed, updated
+* Output: 15 random bits
+* Implementation: The constants of the C standard's example
+*                 rand, so the pages are the same everywhere.
+***********************************************************/
+unsigned next_random(unsigned *seed)
+{
+    *seed = *seed * 1103515245 + 12345;
+    return (*seed / 65536) % 32768;
+}
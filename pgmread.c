@@ -0,0 +1,172 @@
+/*************************************************************************
+*                              pgmread.c
+*
+*
+*      Authors: Jae Hyun Cheigh (jcheig01), Khanh Nguyen (cnguye10)
+*
+*      Fall 2020 - COMP40
+*      HW 2 - Part B
+*
+*
+*      Summary: This file reads pnm headers and graymap pixels for
+*               sudoku.c. A sudoku is at most a few thousand small
+*               pixels, so setting up a general Pnmrdr_T and calling
+*               Pnmrdr_get for every pixel costs more than the check
+*               itself. Here the pixels go straight from the stream into
+*               the caller's array: plain pixels are parsed with getc,
+*               raw pixels are read with a single fread.
+*
+**************************************************************************/
+
+#include <stdio.h>
+#include <ctype.h>
+#include "pgmread.h"
+
+/* skip whitespace and comments, return the next other character */
+static int skip_space(FILE *fp);
+/* read an unsigned decimal number, returns 0 if there is none */
+static int read_number(FILE *fp, unsigned *number);
+
+/****************************************************************
+ * read_pgm_header
+ * Description: Read the header of a pnm file
+ * Inputs: 1) File pointer fp at the start of the file
+ *         2) Pgm_header to fill in
+ * Output: 1 if a pnm header was read, 0 if not a pnm
+ * Implementation: Check for 'P' and a format digit from 1-6, then
+ *                 read width, height and, unless it is a bitmap,
+ *                 maximum intensity. A raw file has exactly one
+ *                 whitespace character after the header, which is
+ *                 read here so the pixels start right after it. In
+ *                 a plain file a comment may take its place, as it
+ *                 may after any other number of the header.
+ *****************************************************************/
+int read_pgm_header(FILE *fp, Pgm_header *header)
+{
+    int magic = getc(fp);
+    int format = getc(fp);
+
+    if (magic != 'P' || format < '1' || format > '6') {
+        return 0;
+    }
+    header->format = format - '0';
+
+    if (read_number(fp, &header->width) == 0 ||
+        read_number(fp, &header->height) == 0) {
+        return 0;
+    }
+
+    if (header->format == 1 || header->format == 4) {
+        header->maxval = 1;
+    }
+    else if (read_number(fp, &header->maxval) == 0 ||
+             header->maxval == 0 || header->maxval > 65535) {
+        return 0;
+    }
+
+    /*
+     * one whitespace character separates the header from the pixels;
+     * plain pixels are parsed past comments anyway, so there it may
+     * also be a comment, which ends at its newline
+     */
+    int c = getc(fp);
+    if (c == '#' && header->format <= 3) {
+        while (c != '\n' && c != EOF) {
+            c = getc(fp);
+        }
+    }
+    if (!isspace(c)) {
+        return 0;
+    }
+    return 1;
+}
+
+/****************************************************************
+ * read_pgm_pixels
+ * Description: Read the pixels of a graymap into a byte array
+ * Inputs: 1) File pointer fp right after the header
+ *         2) Pgm_header read by read_pgm_header
+ *         3) Array of at least count bytes to hold the pixels
+ *         4) Integer count of pixels to read
+ * Output: 1 on success, 0 if the pixels are malformed or missing
+ * Implementation: Raw pixels are one byte each when maxval is below
+ *                 256, so they are read with one fread. Plain pixels
+ *                 are decimal numbers separated by whitespace.
+ *****************************************************************/
+int read_pgm_pixels(FILE *fp, const Pgm_header *header,
+                    unsigned char *pixels, int count)
+{
+    if (header->maxval > 255) {
+        return 0;
+    }
+
+    if (header->format == 5) {
+        return fread(pixels, 1, count, fp) == (size_t) count;
+    }
+    if (header->format != 2) {
+        return 0;
+    }
+
+    for (int idx = 0; idx < count; idx++) {
+        unsigned pixel;
+        if (read_number(fp, &pixel) == 0) {
+            return 0;
+        }
+        pixels[idx] = (unsigned char) (pixel > 255 ? 255 : pixel);
+    }
+    return 1;
+}
+
+/****************************************************************
+ * skip_space
+ * Description: Skip whitespace and comments
+ * Inputs: File pointer fp
+ * Output: Integer next character that is neither, or EOF
+ * Implementation: A comment runs from '#' to the end of the line.
+ *****************************************************************/
+static int skip_space(FILE *fp)
+{
+    int c = getc(fp);
+
+    while (isspace(c) || c == '#') {
+        if (c == '#') {
+            while (c != '\n' && c != EOF) {
+                c = getc(fp);
+            }
+        }
+        c = getc(fp);
+    }
+    return c;
+}
+
+/****************************************************************
+ * read_number
+ * Description: Read an unsigned decimal number
+ * Inputs: 1) File pointer fp
+ *         2) Unsigned pointer to store the number in
+ * Output: 1 if a number was read, 0 if the next thing is not one
+ * Implementation: Skip whitespace and comments, then read digits
+ *                 and put back the character that ends the number
+ *                 so the caller sees the separator. Numbers too big
+ *                 for the header limits saturate instead of
+ *                 overflowing.
+ *****************************************************************/
+static int read_number(FILE *fp, unsigned *number)
+{
+    int c = skip_space(fp);
+    if (!isdigit(c)) {
+        return 0;
+    }
+
+    unsigned value = 0;
+    while (isdigit(c)) {
+        if (value < 100000) {
+            value = value * 10 + (unsigned) (c - '0');
+        }
+        c = getc(fp);
+    }
+    ungetc(c, fp);
+
+    *number = value;
+    return 1;
+}
@@ -0,0 +1,51 @@
+/*************************************************************************
+*                              pgmread.h
+*
+*
+*      Authors: Jae Hyun Cheigh (jcheig01), Khanh Nguyen (cnguye10)
+*
+*      Fall 2020 - COMP40
+*      HW 2 - Part B
+*
+*
+*      Summary: This is the header file for pgmread.c, a small reader
+*               that sudoku.c uses instead of Pnmrdr_T. It reads a pnm
+*               header and then the pixels of a plain (P2) or raw (P5)
+*               graymap straight into a caller's byte array, without
+*               allocating anything.
+**************************************************************************/
+
+#ifndef PGMREAD_INCLUDED
+#define PGMREAD_INCLUDED
+
+#include <stdio.h>
+
+/*
+ * header of a pnm file. format is the digit after the 'P': 1/4 for
+ * bitmaps, 2/5 for graymaps and 3/6 for pixmaps, plain then raw.
+ * maxval is 1 for bitmaps, which have none in the file.
+ */
+typedef struct Pgm_header {
+    int format;
+    unsigned width;
+    unsigned height;
+    unsigned maxval;
+} Pgm_header;
+
+/*
+ * reads the magic number, width, height and (except for bitmaps)
+ * maximum intensity, skipping whitespace and comments. Returns 1 if
+ * the header was read and 0 if the input is not a pnm.
+ */
+int read_pgm_header(FILE *fp, Pgm_header *header);
+
+/*
+ * reads count pixels of a P2 or P5 graymap whose header was just read,
+ * with maxval below 256, into pixels. A plain pixel too large for a
+ * byte is stored as 255. Returns 1 on success and 0 if the pixels are
+ * malformed or the file ends early.
+ */
+int read_pgm_pixels(FILE *fp, const Pgm_header *header,
+                    unsigned char *pixels, int count);
+
+#endif
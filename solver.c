@@ -0,0 +1,752 @@
+/*************************************************************************
+*                              solver.c
+*
+*
+*      Authors: Jae Hyun Cheigh (jcheig01), Khanh Nguyen (cnguye10)
+*
+*      Fall 2020 - COMP40
+*      HW 2 - Part B
+*
+*
+*      Summary: This is the helper file for sudoku.c that counts the
+*               solutions of a sudoku with n x n submaps, n up to
+*               MAX_BOX. Every row, column and submap keeps the digits
+*               it already uses as bits of one 64-bit mask, so the
+*               candidates of a cell are found with a few bitwise
+*               operations whatever the size of the grid. The search
+*               always branches on the empty cell with the fewest
+*               candidates and stops once it has found as many
+*               solutions as the caller asked for.
+*
+*               The parallel search expands the top levels of the search
+*               tree into tasks. Every thread keeps its own deque of
+*               tasks, works from the bottom of it, and steals from the
+*               top of another thread's deque when its own runs dry.
+*               All threads add to one solution count, so they all stop
+*               once the limit is reached. A thread with nothing to
+*               steal sleeps on a condition variable until more tasks
+*               are pushed or the search is over.
+*
+**************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "solver.h"
+#include "uarray2_inline.h"
+#include "assert.h"
+
+/* tree levels expanded into tasks by the parallel search */
+#define SPLIT_DEPTH 6
+
+/*
+ * size of the sudoku and, for every cell, the masks of its row, column
+ * and submap as indices into Board's masks (rows first, then columns,
+ * then submaps). Built once and shared by every board of a search.
+ */
+typedef struct Shape {
+    int box;
+    int dim;
+    int cells;
+    uint64_t all;
+    uint16_t *row_of;
+    uint16_t *col_of;
+    uint16_t *box_of;
+} Shape;
+
+/*
+ * state of the search: the digits used by every row/column/submap
+ * (digit d is bit d - 1), the indices of the cells still empty, and
+ * the digit in every cell, all in one block so a board is copied with
+ * one memcpy of bytes. depth is how many cells were filled by the
+ * search, which the parallel search uses to decide when to split.
+ */
+typedef struct Board {
+    const Shape *shape;
+    size_t bytes;
+    int num_empty;
+    int depth;
+    uint64_t masks[];
+} Board;
+
+/* parts of a board's block after the masks */
+#define EMPTY(board) ((uint16_t *) ((board)->masks + \
+                                    3 * (board)->shape->dim))
+#define CELL(board) ((uint8_t *) (EMPTY(board) + (board)->shape->cells))
+
+/*
+ * solution count shared by everyone searching the same puzzle, and
+ * how many solutions to look for before giving up on the search
+ */
+typedef struct Search {
+    int found;
+    int limit;
+} Search;
+
+/* tasks of one thread, a ring buffer with first as the top */
+typedef struct Deque {
+    pthread_mutex_t lock;
+    Board **tasks;
+    int first;
+    int count;
+    int capacity;
+} Deque;
+
+/*
+ * data shared by the threads of the parallel search. pushes counts the
+ * times tasks were pushed, so a thread that saw no task can tell if any
+ * came since; idle threads wait on wake, and pushes and idle are only
+ * changed with idle_lock held.
+ */
+typedef struct Pool {
+    Search search;
+    Deque *deques;
+    int num_threads;
+    int pending;
+    pthread_mutex_t idle_lock;
+    pthread_cond_t wake;
+    unsigned pushes;
+    int idle;
+} Pool;
+
+/* what every thread of the parallel search is started with */
+typedef struct Worker {
+    Pool *pool;
+    int id;
+} Worker;
+
+/* build the shape of a grid, freed with free_shape */
+static void new_shape(Shape *shape, int width);
+static void free_shape(Shape *shape);
+/* board from grid, NULL if the givens conflict */
+static Board *load_board(const Shape *shape, UArray2_T grid);
+/* place a digit in a cell, returns 0 if the digit is already used */
+static int place(Board *board, int cell, int digit);
+/* take the digit of a cell back out of its row/column/submap */
+static void unplace(Board *board, int cell);
+/* digits that can still go in a cell, as a mask */
+static uint64_t candidates(Board *board, int cell);
+/* empty cell with the fewest candidates, returns how many it has */
+static int choose_cell(Board *board, int *best, uint64_t *mask);
+/* recursive search adding every solution to the shared count */
+static void search(Board *board, Search *shared);
+/* thread body of the parallel search */
+static void *work(void *cl);
+/* explore one task, either by splitting it or by searching it */
+static void run_task(Pool *pool, Deque *own, Board *task);
+/* sleep until a task is pushed after pushes was seen, or the end */
+static int wait_for_tasks(Pool *pool, unsigned seen);
+/* wake the idle threads, counting a push first if pushed is nonzero */
+static void wake_idle(Pool *pool, int pushed);
+/* deque operations, each takes the lock of the deque */
+static void deque_push(Deque *deque, Board *task);
+static Board *deque_pop(Deque *deque);
+static Board *deque_steal(Deque *deque);
+
+/****************************************************************
+ * count_solutions
+ * Description: Count solutions of a sudoku, up to limit
+ * Inputs: 1) UArray2_T grid of ints, 0 for empty and 1-n*n for givens
+ *         2) Integer limit which is how many solutions to look for
+ * Output: Integer number of solutions found, at most limit
+ * Implementation: Load the board and run the backtracking search
+ *                 on this thread.
+ *****************************************************************/
+int count_solutions(UArray2_T grid, int limit)
+{
+    assert(grid != NULL);
+    assert(limit > 0);
+
+    Shape shape;
+    new_shape(&shape, UArray2_width(grid));
+    Board *board = load_board(&shape, grid);
+
+    Search shared = { 0, limit };
+    if (board != NULL) {
+        search(board, &shared);
+        free(board);
+    }
+
+    free_shape(&shape);
+    return shared.found;
+}
+
+/****************************************************************
+ * count_solutions_parallel
+ * Description: Count solutions of a sudoku, up to limit, using
+ *              several threads
+ * Inputs: 1) UArray2_T grid of ints, 0 for empty and 1-n*n for givens
+ *         2) Integer limit which is how many solutions to look for
+ *         3) Integer number of threads, 0 for one per online CPU
+ * Output: Integer number of solutions found, at most limit
+ * Implementation: Put the whole puzzle as one task on the deque of
+ *                 the first thread, start the threads, and wait for
+ *                 all of them. pending counts tasks that are queued
+ *                 or running, so a thread that finds nothing to
+ *                 steal while pending is 0 knows the search is over.
+ *                 Threads that find nothing while tasks are still
+ *                 running sleep on pool.wake.
+ *****************************************************************/
+int count_solutions_parallel(UArray2_T grid, int limit, int num_threads)
+{
+    assert(grid != NULL);
+    assert(limit > 0);
+    assert(num_threads >= 0);
+
+    if (num_threads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        num_threads = cpus > 0 ? (int) cpus : 1;
+    }
+
+    Shape shape;
+    new_shape(&shape, UArray2_width(grid));
+    Board *root = load_board(&shape, grid);
+    if (root == NULL) {
+        free_shape(&shape);
+        return 0;
+    }
+
+    Pool pool;
+    pool.search.found = 0;
+    pool.search.limit = limit;
+    pool.num_threads = num_threads;
+    pool.pending = 1;
+    pthread_mutex_init(&pool.idle_lock, NULL);
+    pthread_cond_init(&pool.wake, NULL);
+    pool.pushes = 0;
+    pool.idle = 0;
+    pool.deques = malloc(num_threads * sizeof(Deque));
+    Worker *workers = malloc(num_threads * sizeof(Worker));
+    pthread_t *threads = malloc(num_threads * sizeof(pthread_t));
+    assert(pool.deques != NULL && workers != NULL && threads != NULL);
+
+    for (int idx = 0; idx < num_threads; idx++) {
+        pthread_mutex_init(&pool.deques[idx].lock, NULL);
+        pool.deques[idx].tasks = NULL;
+        pool.deques[idx].first = 0;
+        pool.deques[idx].count = 0;
+        pool.deques[idx].capacity = 0;
+        workers[idx].pool = &pool;
+        workers[idx].id = idx;
+    }
+    deque_push(&pool.deques[0], root);
+
+    for (int idx = 1; idx < num_threads; idx++) {
+        if (pthread_create(&threads[idx], NULL, work, &workers[idx]) != 0) {
+            fprintf(stderr, "Could not start thread\n");
+            exit(1);
+        }
+    }
+    work(&workers[0]);
+    for (int idx = 1; idx < num_threads; idx++) {
+        pthread_join(threads[idx], NULL);
+    }
+
+    for (int idx = 0; idx < num_threads; idx++) {
+        pthread_mutex_destroy(&pool.deques[idx].lock);
+        free(pool.deques[idx].tasks);
+    }
+    pthread_cond_destroy(&pool.wake);
+    pthread_mutex_destroy(&pool.idle_lock);
+    free(pool.deques);
+    free(workers);
+    free(threads);
+    free_shape(&shape);
+
+    /* threads finishing together can overshoot the limit */
+    return pool.search.found < limit ? pool.search.found : limit;
+}
+
+/****************************************************************
+ * new_shape
+ * Description: Work out the shape of a sudoku from its width
+ * Inputs: 1) Shape to fill in
+ *         2) Integer width of the grid, which must be n*n with n
+ *            between 1 and MAX_BOX
+ * Output: Void
+ * Implementation: Find n, then give every cell the indices of the
+ *                 masks of its row, column and submap, so the search
+ *                 never divides to find them.
+ *****************************************************************/
+static void new_shape(Shape *shape, int width)
+{
+    int box = 1;
+    while (box * box < width) {
+        box++;
+    }
+    assert(box * box == width && box <= MAX_BOX);
+
+    shape->box = box;
+    shape->dim = width;
+    shape->cells = width * width;
+    shape->all = width == 64 ? ~(uint64_t) 0 : ((uint64_t) 1 << width) - 1;
+    shape->row_of = malloc(shape->cells * sizeof(uint16_t));
+    shape->col_of = malloc(shape->cells * sizeof(uint16_t));
+    shape->box_of = malloc(shape->cells * sizeof(uint16_t));
+    assert(shape->row_of != NULL && shape->col_of != NULL &&
+           shape->box_of != NULL);
+
+    for (int cell = 0; cell < shape->cells; cell++) {
+        int row = cell / width;
+        int col = cell % width;
+        shape->row_of[cell] = (uint16_t) row;
+        shape->col_of[cell] = (uint16_t) (width + col);
+        shape->box_of[cell] = (uint16_t) (2 * width +
+                                          (row / box) * box + col / box);
+    }
+}
+
+/****************************************************************
+ * free_shape
+ * Description: Deallocate the tables of a shape
+ * Inputs: Shape made by new_shape
+ * Output: Void
+ *****************************************************************/
+static void free_shape(Shape *shape)
+{
+    free(shape->row_of);
+    free(shape->col_of);
+    free(shape->box_of);
+}
+
+/****************************************************************
+ * load_board
+ * Description: Set up the search state from a sudoku grid
+ * Inputs: 1) Shape of the grid
+ *         2) UArray2_T grid of ints, 0 for empty and 1-n*n for givens
+ * Output: Board to search, NULL if two givens conflict
+ * Implementation: Allocate the board block, build the masks from
+ *                 the givens (a given that is already used in its
+ *                 row/column/submap means there is no solution) and
+ *                 collect the empty cells.
+ *****************************************************************/
+static Board *load_board(const Shape *shape, UArray2_T grid)
+{
+    int dim = shape->dim;
+    assert(UArray2_width(grid) == dim && UArray2_height(grid) == dim);
+
+    size_t bytes = sizeof(Board) + 3 * dim * sizeof(uint64_t) +
+                   shape->cells * (sizeof(uint16_t) + sizeof(uint8_t));
+    Board *board = malloc(bytes);
+    assert(board != NULL);
+    board->shape = shape;
+    board->bytes = bytes;
+    board->num_empty = 0;
+    board->depth = 0;
+    for (int idx = 0; idx < 3 * dim; idx++) {
+        board->masks[idx] = 0;
+    }
+
+    for (int j = 0; j < dim; j++) {
+        for (int i = 0; i < dim; i++) {
+            int cell = j * dim + i;
+            int digit = *(int *) UArray2_at_fast(grid, i, j);
+
+            assert(digit >= 0 && digit <= dim);
+            CELL(board)[cell] = 0;
+            if (digit == 0) {
+                EMPTY(board)[board->num_empty++] = (uint16_t) cell;
+            }
+            else if (place(board, cell, digit) == 0) {
+                free(board);
+                return NULL;
+            }
+        }
+    }
+    return board;
+}
+
+/****************************************************************
+ * place
+ * Description: Put a digit in a cell of the board
+ * Inputs: 1) Board being searched
+ *         2) Integer index of the cell (row * width + column)
+ *         3) Integer digit from 1 to width
+ * Output: 1 if the digit was placed, 0 if it was already used in
+ *         the row, column or submap of the cell
+ * Implementation: Check the bit of the digit in all three masks,
+ *                 then set it in all of them.
+ *****************************************************************/
+static int place(Board *board, int cell, int digit)
+{
+    const Shape *shape = board->shape;
+    uint64_t *masks = board->masks;
+    uint64_t bit = (uint64_t) 1 << (digit - 1);
+    int row = shape->row_of[cell];
+    int col = shape->col_of[cell];
+    int box = shape->box_of[cell];
+
+    if ((masks[row] | masks[col] | masks[box]) & bit) {
+        return 0;
+    }
+    masks[row] |= bit;
+    masks[col] |= bit;
+    masks[box] |= bit;
+    CELL(board)[cell] = (uint8_t) digit;
+    return 1;
+}
+
+/****************************************************************
+ * unplace
+ * Description: Empty a cell of the board
+ * Inputs: 1) Board being searched
+ *         2) Integer index of the cell (row * width + column)
+ * Output: Void
+ * Implementation: Clear the bit of the cell's digit in the masks
+ *                 of its row, column and submap.
+ *****************************************************************/
+static void unplace(Board *board, int cell)
+{
+    const Shape *shape = board->shape;
+    uint64_t *masks = board->masks;
+    uint64_t bit = (uint64_t) 1 << (CELL(board)[cell] - 1);
+
+    masks[shape->row_of[cell]] &= ~bit;
+    masks[shape->col_of[cell]] &= ~bit;
+    masks[shape->box_of[cell]] &= ~bit;
+    CELL(board)[cell] = 0;
+}
+
+/****************************************************************
+ * candidates
+ * Description: Get the digits that can still go in a cell
+ * Inputs: 1) Board being searched
+ *         2) Integer index of the cell (row * width + column)
+ * Output: Mask with bit d - 1 set if digit d is still possible
+ * Implementation: Digits not used by the row, column or submap.
+ *****************************************************************/
+static uint64_t candidates(Board *board, int cell)
+{
+    const Shape *shape = board->shape;
+    uint64_t *masks = board->masks;
+
+    return ~(masks[shape->row_of[cell]] | masks[shape->col_of[cell]] |
+             masks[shape->box_of[cell]]) & shape->all;
+}
+
+/****************************************************************
+ * choose_cell
+ * Description: Find the empty cell to branch on
+ * Inputs: 1) Board being searched, with at least one empty cell
+ *         2) Integer pointer set to the position of the cell in
+ *            the empty list
+ *         3) Mask pointer set to the candidates of the cell
+ * Output: Integer number of candidates of the chosen cell
+ * Implementation: Pick the empty cell with the fewest candidates.
+ *                 A cell with none means a dead end and a cell with
+ *                 one is taken right away, so stop looking at those.
+ *****************************************************************/
+static int choose_cell(Board *board, int *best, uint64_t *mask)
+{
+    uint16_t *empty = EMPTY(board);
+    int best_count = board->shape->dim + 1;
+
+    for (int idx = 0; idx < board->num_empty; idx++) {
+        uint64_t cand = candidates(board, empty[idx]);
+        int count = __builtin_popcountll(cand);
+        if (count < best_count) {
+            *best = idx;
+            *mask = cand;
+            best_count = count;
+            if (count <= 1) {
+                break;
+            }
+        }
+    }
+    return best_count;
+}
+
+/****************************************************************
+ * search
+ * Description: Backtracking search for solutions of the board
+ * Inputs: 1) Board being searched
+ *         2) Search holding the solution count and limit, which
+ *            may be shared with other threads
+ * Output: Void
+ * Implementation: Stop if the limit has been reached, by this or
+ *                 any other thread. A board with no empty cells is
+ *                 one more solution. Otherwise move the chosen cell
+ *                 to the end of the empty list and try each of its
+ *                 candidates in turn on the remaining empty cells.
+ *****************************************************************/
+static void search(Board *board, Search *shared)
+{
+    if (__atomic_load_n(&shared->found, __ATOMIC_RELAXED) >= shared->limit) {
+        return;
+    }
+
+    int n = board->num_empty;
+    if (n == 0) {
+        __atomic_add_fetch(&shared->found, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    int best = 0;
+    uint64_t mask = 0;
+    if (choose_cell(board, &best, &mask) == 0) {
+        return;
+    }
+
+    /* swap chosen cell to the end so the rest stay contiguous */
+    uint16_t *empty = EMPTY(board);
+    uint16_t cell = empty[best];
+    empty[best] = empty[n - 1];
+    empty[n - 1] = cell;
+    board->num_empty = n - 1;
+
+    while (mask != 0) {
+        int digit = __builtin_ctzll(mask) + 1;
+        mask &= mask - 1;
+
+        place(board, cell, digit);
+        search(board, shared);
+        unplace(board, cell);
+    }
+
+    board->num_empty = n;
+    empty[n - 1] = empty[best];
+    empty[best] = cell;
+}
+
+/****************************************************************
+ * work
+ * Description: Body of every thread of the parallel search
+ * Inputs: Void pointer to the Worker of this thread
+ * Output: NULL
+ * Implementation: Take tasks from the bottom of our own deque, or
+ *                 steal from the top of the other deques, starting
+ *                 with our neighbor. When there is nothing to take,
+ *                 sleep until more tasks are pushed, and stop once
+ *                 no task is pending anywhere or the limit is
+ *                 reached. The push count is read before looking,
+ *                 so a push made while we look is not missed. The
+ *                 thread that ends the last pending task wakes the
+ *                 others so they can stop.
+ *****************************************************************/
+static void *work(void *cl)
+{
+    Worker *self = (Worker *) cl;
+    Pool *pool = self->pool;
+    Deque *own = &pool->deques[self->id];
+
+    for (;;) {
+        unsigned seen = __atomic_load_n(&pool->pushes, __ATOMIC_ACQUIRE);
+        Board *task = deque_pop(own);
+        for (int idx = 1; task == NULL && idx < pool->num_threads; idx++) {
+            int victim = (self->id + idx) % pool->num_threads;
+            task = deque_steal(&pool->deques[victim]);
+        }
+
+        if (task == NULL) {
+            if (!wait_for_tasks(pool, seen)) {
+                return NULL;
+            }
+            continue;
+        }
+
+        run_task(pool, own, task);
+        free(task);
+        if (__atomic_sub_fetch(&pool->pending, 1, __ATOMIC_ACQ_REL) == 0) {
+            wake_idle(pool, 0);
+        }
+    }
+}
+
+/****************************************************************
+ * wait_for_tasks
+ * Description: Sleep until there may be a task to take
+ * Inputs: 1) Pool of the parallel search
+ *         2) Push count read before the deques were found empty
+ * Output: 1 if tasks were pushed since, 0 if the search is over
+ * Implementation: Wait on pool->wake while no push was counted,
+ *                 tasks are pending and the limit is not reached;
+ *                 whoever changes one of those wakes us holding
+ *                 idle_lock, so the wake cannot come between the
+ *                 check and the wait. Once the limit is reached the
+ *                 tasks left are only dropped, by the threads whose
+ *                 deques hold them, so idle threads may stop.
+ *****************************************************************/
+static int wait_for_tasks(Pool *pool, unsigned seen)
+{
+    Search *shared = &pool->search;
+    int more;
+
+    pthread_mutex_lock(&pool->idle_lock);
+    pool->idle++;
+    for (;;) {
+        more = __atomic_load_n(&pool->pending, __ATOMIC_ACQUIRE) != 0 &&
+               __atomic_load_n(&shared->found, __ATOMIC_RELAXED) <
+               shared->limit;
+        if (!more || pool->pushes != seen) {
+            break;
+        }
+        pthread_cond_wait(&pool->wake, &pool->idle_lock);
+    }
+    pool->idle--;
+    pthread_mutex_unlock(&pool->idle_lock);
+    return more;
+}
+
+/****************************************************************
+ * wake_idle
+ * Description: Wake the threads waiting for tasks
+ * Inputs: 1) Pool of the parallel search
+ *         2) Nonzero if tasks were just pushed
+ * Output: Void
+ * Implementation: Count the push and broadcast under idle_lock,
+ *                 skipping the broadcast when no thread is idle.
+ *****************************************************************/
+static void wake_idle(Pool *pool, int pushed)
+{
+    pthread_mutex_lock(&pool->idle_lock);
+    if (pushed) {
+        __atomic_add_fetch(&pool->pushes, 1, __ATOMIC_RELEASE);
+    }
+    if (pool->idle > 0) {
+        pthread_cond_broadcast(&pool->wake);
+    }
+    pthread_mutex_unlock(&pool->idle_lock);
+}
+
+/****************************************************************
+ * run_task
+ * Description: Explore the subtree of one task
+ * Inputs: 1) Pool of the parallel search
+ *         2) Deque of the thread running the task
+ *         3) Task to explore
+ * Output: Void
+ * Implementation: Tasks in the top SPLIT_DEPTH levels are split
+ *                 into one task per candidate of the chosen cell,
+ *                 pushed on our own deque where idle threads can
+ *                 steal them, and the idle threads are woken once
+ *                 all are pushed. Deeper tasks are searched
+ *                 directly. Once the limit is reached, tasks are
+ *                 dropped, and the search that reaches it wakes the
+ *                 idle threads so they can stop.
+ *****************************************************************/
+static void run_task(Pool *pool, Deque *own, Board *task)
+{
+    if (__atomic_load_n(&pool->search.found, __ATOMIC_RELAXED) >=
+        pool->search.limit) {
+        return;
+    }
+    if (task->depth >= SPLIT_DEPTH || task->num_empty == 0) {
+        search(task, &pool->search);
+        if (__atomic_load_n(&pool->search.found, __ATOMIC_RELAXED) >=
+            pool->search.limit) {
+            wake_idle(pool, 0);
+        }
+        return;
+    }
+
+    int best = 0;
+    uint64_t mask = 0;
+    if (choose_cell(task, &best, &mask) == 0) {
+        return;
+    }
+
+    int n = task->num_empty;
+    uint16_t *empty = EMPTY(task);
+    uint16_t cell = empty[best];
+    empty[best] = empty[n - 1];
+    empty[n - 1] = cell;
+    task->num_empty = n - 1;
+
+    while (mask != 0) {
+        int digit = __builtin_ctzll(mask) + 1;
+        mask &= mask - 1;
+
+        Board *child = malloc(task->bytes);
+        assert(child != NULL);
+        memcpy(child, task, task->bytes);
+        place(child, cell, digit);
+        child->depth = task->depth + 1;
+
+        __atomic_add_fetch(&pool->pending, 1, __ATOMIC_ACQ_REL);
+        deque_push(own, child);
+    }
+    wake_idle(pool, 1);
+}
+
+/****************************************************************
+ * deque_push
+ * Description: Push a task on the bottom of a deque
+ * Inputs: 1) Deque of the thread that made the task
+ *         2) Task to push
+ * Output: Void
+ * Implementation: Double the ring buffer when it is full, copying
+ *                 the tasks so that the top ends up at index 0.
+ *****************************************************************/
+static void deque_push(Deque *deque, Board *task)
+{
+    pthread_mutex_lock(&deque->lock);
+
+    if (deque->count == deque->capacity) {
+        int capacity = deque->capacity == 0 ? 64 : 2 * deque->capacity;
+        Board **tasks = malloc(capacity * sizeof(Board *));
+        assert(tasks != NULL);
+        for (int idx = 0; idx < deque->count; idx++) {
+            tasks[idx] = deque->tasks[(deque->first + idx) %
+                                      deque->capacity];
+        }
+        free(deque->tasks);
+        deque->tasks = tasks;
+        deque->first = 0;
+        deque->capacity = capacity;
+    }
+    deque->tasks[(deque->first + deque->count) % deque->capacity] = task;
+    deque->count++;
+
+    pthread_mutex_unlock(&deque->lock);
+}
+
+/****************************************************************
+ * deque_pop
+ * Description: Pop the newest task off the bottom of a deque
+ * Inputs: Deque of the calling thread
+ * Output: Board of the task, or NULL if the deque is empty
+ * Implementation: Newest tasks are the deepest, smallest subtrees,
+ *                 which keeps the owner working depth first.
+ *****************************************************************/
+static Board *deque_pop(Deque *deque)
+{
+    Board *task = NULL;
+
+    pthread_mutex_lock(&deque->lock);
+    if (deque->count > 0) {
+        deque->count--;
+        task = deque->tasks[(deque->first + deque->count) %
+                            deque->capacity];
+    }
+    pthread_mutex_unlock(&deque->lock);
+
+    return task;
+}
+
+/****************************************************************
+ * deque_steal
+ * Description: Steal the oldest task off the top of a deque
+ * Inputs: Deque of another thread
+ * Output: Board of the task, or NULL if the deque is empty
+ * Implementation: Oldest tasks are the shallowest, largest subtrees,
+ *                 so one steal hands the thief plenty of work.
+ *****************************************************************/
+static Board *deque_steal(Deque *deque)
+{
+    Board *task = NULL;
+
+    pthread_mutex_lock(&deque->lock);
+    if (deque->count > 0) {
+        task = deque->tasks[deque->first];
+        deque->first = (deque->first + 1) % deque->capacity;
+        deque->count--;
+    }
+    pthread_mutex_unlock(&deque->lock);
+
+    return task;
+}
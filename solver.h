@@ -0,0 +1,44 @@
+/*************************************************************************
+*                              solver.h
+*
+*
+*      Authors: Jae Hyun Cheigh (jcheig01), Khanh Nguyen (cnguye10)
+*
+*      Fall 2020 - COMP40
+*      HW 2 - Part B
+*
+*
+*      Summary: This is the header file for solver.c. This file
+*               declares the backtracking search that sudoku.c uses to
+*               count the solutions of a partially filled sudoku, on one
+*               thread or on several.
+**************************************************************************/
+
+#ifndef SOLVER_INCLUDED
+#define SOLVER_INCLUDED
+
+#include "uarray2.h"
+
+/*
+ * largest submap size n, so the largest sudoku is 64x64. The digits
+ * used by a row, column or submap must fit in one 64-bit mask.
+ */
+#define MAX_BOX 8
+
+/*
+ * counts the solutions of an n*n by n*n sudoku (n x n submaps) held in
+ * an unboxed array of ints, where 0 marks an empty cell and 1 to n*n
+ * are given digits. The search stops as soon as limit solutions have
+ * been found, so the result is never greater than limit. Givens that
+ * already conflict with each other count as 0 solutions.
+ */
+int count_solutions(UArray2_T grid, int limit);
+
+/*
+ * same as count_solutions, but the search is shared by num_threads
+ * threads (0 for one per online CPU) that steal subtrees from each
+ * other. Every thread stops as soon as the limit is reached.
+ */
+int count_solutions_parallel(UArray2_T grid, int limit, int num_threads);
+
+#endif
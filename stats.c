@@ -0,0 +1,224 @@
+/*************************************************************************
+*                              stats.c
+*
+*
+*      Authors: Jae Hyun Cheigh (jcheig01), Khanh Nguyen (cnguye10)
+*
+*      Fall 2020 - COMP40
+*      HW 2 - Part D
+*
+*
+*      Summary: This file implements Stats_T, the statistics of one run
+*               of a tool. Phases and counts are kept in small fixed
+*               arrays in the order they first appear, with their names
+*               pointing at the caller's strings, which are literals.
+*               Phases are timed on the monotonic clock, and the peak
+*               resident set size comes from getrusage when printed.
+*
+**************************************************************************/
+
+/* getrusage is XSI */
+#define _XOPEN_SOURCE 700
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+#include "stats.h"
+#include "assert.h"
+#include "mem.h"
+
+#define T Stats_T
+
+/* more phases or counts than any tool has */
+#define MAX_ENTRIES 16
+
+/* a phase and its total time, or a count */
+typedef struct Entry {
+    const char *name;
+    double seconds;
+    uint64_t value;
+} Entry;
+
+/* data that our statistics hold; running is the index of the phase
+   being timed, started at start, or -1 */
+struct T {
+    const char *program;
+    int json;
+    int num_phases;
+    int num_counts;
+    Entry phases[MAX_ENTRIES];
+    Entry counts[MAX_ENTRIES];
+    int running;
+    struct timespec start;
+};
+
+/* index of the entry with the name, adding it if there is none */
+static int find_entry(Entry *entries, int *length, const char *name);
+
+/****************************************************************
+ * Stats_new
+ * Description: Make the statistics of one run
+ * Inputs: 1) Name of the program, to print
+ *         2) Integer, nonzero to print JSON
+ * Output: New Stats_T, with no phase running
+ *****************************************************************/
+T Stats_new(const char *program, int json)
+{
+    assert(program != NULL);
+
+    T stats;
+    NEW(stats);
+    stats->program = program;
+    stats->json = json;
+    stats->num_phases = 0;
+    stats->num_counts = 0;
+    stats->running = -1;
+    return stats;
+}
+
+/****************************************************************
+ * Stats_phase
+ * Description: Switch to another phase
+ * Inputs: 1) Stats_T, or NULL to do nothing
+ *         2) Name of the next phase, or NULL for none
+ * Output: Void
+ * Implementation: Add the time since the running phase started to
+ *                 it, then start the next one. Standard output is
+ *                 flushed first, so output buffered in one phase is
+ *                 not written, and timed, in a later one.
+ *****************************************************************/
+void Stats_phase(T stats, const char *phase)
+{
+    if (stats == NULL) {
+        return;
+    }
+
+    fflush(stdout);
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if (stats->running >= 0) {
+        stats->phases[stats->running].seconds +=
+            (now.tv_sec - stats->start.tv_sec) +
+            (now.tv_nsec - stats->start.tv_nsec) / 1e9;
+    }
+
+    stats->running = -1;
+    if (phase != NULL) {
+        stats->running = find_entry(stats->phases, &stats->num_phases,
+                                    phase);
+        stats->start = now;
+    }
+}
+
+/****************************************************************
+ * Stats_count
+ * Description: Record a count
+ * Inputs: 1) Stats_T, or NULL to do nothing
+ *         2) Name of the count
+ *         3) Its value
+ * Output: Void
+ *****************************************************************/
+void Stats_count(T stats, const char *name, uint64_t value)
+{
+    if (stats == NULL) {
+        return;
+    }
+
+    int index = find_entry(stats->counts, &stats->num_counts, name);
+    stats->counts[index].value = value;
+}
+
+/****************************************************************
+ * Stats_print
+ * Description: Print the statistics
+ * Inputs: 1) Stats_T, or NULL to do nothing
+ *         2) File to print to, standard error for the tools
+ * Output: Void
+ * Implementation: As text, a line per phase in milliseconds, then
+ *                 a line per count and the peak RSS; as JSON, one
+ *                 object with the phases in a "phases_ms" object
+ *                 and the counts beside it. ru_maxrss is in
+ *                 kilobytes on Linux.
+ *****************************************************************/
+void Stats_print(T stats, FILE *out)
+{
+    if (stats == NULL) {
+        return;
+    }
+
+    Stats_phase(stats, NULL);
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    long peak_rss = usage.ru_maxrss;
+
+    if (stats->json) {
+        fprintf(out, "{\"program\": \"%s\", \"phases_ms\": {",
+                stats->program);
+        for (int p = 0; p < stats->num_phases; p++) {
+            fprintf(out, "%s\"%s\": %.3f", p == 0 ? "" : ", ",
+                    stats->phases[p].name, stats->phases[p].seconds * 1e3);
+        }
+        fprintf(out, "}");
+        for (int c = 0; c < stats->num_counts; c++) {
+            fprintf(out, ", \"%s\": %llu", stats->counts[c].name,
+                    (unsigned long long) stats->counts[c].value);
+        }
+        fprintf(out, ", \"peak_rss_kb\": %ld}\n", peak_rss);
+        return;
+    }
+
+    fprintf(out, "%s stats\n", stats->program);
+    for (int p = 0; p < stats->num_phases; p++) {
+        fprintf(out, "  %-20s %12.3f ms\n", stats->phases[p].name,
+                stats->phases[p].seconds * 1e3);
+    }
+    for (int c = 0; c < stats->num_counts; c++) {
+        fprintf(out, "  %-20s %12llu\n", stats->counts[c].name,
+                (unsigned long long) stats->counts[c].value);
+    }
+    fprintf(out, "  %-20s %12ld kB\n", "peak_rss", peak_rss);
+}
+
+/****************************************************************
+ * Stats_free
+ * Description: Free the statistics
+ * Inputs: Pointer to a Stats_T; NULL inside does nothing
+ * Output: Void
+ *****************************************************************/
+void Stats_free(T *stats)
+{
+    assert(stats != NULL);
+    if (*stats != NULL) {
+        FREE(*stats);
+    }
+}
+
+/****************************************************************
+ * find_entry
+ * Description: Find an entry by name
+ * Inputs: 1) Array of MAX_ENTRIES entries
+ *         2) Pointer to the number in use, updated
+ *         3) Name to find
+ * Output: Integer index of the entry
+ * Implementation: Linear search, since there are a handful. A new
+ *                 entry starts at zero; more than MAX_ENTRIES names
+ *                 exit with assert.
+ *****************************************************************/
+static int find_entry(Entry *entries, int *length, const char *name)
+{
+    for (int index = 0; index < *length; index++) {
+        if (strcmp(entries[index].name, name) == 0) {
+            return index;
+        }
+    }
+
+    assert(*length < MAX_ENTRIES);
+    Entry *entry = &entries[(*length)++];
+    entry->name = name;
+    entry->seconds = 0;
+    entry->value = 0;
+    return *length - 1;
+}
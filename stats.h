@@ -0,0 +1,52 @@
+/*************************************************************************
+*                              stats.h
+*
+*
+*      Authors: Jae Hyun Cheigh (jcheig01), Khanh Nguyen (cnguye10)
+*
+*      Fall 2020 - COMP40
+*      HW 2 - Part D
+*
+*
+*      Summary: This is the header file for stats.c, which collects what
+*               unblackedges --stats and sudoku --stats report: the wall
+*               time of each phase of a run, named counts, and the peak
+*               resident set size, printed to standard error as text or
+*               as one line of JSON. A NULL Stats_T is a run without
+*               --stats, and every function does nothing with it, so
+*               callers need not check.
+**************************************************************************/
+
+#ifndef STATS_INCLUDED
+#define STATS_INCLUDED
+
+#include <stdio.h>
+#include <stdint.h>
+
+#define T Stats_T
+typedef struct T *T;
+
+/*
+ * makes the statistics of one run of program, printed as JSON if json
+ * is nonzero and as text otherwise
+ */
+extern T Stats_new(const char *program, int json);
+
+/*
+ * ends the running phase, if any, and starts the one named, or none if
+ * phase is NULL. Phases are reported in the order they first ran, and
+ * a phase run twice adds up.
+ */
+extern void Stats_phase(T stats, const char *phase);
+
+/* records a count under a name, replacing an earlier one of that name */
+extern void Stats_count(T stats, const char *name, uint64_t value);
+
+/* ends the running phase and prints everything to out */
+extern void Stats_print(T stats, FILE *out);
+
+/* frees the statistics and sets *stats to NULL */
+extern void Stats_free(T *stats);
+
+#undef T
+#endif
@@ -13,41 +13,103 @@
 *               checking duplicate values in any row, column, or 3x3
 *               submaps. If the file successfully passes all the checks,
 *               the program exits 0, otherwise exits with 1.
+*               Larger sudokus with n x n submaps work the same way:
+*               the pgm is then n*n pixels wide and high, with maximum
+*               pixel intensity n*n, for n up to MAX_BOX.
+*               With --count-solutions, pixel value 0 marks an empty
+*               cell and the program prints how many solutions the
+*               puzzle has: 0, 1 or "2+" when there is more than one.
+*               Adding --parallel (or --parallel=N for N threads)
+*               shares that search among threads.
+*               With --stats, the time of each phase (parsing, then
+*               the column, row and submap checks, or the search) and
+*               the peak RSS go to standard error, as text, or as
+*               JSON with --stats=json.
 *     
 **************************************************************************/
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
 #include "uarray2.h"
-#include "pnmrdr.h"
+#include "uarray2_inline.h"
+#include "arena.h"
+#include "solver.h"
+#include "pgmread.h"
+#include "stats.h"
 
 #define NINE 9
 
 /* check for valid pgm file and check if sudoku has
    no duplicate value in each row/column/submap */
-int check_all(FILE *fp);
-/* check pgm file for graymap type, valid width/height/max pixel intensity */
-void correct_pgm(FILE *fp, Pnmrdr_T rdr);
-/* apply function for UArray2_map_col_major to check
-   if duplicate values exist in column */
-void check_col(int i, int j, UArray2_T uarray2, void *value, void *cl);
-/* apply function for UArray2_map_row_major to check
-   if duplicate values exist in row */
-void check_row(int i, int j, UArray2_T uarray2, void *value, void *cl);
+int check_all(FILE *fp, Stats_T stats);
+/* check for valid pgm file and print how many solutions sudoku has,
+   searching with num_threads threads (-1 for a single-threaded search) */
+int count_all(FILE *fp, int num_threads, Stats_T stats);
+/* check a 9x9 sudoku read straight into a flat array, without allocating */
+int check_nine(FILE *fp, Pgm_header *header, Stats_T stats);
+/* read pgm pixels into unboxed array allocated from arena, pixels
+   between min_pixel and width, or NULL if they are not */
+UArray2_T read_grid(FILE *fp, Pgm_header *header, int min_pixel,
+                    Arena_T arena);
+/* read pgm header and check for graymap type, valid width/height/max
+   pixel intensity and return the width, or 0 if it is not a sudoku */
+int correct_pgm(FILE *fp, Pgm_header *header);
+/* size n of the submaps of a sudoku of given width, 0 if not a sudoku */
+int box_size(int width);
+/* apply function for UArray2_map_col_major_until that stops
+   at the first value repeated in a column */
+int check_col(int i, int j, UArray2_T uarray2, void *value, void *cl);
+/* apply function for UArray2_map_row_major_until that stops
+   at the first value repeated in a row */
+int check_row(int i, int j, UArray2_T uarray2, void *value, void *cl);
 /* check submaps of unboxed array for duplicate value */
 void check_submap(UArray2_T uarray2, int *count);
 /* helper function for check_submap that looks through submap */
-void each_submap(UArray2_T uarray2, int *count, int i, int j);
+void each_submap(UArray2_T uarray2, int *count, int i, int j, int box);
 /* check if duplicate occurred in each row/column/submap */
-void check_duplicate(int *count);
-/* reset integer memory indices 1-9 to value 0 */
-void reset_count(int **count);
-/* free integer memory, 2D unboxed array, pnm reader, file pointer */
-void free_all(int *count, UArray2_T uarray2, Pnmrdr_T rdr, FILE *fp);
+void check_duplicate(int *count, int dim);
+/* reset integer memory indices 1-dim to value 0 */
+void reset_count(int **count, int dim);
+/* free the arena holding the grid and its counts, and the file pointer */
+void free_all(Arena_T *arena, FILE *fp);
 
 int main(int argc, char *argv[])
 {
     FILE *fp = NULL;
+    int count_mode = 0;
+    int num_threads = -1;
+    Stats_T stats = NULL;
+
+    /* optional flags come before the file name */
+    while (argc > 1 && strncmp(argv[1], "--", 2) == 0) {
+        if (strcmp(argv[1], "--count-solutions") == 0) {
+            count_mode = 1;
+        }
+        else if (strcmp(argv[1], "--parallel") == 0) {
+            num_threads = 0;
+        }
+        else if (strncmp(argv[1], "--parallel=", 11) == 0 &&
+                 atoi(argv[1] + 11) > 0) {
+            num_threads = atoi(argv[1] + 11);
+        }
+        else if (strcmp(argv[1], "--stats") == 0 ||
+                 strcmp(argv[1], "--stats=json") == 0) {
+            Stats_free(&stats);
+            stats = Stats_new("sudoku", argv[1][7] == '=');
+        }
+        else {
+            fprintf(stderr, "Unknown option: %s\n", argv[1]);
+            exit(1);
+        }
+        argv++;
+        argc--;
+    }
+    if (num_threads >= 0 && !count_mode) {
+        fprintf(stderr, "--parallel needs --count-solutions\n");
+        exit(1);
+    }
 
     /* If no argument is given, program reads from standard input*/
     if (argc == 1) {
@@ -71,194 +133,375 @@ int main(int argc, char *argv[])
     }
 
     /* 0 if success, 1 if fail */
-    int answer = check_all(fp);
+    int answer = count_mode ? count_all(fp, num_threads, stats)
+                            : check_all(fp, stats);
 
+    Stats_print(stats, stderr);
+    Stats_free(&stats);
     exit(answer);
 }
 
 /******************************************************************
  * check_all
  * Description: Check if the sudoku is valid
- * Inputs: File pointer type fp
- * Output: Integer of 1 (correct) or 0 (fail)
- * Implementation: Check for any input file errors including correct
- *                 format, size, and maximum intensity values.
- *                 Allocate memory that holds 10 integer values. 0
- *                 index used for correctness (1 or 0) and 1-9 indices
- *                 telling how many pixel values(from 1-9) are in each
- *                 column/row/submap. If any of int memory indices 1-9
- *                 contain value greater than 2, meaning duplicate
- *                 occurred, then 0 index will become 0, which is
- *                 the value returned.
+ * Inputs: 1) File pointer type fp
+ *         2) Stats_T to time the phases in, or NULL
+ * Output: Integer of 0 (correct) or 1 (fail)
+ * Implementation: Read the header; a 9x9 sudoku takes the fast path
+ *                 in check_nine. Otherwise read the sudoku with every
+ *                 pixel between 1 and the width into an arena, and
+ *                 allocate from it memory that holds width + 1
+ *                 integer values, all zero. 0 index is the result
+ *                 (0 correct, 1 fail) and 1-width indices tell how
+ *                 many pixel values (from 1-width) are in each
+ *                 column/row/submap. If any of int memory indices
+ *                 1-width reaches 2, meaning a duplicate occurred,
+ *                 then 0 index will become 1, which is the value
+ *                 returned. Columns and rows are
+ *                 checked with maps that stop at the first duplicate,
+ *                 and a failure there skips the rest of the checks.
+ *                 A file that is not a sudoku also returns 1, after
+ *                 closing it, so main still prints the stats.
  ******************************************************************/
-int check_all(FILE *fp)
+int check_all(FILE *fp, Stats_T stats)
 {
-    Pnmrdr_T rdr;
-
-    /* check if pnm is correct format */
-    TRY
-        rdr = Pnmrdr_new(fp);
-
-    EXCEPT(Pnmrdr_Badformat)
-        fprintf(stderr, "Not a pnm\n");
-        fclose(fp);
-        exit(1);
-        
-    END_TRY;
+    Pgm_header header;
+    Stats_phase(stats, "parse");
+    int dim = correct_pgm(fp, &header);
+    if (dim == 0) {
+        return 1;
+    }
+    if (dim == NINE) {
+        return check_nine(fp, &header, stats);
+    }
 
-    /* check if pgm input is suitable for sudoku */
-    correct_pgm(fp, rdr);
+    /* everything for this grid comes from one arena */
+    Arena_T arena = Arena_new();
+    UArray2_T uarray2 = read_grid(fp, &header, 1, arena);
+    if (uarray2 == NULL) {
+        free_all(&arena, fp);
+        return 1;
+    }
+    Stats_count(stats, "cells_read", (uint64_t) dim * dim);
 
     /* allocate memory that count occurrence of pixel value */
     /* Value at 0 index is 1 if sudoku is incorrect and 0 if correct*/
-    int *count = (int *) malloc((NINE+1) * sizeof(int));
-    /* check if machine is out of memory */
-    if (count == NULL) {
-        free(count);
-        Pnmrdr_free(&rdr);
+    int *count = Arena_calloc(arena, dim + 1, sizeof(int), __FILE__,
+                              __LINE__);
+
+    /* check for duplicates in any columns, then any rows, stopping
+       at the first one found */
+    Stats_phase(stats, "columns");
+    if (UArray2_map_col_major_until(uarray2, check_col, count,
+                                    NULL, NULL)) {
+        count[0] = 1;
+    }
+    if (count[0] == 0) {
+        Stats_phase(stats, "rows");
+        if (UArray2_map_row_major_until(uarray2, check_row, count,
+                                        NULL, NULL)) {
+            count[0] = 1;
+        }
+    }
+    if (count[0] == 0) {
+        /* check for duplicates in any submaps */
+        Stats_phase(stats, "submaps");
+        check_submap(uarray2, count);
+    }
+    Stats_phase(stats, NULL);
+    /* 0 if all sudoku passes, 1 if not */
+    int answer = count[0];
+
+    /* deallocate memories */
+    free_all(&arena, fp);
+    return answer;
+}
+
+/******************************************************************
+ * count_all
+ * Description: Print how many solutions the sudoku has
+ * Inputs: 1) File pointer type fp
+ *         2) Integer number of threads for the search, 0 for one
+ *            per CPU, -1 to search on this thread only
+ *         3) Stats_T to time the phases in, or NULL
+ * Output: Integer 0, since a readable puzzle is not an error, or 1
+ *         if the file is not a puzzle
+ * Implementation: Read the sudoku with 0 allowed for empty cells,
+ *                 and count solutions but stop at the second one,
+ *                 since the caller only needs to know whether the
+ *                 solution is unique. Print 0, 1 or "2+".
+ ******************************************************************/
+int count_all(FILE *fp, int num_threads, Stats_T stats)
+{
+    Pgm_header header;
+    Stats_phase(stats, "parse");
+    int dim = correct_pgm(fp, &header);
+    if (dim == 0) {
+        return 1;
+    }
+    Arena_T arena = Arena_new();
+    UArray2_T uarray2 = read_grid(fp, &header, 0, arena);
+    if (uarray2 == NULL) {
+        free_all(&arena, fp);
+        return 1;
+    }
+    Stats_count(stats, "cells_read", (uint64_t) dim * dim);
+
+    Stats_phase(stats, "search");
+    int solutions;
+    if (num_threads < 0) {
+        solutions = count_solutions(uarray2, 2);
+    }
+    else {
+        solutions = count_solutions_parallel(uarray2, 2, num_threads);
+    }
+    Stats_phase(stats, NULL);
+    Stats_count(stats, "solutions", solutions);
+    if (solutions > 1) {
+        printf("2+\n");
+    }
+    else {
+        printf("%d\n", solutions);
+    }
+
+    free_all(&arena, fp);
+    return 0;
+}
+
+/******************************************************************
+ * check_nine
+ * Description: Check if a 9x9 sudoku is valid, without allocating
+ * Inputs: 1) File pointer type fp, right after the header
+ *         2) Pgm_header of the sudoku
+ *         3) Stats_T to time the phases in, or NULL
+ * Output: Integer of 0 (correct) or 1 (fail)
+ * Implementation: Read the 81 pixels into a flat array on the
+ *                 stack. If they cannot be read, or any pixel is
+ *                 not between 1 and 9, return 1. Every row, column
+ *                 and submap keeps the digits seen so far as bits of
+ *                 a mask, so a digit whose bit is already set is a
+ *                 duplicate. All three are checked in one pass, timed
+ *                 as one phase.
+ ******************************************************************/
+int check_nine(FILE *fp, Pgm_header *header, Stats_T stats)
+{
+    unsigned char grid[NINE * NINE];
+    uint16_t rows[NINE] = { 0 };
+    uint16_t cols[NINE] = { 0 };
+    uint16_t boxes[NINE] = { 0 };
+    int answer = 0;
+
+    if (read_pgm_pixels(fp, header, grid, NINE * NINE) == 0) {
         fclose(fp);
-        exit(1);
+        return 1;
     }
-    /* start out count memory values to be all 0 */
-    count[0] = 0;
-    reset_count(&count);
+    Stats_count(stats, "cells_read", NINE * NINE);
 
-    /* make 9x9 unboxed array */
-    UArray2_T uarray2 = UArray2_new(NINE, NINE, sizeof(int));
-    /* put pixel value to unboxed array */
+    Stats_phase(stats, "check");
     for (int j = 0; j < NINE; j++) {
         for (int i = 0; i < NINE; i++) {
-            int pixel = Pnmrdr_get(rdr);
+            int pixel = grid[j * NINE + i];
             /* check if each pixel is between 1 and 9 */
-            if (pixel < 1 || pixel > 9) {
-                count[0] = 1;
+            if (pixel < 1 || pixel > NINE) {
+                Stats_phase(stats, NULL);
+                fclose(fp);
+                return 1;
             }
-            else {
-            /* put pixel in unboxed array */
-            *(int *) UArray2_at(uarray2, i, j) = pixel;
+
+            uint16_t bit = (uint16_t) (1 << pixel);
+            int box = (j / 3) * 3 + i / 3;
+            if ((rows[j] | cols[i] | boxes[box]) & bit) {
+                answer = 1;
             }
+            rows[j] |= bit;
+            cols[i] |= bit;
+            boxes[box] |= bit;
         }
     }
-    /* if the pixel value was less than 1 or greater than 9, exit */
-    if (count[0] == 1) {
-        free_all(count, uarray2, rdr, fp);
-        exit(1);
+    Stats_phase(stats, NULL);
+
+    fclose(fp);
+    return answer;
+}
+
+/******************************************************************
+ * read_grid
+ * Description: Read the sudoku from a pgm file
+ * Inputs: 1) File pointer type fp, right after the header
+ *         2) Pgm_header of the sudoku
+ *         3) Integer min_pixel, the smallest pixel value allowed
+ *         4) Arena_T to allocate the unboxed array from
+ * Output: UArray2_T unboxed array of the pixel values as ints, or
+ *         NULL if the pixels cannot be read, or any pixel is less
+ *         than min_pixel or greater than the width
+ * Implementation: Read all pixels into a flat array on the stack,
+ *                 which is big enough for the largest sudoku, then
+ *                 put every pixel in the unboxed array. The array
+ *                 stays in the arena either way, for the caller to
+ *                 dispose of.
+ ******************************************************************/
+UArray2_T read_grid(FILE *fp, Pgm_header *header, int min_pixel,
+                    Arena_T arena)
+{
+    unsigned char pixels[MAX_BOX * MAX_BOX * MAX_BOX * MAX_BOX];
+    int dim = header->width;
+
+    if (read_pgm_pixels(fp, header, pixels, dim * dim) == 0) {
+        return NULL;
     }
 
-    /* check for duplicates in any columns */
-    UArray2_map_col_major(uarray2, check_col, count);
-    reset_count(&count);
-    /* check for duplicates in any rows */
-    UArray2_map_row_major(uarray2, check_row, count);
-    reset_count(&count);
-    /* check for duplicates in any submaps */
-    check_submap(uarray2, count);
-    /* 0 if all sudoku passes, 1 if not */
-    int answer = count[0];
+    int bad_pixel = 0;
+    /* make dim x dim unboxed array */
+    UArray2_T uarray2 = UArray2_new_arena(arena, dim, dim, sizeof(int));
+    /* put pixel value to unboxed array */
+    for (int j = 0; j < dim; j++) {
+        for (int i = 0; i < dim; i++) {
+            int pixel = pixels[j * dim + i];
+            /* check if each pixel is between min_pixel and dim */
+            if (pixel < min_pixel || pixel > dim) {
+                bad_pixel = 1;
+            }
+            else {
+            /* put pixel in unboxed array */
+            *(int *) UArray2_at_fast(uarray2, i, j) = pixel;
+            }
+        }
+    }
 
-    /* deallocate memories */
-    free_all(count, uarray2, rdr, fp);
-    return answer;
+    /* if the pixel value was out of range, it is not a sudoku */
+    return bad_pixel ? NULL : uarray2;
 }
 
 /******************************************************************
  * correct_pgm
- * Description: Check if pgm file is suitable for sudoku
- * Inputs: File pointer fp, Pnm reader rdr
- * Output: Void
- * Implementation: If pnm reader is not graymap type, exit with 1.
- *                 If width/height/max intensity is not 9, exit
- *                 with 1.
+ * Description: Read the pgm header and check that it is suitable
+ *              for sudoku
+ * Inputs: 1) File pointer fp
+ *         2) Pgm_header to fill in
+ * Output: Integer width of the sudoku, or 0 with the file closed
+ * Implementation: If the header cannot be read, print "Not a pnm"
+ *                 and return 0. If it is not a graymap, print
+ *                 "Not a graymap" and return 0. If width is not
+ *                 n*n for n from 1 to MAX_BOX, or height/max
+ *                 intensity is not the same as width, return 0.
  ******************************************************************/
-void correct_pgm(FILE *fp, Pnmrdr_T rdr)
+int correct_pgm(FILE *fp, Pgm_header *header)
 {
-    Pnmrdr_mapdata pnmdata = Pnmrdr_data(rdr);
+    /* check if pnm is correct format */
+    if (read_pgm_header(fp, header) == 0) {
+        fprintf(stderr, "Not a pnm\n");
+        fclose(fp);
+        return 0;
+    }
 
     /* check for portable graymap */
-    if (pnmdata.type != Pnmrdr_gray) {
+    if (header->format != 2 && header->format != 5) {
         fprintf(stderr, "Not a graymap\n");
-        Pnmrdr_free(&rdr);
         fclose(fp);
-        exit(1);
+        return 0;
     }
-    /* check for width and height of sudoku to be 9 */
-    if (pnmdata.width != NINE || pnmdata.height != NINE) {
-        Pnmrdr_free(&rdr);
+    /* check for width and height of sudoku to be the same n*n */
+    if (header->width > MAX_BOX * MAX_BOX ||
+        box_size(header->width) == 0 || header->height != header->width) {
         fclose(fp);
-        exit(1);
+        return 0;
     }
-    /* check for max intensity to be 9 */
-    if (pnmdata.denominator != NINE) {
-        Pnmrdr_free(&rdr);
+    /* check for max intensity to be the width */
+    if (header->maxval != header->width) {
         fclose(fp);
-        exit(1);
+        return 0;
+    }
+
+    return header->width;
+}
+
+/******************************************************************
+ * box_size
+ * Description: Get the size of the submaps of a sudoku
+ * Inputs: Integer width of the sudoku
+ * Output: Integer n such that n*n is width, or 0 if there is none
+ * Implementation: Try n from 1 up until n*n is at least width.
+ ******************************************************************/
+int box_size(int width)
+{
+    int box = 1;
+    while (box * box < width) {
+        box++;
     }
+    return box * box == width ? box : 0;
 }
 
 /******************************************************************
  * check_col
- * Description: Apply function for UArray2_map_col_major to check
- *              if duplicate values exist in column
+ * Description: Apply function for UArray2_map_col_major_until to
+ *              check if duplicate values exist in column
  * Inputs: 1) Integer i is column number of array
  *         2) Integer j is row number of array
  *         3) UArray2_T uarray2 is the array we are looking through
  *         4) Void pointer to value at [i, j] index at uarray2
  *         5) Void pointer to closure, in our case, it points to
- *            integer memory of size 10 called count
- * Output: Void
- * Implementation: Pixel value at [i, j] becomes index of count
- *                 memory and adds 1 to that index, meaning that
- *                 pixel is now occurred in the column. If it's last
- *                 index of the column, check for any duplicate
- *                 in that column.
+ *            dim + 1 integers called count, dim being the width
+ *            of the sudoku; index 0 is check_all's result
+ * Output: 1 to stop the traversal at a duplicate, 0 to go on
+ * Implementation: Pixel value at [i, j], from 1 to dim, becomes
+ *                 index of count and adds 1 to that index, meaning
+ *                 that pixel is now occurred in the column. Seeing it a
+ *                 second time means the sudoku fails, so there is
+ *                 no need to look any further. At the last index of
+ *                 the column, reset the counts for the next one.
  ******************************************************************/
-void check_col(int i, int j, UArray2_T uarray2, void *value, void *cl)
+int check_col(int i, int j, UArray2_T uarray2, void *value, void *cl)
 {
     (void) i;
-    (void) uarray2;
 
     int *pixel = (int *) value;
     int *count = (int *) cl;
+    int height = UArray2_height(uarray2);
     /* increment value at index of pixel value */
     count[*pixel] = count[*pixel] + 1;
 
-    /* if at last index of column, check for duplicate */
-    if (j == NINE-1) {
-        check_duplicate(count);
+    if (count[*pixel] > 1) {
+        return 1;
+    }
+    /* if at last index of column, start over for the next one */
+    if (j == height-1) {
+        reset_count(&count, height);
     }
+    return 0;
 }
 
 /******************************************************************
  * check_row
- * Description: Apply function for UArray2_map_row_major to check
- *              if duplicate values exist in column
+ * Description: Apply function for UArray2_map_row_major_until to
+ *              check if duplicate values exist in row
  * Inputs: 1) Integer i is column number of array
  *         2) Integer j is row number of array
  *         3) UArray2_T uarray2 is the array we are looking through
  *         4) Void pointer to value at [i, j] index at uarray2
  *         5) Void pointer to closure, in our case, it points to
- *            integer memory of size 10 called count
- * Output: Void
- * Implementation: Pixel value at [i, j] becomes index of count
- *                 memory and adds 1 to that index, meaning that
- *                 pixel is now occurred in the row. If it's last
- *                 index of the row, check for any duplicate
- *                 in that row.
+ *            dim + 1 integers called count, dim being the width
+ *            of the sudoku; index 0 is check_all's result
+ * Output: 1 to stop the traversal at a duplicate, 0 to go on
+ * Implementation: Same as check_col, along the row.
  ******************************************************************/
-void check_row(int i, int j, UArray2_T uarray2, void *value, void *cl)
+int check_row(int i, int j, UArray2_T uarray2, void *value, void *cl)
 {
     (void) j;
-    (void) uarray2;
 
     int *pixel = (int *) value;
     int *count = (int *) cl;
+    int width = UArray2_width(uarray2);
     /* increment value at index of pixel value */
     count[*pixel] = count[*pixel] + 1;
 
-    /* if at last index of column, check for duplicate */
-    if (i == NINE-1) {
-        check_duplicate(count);
+    if (count[*pixel] > 1) {
+        return 1;
+    }
+    /* if at last index of row, start over for the next one */
+    if (i == width-1) {
+        reset_count(&count, width);
     }
+    return 0;
 }
 
 /******************************************************************
@@ -267,16 +510,21 @@ void check_row(int i, int j, UArray2_T uarray2, void *value, void *cl)
  *              any duplicate in the submap
  * Inputs: 1) UArray2_T uarray2 is the array we are looking through
  *         2) Integer pointer count which is allocated memory to
- *            check for occurrence number of pixel from 1-9
+ *            check for occurrence number of pixel from 1-width
  * Output: Void
  * Implementation: Iterate array using double for loops but
- *                 increment row and column values by 3 every time
+ *                 increment row and column values by the submap
+ *                 size every time
  ******************************************************************/
 void check_submap(UArray2_T uarray2, int *count)
 {
-    for (int i = 0; i < NINE; i=i+3) {
-        for (int j = 0; j < NINE; j=j+3) {
-            each_submap(uarray2, count, i, j);
+    int dim = UArray2_width(uarray2);
+    int box = box_size(dim);
+
+    /* stop after the first submap with a duplicate */
+    for (int i = 0; i < dim && count[0] == 0; i=i+box) {
+        for (int j = 0; j < dim && count[0] == 0; j=j+box) {
+            each_submap(uarray2, count, i, j, box);
         }
     }
 }
@@ -286,9 +534,10 @@ void check_submap(UArray2_T uarray2, int *count)
  * Description: Look for duplicates in the submap
  * Inputs: 1) UArray2_T uarray2 is the array we are looking through
  *         2) Integer pointer count which is allocated memory to
- *            check for occurrence number of pixel from 1-9
+ *            check for occurrence number of pixel from 1-width
  *         3) Integer i is column number of array
  *         4) Integer j is row number of array
+ *         5) Integer box is the width and height of the submap
  * Output: Void
  * Implementation: Iterate through submap and use pixel value as
  *                 the index of count integer memory and add 1
@@ -296,55 +545,57 @@ void check_submap(UArray2_T uarray2, int *count)
  *                 When done iterating, check for duplicate using
  *                 count memory.
  ******************************************************************/
-void each_submap(UArray2_T uarray2, int *count, int i, int j)
+void each_submap(UArray2_T uarray2, int *count, int i, int j, int box)
 {
     int pixel = 0;
 
-    for (int idx = i; idx < i+3; idx++) {
-        for (int jdx = j; jdx < j+3; jdx++) {
-            pixel = *(int *) UArray2_at(uarray2, idx, jdx);
+    for (int idx = i; idx < i+box; idx++) {
+        for (int jdx = j; jdx < j+box; jdx++) {
+            pixel = *(int *) UArray2_at_fast(uarray2, idx, jdx);
             /* increment value at index of pixel value */
             count[pixel] = count[pixel] + 1;
         }
     }
 
-    check_duplicate(count);
+    check_duplicate(count, box * box);
 }
 
 /******************************************************************
  * check_duplicate
  * Description: Check if duplicate existed in each column/row/submap
- * Inputs: Integer pointer count which is allocated memory to
- *         check for occurrence number of pixel from 1-9
+ * Inputs: 1) Integer pointer count which is allocated memory to
+ *            check for occurrence number of pixel from 1-dim
+ *         2) Integer dim is the largest pixel value
  * Output: Void
- * Implementation: Iterate from 1-9 indices and if any of value
+ * Implementation: Iterate from 1-dim indices and if any of value
  *                 at those indices is greater 2, meaning duplicate
  *                 occurred, make 0 index of count memory to 1.
- *                 Then, reset indices 1-9 to value 0.
+ *                 Then, reset indices 1-dim to value 0.
  ******************************************************************/
-void check_duplicate(int *count)
+void check_duplicate(int *count, int dim)
 {
-    for (int idx = 1; idx < NINE+1; idx++) {
+    for (int idx = 1; idx < dim+1; idx++) {
         if (count[idx] > 1) {
             count[0] = 1;
         }
     }
 
-    reset_count(&count);
+    reset_count(&count, dim);
 }
 
 /******************************************************************
  * reset_count
  * Description: Reset count memory indices to 0
- * Inputs: Integer pointer count which is allocated memory to
- *         check for occurrence number of pixel from 1-9
+ * Inputs: 1) Integer pointer count which is allocated memory to
+ *            check for occurrence number of pixel from 1-dim
+ *         2) Integer dim is the largest pixel value
  * Output: Void
- * Implementation: From 1-9 indices of count memory, make values
+ * Implementation: From 1-dim indices of count memory, make values
  *                 at those indices to 0.
  ******************************************************************/
-void reset_count(int **count)
+void reset_count(int **count, int dim)
 {
-    for (int i = 1; i < NINE+1; i++) {
+    for (int i = 1; i < dim+1; i++) {
         (*count)[i] = 0;
     }
 }
@@ -352,19 +603,15 @@ void reset_count(int **count)
 /******************************************************************
  * free_all
  * Description: Handy function to deallocate memories
- * Inputs: 1) Integer pointer count which is allocated memory to
- *            check for occurrence number of pixel from 1-9
- *         2) UArray2_T uarray2 is the array we are looking through
- *         3) Pnm reader rdr
- *         4) File pointer fp
+ * Inputs: 1) Pointer to the Arena_T holding the unboxed array and
+ *            the integer memory that counts occurrences of pixels
+ *         2) File pointer fp
  * Output: Void
- * Implementation: Free integer memory, 2D unboxed array, pnm reader, 
- *                 and file pointer
+ * Implementation: Dispose of the arena, which frees everything
+ *                 allocated for the grid at once, and close the file
  ******************************************************************/
-void free_all(int *count, UArray2_T uarray2, Pnmrdr_T rdr, FILE *fp)
+void free_all(Arena_T *arena, FILE *fp)
 {
-    free(count);
-    UArray2_free(&uarray2);
-    Pnmrdr_free(&rdr);
+    Arena_dispose(arena);
     fclose(fp);
 }
@@ -0,0 +1,205 @@
+/*************************************************************************
+*                              sudokugen.c
+*
+*
+*      Authors: Jae Hyun Cheigh (jcheig01), Khanh Nguyen (cnguye10)
+*
+*      Fall 2020 - COMP40
+*      HW 2 - Part D
+*
+*
+*      Summary: This program writes sudoku grids as plain (P2) pgm
+*               files on standard output, for timing sudoku. The grid
+*               has n x n submaps, so it is n*n pixels on a side with
+*               maximum intensity n*n, as sudoku reads it. The same
+*               arguments always give the same file. Kinds of grid:
+*
+*               valid    a solved grid, which sudoku accepts
+*               invalid  a solved grid with one cell changed to another
+*                        digit, which sudoku rejects
+*               puzzle   a solved grid with some cells blanked to 0,
+*                        for sudoku --count-solutions
+*
+*               Usage: sudokugen kind [n] [seed] [blanks]
+*
+**************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mem.h"
+
+/* largest submap size written; sudoku reads up to its own MAX_BOX */
+#define MAX_GEN_BOX 8
+
+/* fill a dim x dim grid with a shuffled solution */
+void make_solution(int *grid, int box, unsigned *seed);
+/* shuffle count ints in place */
+void shuffle(int *values, int count, unsigned *seed);
+/* write the grid as a plain pgm */
+void write_pgm(const int *grid, int dim, FILE *out);
+/* next value of a fixed linear congruential generator */
+unsigned next_random(unsigned *seed);
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2 || argc > 5) {
+        fprintf(stderr, "Usage: %s valid|invalid|puzzle [n] [seed] "
+                "[blanks]\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    int box = argc > 2 ? atoi(argv[2]) : 3;
+    unsigned seed = argc > 3 ? (unsigned) atoi(argv[3]) : 1;
+    if (box < 2 || box > MAX_GEN_BOX) {
+        fprintf(stderr, "Submap size should be 2 to %d\n", MAX_GEN_BOX);
+        exit(EXIT_FAILURE);
+    }
+
+    int dim = box * box;
+    int cells = dim * dim;
+    int blanks = argc > 4 ? atoi(argv[4]) : cells / 2;
+    if (blanks < 0 || blanks > cells) {
+        fprintf(stderr, "Blanks should be 0 to %d\n", cells);
+        exit(EXIT_FAILURE);
+    }
+
+    int *grid = ALLOC(cells * sizeof(int));
+    make_solution(grid, box, &seed);
+
+    if (strcmp(argv[1], "invalid") == 0) {
+        /* any other digit is already elsewhere in the cell's row */
+        int cell = next_random(&seed) % cells;
+        int change = 1 + next_random(&seed) % (dim - 1);
+        grid[cell] = (grid[cell] - 1 + change) % dim + 1;
+    }
+    else if (strcmp(argv[1], "puzzle") == 0) {
+        int *order = ALLOC(cells * sizeof(int));
+        for (int k = 0; k < cells; k++) {
+            order[k] = k;
+        }
+        shuffle(order, cells, &seed);
+        for (int k = 0; k < blanks; k++) {
+            grid[order[k]] = 0;
+        }
+        FREE(order);
+    }
+    else if (strcmp(argv[1], "valid") != 0) {
+        fprintf(stderr, "Unknown kind: %s\n", argv[1]);
+        FREE(grid);
+        exit(EXIT_FAILURE);
+    }
+
+    write_pgm(grid, dim, stdout);
+    FREE(grid);
+    return EXIT_SUCCESS;
+}
+
+/***********************************************************
+* make_solution
+* Description: Make a solved sudoku
+* Input: 1) Grid of dim x dim ints to fill, row by row
+*        2) Integer submap size n, dim being n * n
+*        3) Pointer to the random seed
+* Output: Void
+* Implementation: Start from the pattern where row r is row
+*                 0 shifted by n * (r % n) + r / n, which is a
+*                 solution, and keep it one: relabel the
+*                 digits, shuffle the rows within each band of
+*                 n rows and the bands themselves, and the same
+*                 for columns.
+***********************************************************/
+void make_solution(int *grid, int box, unsigned *seed)
+{
+    int dim = box * box;
+    int digits[MAX_GEN_BOX * MAX_GEN_BOX];
+    int rows[MAX_GEN_BOX * MAX_GEN_BOX];
+    int cols[MAX_GEN_BOX * MAX_GEN_BOX];
+    int bands[MAX_GEN_BOX];
+    int stacks[MAX_GEN_BOX];
+
+    for (int k = 0; k < dim; k++) {
+        digits[k] = k + 1;
+    }
+    shuffle(digits, dim, seed);
+
+    for (int b = 0; b < box; b++) {
+        bands[b] = b;
+        stacks[b] = b;
+    }
+    shuffle(bands, box, seed);
+    shuffle(stacks, box, seed);
+    for (int b = 0; b < box; b++) {
+        int inner_rows[MAX_GEN_BOX];
+        int inner_cols[MAX_GEN_BOX];
+        for (int k = 0; k < box; k++) {
+            inner_rows[k] = k;
+            inner_cols[k] = k;
+        }
+        shuffle(inner_rows, box, seed);
+        shuffle(inner_cols, box, seed);
+        for (int k = 0; k < box; k++) {
+            rows[b * box + k] = bands[b] * box + inner_rows[k];
+            cols[b * box + k] = stacks[b] * box + inner_cols[k];
+        }
+    }
+
+    for (int r = 0; r < dim; r++) {
+        int row = rows[r];
+        for (int c = 0; c < dim; c++) {
+            int pattern = (box * (row % box) + row / box + cols[c]) % dim;
+            grid[r * dim + c] = digits[pattern];
+        }
+    }
+}
+
+/***********************************************************
+* shuffle
+* Description: Put ints in a random order
+* Input: 1) Array of ints
+*        2) Integer count of them
+*        3) Pointer to the random seed
+* Output: Void
+* Implementation: Fisher-Yates, from the back.
+***********************************************************/
+void shuffle(int *values, int count, unsigned *seed)
+{
+    for (int k = count - 1; k > 0; k--) {
+        int other = next_random(seed) % (k + 1);
+        int value = values[k];
+        values[k] = values[other];
+        values[other] = value;
+    }
+}
+
+/***********************************************************
+* write_pgm
+* Description: Write a grid as a plain pgm
+* Input: 1) Grid of dim x dim ints, row by row
+*        2) Integer dim
+*        3) File to write to
+* Output: Void
+***********************************************************/
+void write_pgm(const int *grid, int dim, FILE *out)
+{
+    fprintf(out, "P2\n%d %d\n%d\n", dim, dim, dim);
+    for (int r = 0; r < dim; r++) {
+        for (int c = 0; c < dim; c++) {
+            fprintf(out, "%d%c", grid[r * dim + c],
+                    c == dim - 1 ? '\n' : ' ');
+        }
+    }
+}
+
+/***********************************************************
+* next_random
+* Description: Step a linear congruential generator
+* Input: Pointer to the seed, updated
+* Output: 15 random bits
+* Implementation: Same generator as pbmgen.
+***********************************************************/
+unsigned next_random(unsigned *seed)
+{
+    *seed = *seed * 1103515245 + 12345;
+    return (*seed / 65536) % 32768;
+}
@@ -0,0 +1,226 @@
+/*************************************************************************
+*                              toolbench.c
+*
+*
+*      Authors: Jae Hyun Cheigh (jcheig01), Khanh Nguyen (cnguye10)
+*
+*      Fall 2020 - COMP40
+*      HW 2 - Part D
+*
+*
+*      Summary: This program times a whole tool, unblackedges or sudoku,
+*               on one input file. It runs the command the given number
+*               of times with the file on standard input and standard
+*               output thrown away, and prints one line of JSON: the
+*               median wall time of a run, the throughput, in
+*               megapixels per second for a pbm and grids per second
+*               for a pgm, the peak resident set size of the runs in
+*               kilobytes, and the exit status of the last run. sudoku
+*               exits 1 on a grid that is not solved, so the status is
+*               reported rather than taken as a failure; a command
+*               killed by a signal, or that cannot be run, is one.
+*
+*               "make throughput" runs it over the files that pbmgen
+*               and sudokugen write to corpus/.
+*
+*               Usage: toolbench runs input command [args...]
+*
+**************************************************************************/
+
+/* wait4, for the resource use of each run */
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include "mem.h"
+
+/* read the magic number and size of a pbm or pgm */
+int read_header(const char *input, int *magic, long *width, long *height);
+/* run the command once on the input, returning its wait status */
+int run_once(const char *input, char *command[], double *seconds,
+             long *rss_kb);
+/* order doubles for qsort */
+int compare_doubles(const void *a, const void *b);
+
+int main(int argc, char *argv[])
+{
+    if (argc < 4 || atoi(argv[1]) <= 0) {
+        fprintf(stderr, "Usage: %s runs input command [args...]\n",
+                argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    int runs = atoi(argv[1]);
+    const char *input = argv[2];
+    char **command = &argv[3];
+    int magic;
+    long width, height;
+
+    if (!read_header(input, &magic, &width, &height)) {
+        fprintf(stderr, "%s: not a pbm or pgm file\n", input);
+        exit(EXIT_FAILURE);
+    }
+
+    double *seconds = ALLOC(runs * sizeof(double));
+    int status = 0;
+    long peak_rss = 0;
+    for (int run = 0; run < runs; run++) {
+        long rss;
+        status = run_once(input, command, &seconds[run], &rss);
+        if (status < 0 || !WIFEXITED(status)) {
+            fprintf(stderr, "%s did not run to completion on %s\n",
+                    command[0], input);
+            FREE(seconds);
+            exit(EXIT_FAILURE);
+        }
+        if (rss > peak_rss) {
+            peak_rss = rss;
+        }
+    }
+
+    qsort(seconds, runs, sizeof(double), compare_doubles);
+    double median = seconds[runs / 2];
+    if (runs % 2 == 0) {
+        median = (seconds[runs / 2 - 1] + median) / 2;
+    }
+
+    printf("{\"command\": \"");
+    for (char **arg = command; *arg != NULL; arg++) {
+        printf("%s%s", arg == command ? "" : " ", *arg);
+    }
+    printf("\", \"input\": \"%s\", \"runs\": %d, \"median_s\": %.6f, ",
+           input, runs, median);
+    if (magic == '1' || magic == '4') {
+        printf("\"megapixels\": %.3f, \"mp_per_s\": %.2f, ",
+               width * height / 1e6, width * height / 1e6 / median);
+    }
+    else {
+        printf("\"grids_per_s\": %.1f, ", 1 / median);
+    }
+    printf("\"peak_rss_kb\": %ld, \"exit_status\": %d}\n",
+           peak_rss, WEXITSTATUS(status));
+
+    FREE(seconds);
+    return EXIT_SUCCESS;
+}
+
+/***********************************************************
+* read_header
+* Description: Read the start of a pbm or pgm file
+* Input: 1) Name of the file
+*        2) Pointers to the magic number's digit, the width
+*           and the height, set
+* Output: 1 if the file starts as a P1, P2, P4 or P5 file,
+*         0 if not
+* Implementation: Skips whitespace and # comments between
+*                 the fields, as the netpbm formats allow.
+***********************************************************/
+int read_header(const char *input, int *magic, long *width, long *height)
+{
+    FILE *fp = fopen(input, "rb");
+    if (fp == NULL) {
+        return 0;
+    }
+
+    int ok = getc(fp) == 'P';
+    *magic = getc(fp);
+    ok = ok && strchr("1245", *magic) != NULL && *magic != '\0';
+
+    long *fields[2] = { width, height };
+    for (int f = 0; ok && f < 2; f++) {
+        int c = getc(fp);
+        while (c == '#' || c == ' ' || c == '\t' || c == '\n' ||
+               c == '\r') {
+            if (c == '#') {
+                while (c != '\n' && c != EOF) {
+                    c = getc(fp);
+                }
+            }
+            c = getc(fp);
+        }
+        ungetc(c, fp);
+        ok = fscanf(fp, "%ld", fields[f]) == 1 && *fields[f] > 0;
+    }
+
+    fclose(fp);
+    return ok;
+}
+
+/***********************************************************
+* run_once
+* Description: Run the command on the input and time it
+* Input: 1) Name of the input file
+*        2) The command and its arguments, ending in NULL
+*        3) Pointer to the wall time in seconds, set
+*        4) Pointer to the run's peak resident set size in
+*           kilobytes, set
+* Output: The wait status of the command, or -1 if it could
+*         not be started
+* Implementation: fork, then in the child put the input on
+*                 standard input and /dev/null on standard
+*                 output and exec the command; the time is
+*                 from before the fork to after the wait.
+*                 wait4 gives the resource use of this child
+*                 alone, where getrusage would give the most of
+*                 any child so far.
+***********************************************************/
+int run_once(const char *input, char *command[], double *seconds,
+             long *rss_kb)
+{
+    struct timespec start, end;
+    struct rusage usage;
+    int status;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    pid_t child = fork();
+    if (child < 0) {
+        return -1;
+    }
+    if (child == 0) {
+        int in = open(input, O_RDONLY);
+        int out = open("/dev/null", O_WRONLY);
+        if (in < 0 || out < 0 || dup2(in, STDIN_FILENO) < 0 ||
+            dup2(out, STDOUT_FILENO) < 0) {
+            _exit(127);
+        }
+        close(in);
+        close(out);
+        execvp(command[0], command);
+        perror(command[0]);
+        _exit(127);
+    }
+    if (wait4(child, &status, 0, &usage) < 0) {
+        return -1;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    *seconds = (end.tv_sec - start.tv_sec) +
+               (end.tv_nsec - start.tv_nsec) / 1e9;
+    *rss_kb = usage.ru_maxrss;
+    if (WIFEXITED(status) && WEXITSTATUS(status) == 127) {
+        return -1;
+    }
+    return status;
+}
+
+/***********************************************************
+* compare_doubles
+* Description: Compare two doubles for qsort
+* Input: Pointers to the two doubles
+* Output: Negative, zero or positive as the first is less,
+*         equal or greater
+***********************************************************/
+int compare_doubles(const void *a, const void *b)
+{
+    double x = *(const double *) a;
+    double y = *(const double *) b;
+    return (x > y) - (x < y);
+}
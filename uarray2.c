@@ -9,26 +9,97 @@
 * 
 * 
 *      Summary: This file is used to implement our version of 2D unboxed
-*               array. It incorporates Hanson's UArray_T but index in
-*               different way to make 1D array into 2D array.
+*               array. Elements are kept in one block of memory, row
+*               by row, which is indexed to make 1D array into 2D array.
+*               An array can instead live in a memory-mapped file that
+*               starts with a fixed header, so it can be reopened
+*               without reading or parsing its elements, or be a view
+*               of memory owned by someone else: a caller's buffer or
+*               a rectangle of another array. Rows are stride bytes
+*               apart and columns step bytes apart, so the same code
+*               serves row-major arrays (step is the element size),
+*               column-major ones (stride is) and views of either. An
+*               array can also have a custom layout such as Morton
+*               order, which maps [i, j] to a slot with a function.
 *     
 **************************************************************************/
 
+#define _POSIX_C_SOURCE 200809L
+/* for madvise and MADV_HUGEPAGE, which POSIX does not have */
+#define _DEFAULT_SOURCE
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <limits.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "uarray2.h"
-#include "uarray.h"
+#include "uarray2_inline.h"
 #include "assert.h"
 #include "mem.h"
 
 #define T UArray2_T
 
-/* data that our unboxed array element holds */
-struct T {
-    int width;
-    int height;
-    int size;
-    UArray_T array;
+/* identifies files made by UArray2_map_file, and their layout version */
+#define FILE_MAGIC "UARRAY2"
+#define FILE_VERSION 1
+/* elements start this far into the file, which keeps them aligned */
+#define FILE_HEADER_SIZE 64
+/* UArray2_orient copies TILE x TILE elements at a time */
+#define TILE 32
+/* owner of an array from UArray2_new_aligned: one block, elements first */
+#define OWNER_BLOCK 2
+/* owner of an array from UArray2_new_arena: the arena frees it */
+#define OWNER_ARENA 3
+
+/*
+ * header at the start of a mapped file, in native byte order. The
+ * dimensions are 64-bit so the layout will not change for bigger arrays.
+ */
+struct file_header {
+    char magic[8];
+    uint32_t version;
+    uint32_t size;
+    uint64_t width;
+    uint64_t height;
+    uint64_t offset;
+    char unused[FILE_HEADER_SIZE - 40];
+};
+
+/* slots to CALLOC for an array, raising Mem_Failed if they cannot be */
+static long slot_count(uint64_t slots, int size);
+/* round bytes up to a multiple of a power of two */
+static size_t round_up(size_t bytes, size_t alignment);
+/* check a mapped header against the file and the requested shape */
+static int header_matches(struct file_header *header, size_t file_length,
+                          int width, int height, int size);
+/* copy a block of elements read with arbitrary steps */
+static void copy_block(char *dest, size_t dest_stride, const char *source,
+                       ptrdiff_t step_i, ptrdiff_t step_j, int width,
+                       int height, int size);
+static inline void copy_elements(char *dest, size_t dest_stride,
+                                 const char *source, ptrdiff_t step_i,
+                                 ptrdiff_t step_j, int width, int height,
+                                 int size);
+/* UArray2_orient_into one element at a time, for custom layouts */
+static void orient_elements(T dest, T source, int swap, int mirror_u,
+                            int mirror_v);
+/* contiguous lines of a rectangle, for UArray2_fill and UArray2_copy */
+static int rect_lines(T uarray2, int i, int j, int width, int height,
+                      char **first, size_t *line_stride,
+                      int *line_length, int *lines);
+/* the three functions of UArray2_morton */
+static size_t morton_length(int width, int height);
+static size_t morton_index(int i, int j, int width, int height);
+static int morton_element(size_t slot, int width, int height, int *i,
+                          int *j);
+
+const UArray2_layout UArray2_morton = {
+    morton_length, morton_index, morton_element
 };
 
 /****************************************************************
@@ -40,29 +111,447 @@ struct T {
  *         2) Integer value of height of the desired unboxed array
  *         3) Integer value of byte-size of each array element holds
  * Output: UArray2_T type array
- * Implementation: Check if width & height are positive integer and
- *                 if byte-size is greater than 0. Allocate memory for
- *                 UArray2 unboxed array and initialize width, height,
- *                 size, and actual UArray unboxed array that we
- *                 will be incorporating with, and return the unboxed
- *                 array.
+ * Implementation: A row-major UArray2_new_ordered, which checks
+ *                 if width & height are positive integer and if
+ *                 byte-size is greater than 0, then allocates memory
+ *                 for UArray2 unboxed array and initializes width,
+ *                 height, size, and the zeroed block of elements it
+ *                 owns, and returns the unboxed array.
  *****************************************************************/
 T UArray2_new(int width, int height, int size)
+{
+    return UArray2_new_ordered(width, height, size, UArray2_ROW_MAJOR);
+}
+
+/****************************************************************
+ * UArray2_new_ordered
+ * Description: Create a new unboxed 2D array stored row by row or
+ *              column by column
+ * Inputs: 1) Integer width, height and byte-size of the elements
+ *         2) UArray2_ROW_MAJOR or UArray2_COL_MAJOR
+ * Output: UArray2_T type array
+ * Implementation: Allocate the zeroed elements. Row-major elements
+ *                 are a step of one element apart along a row and a
+ *                 stride of one row apart down a column; column-major
+ *                 ones the other way around.
+ *****************************************************************/
+T UArray2_new_ordered(int width, int height, int size, UArray2_order order)
+{
+    assert(width >= 0 && height >= 0);
+    assert(size > 0);
+    assert(order == UArray2_ROW_MAJOR || order == UArray2_COL_MAJOR);
+
+    long slots = slot_count((uint64_t) width * height, size);
+    T uarray2;
+    NEW(uarray2);
+
+    uarray2->width = width;
+    uarray2->height = height;
+    uarray2->size = size;
+    if (order == UArray2_ROW_MAJOR) {
+        uarray2->stride = (size_t) width * size;
+        uarray2->step = size;
+    }
+    else {
+        uarray2->stride = size;
+        uarray2->step = (size_t) height * size;
+    }
+    uarray2->elems = CALLOC(slots, size);
+    uarray2->layout = NULL;
+    uarray2->owner = 1;
+    uarray2->map = NULL;
+    uarray2->map_length = 0;
+
+    return uarray2;
+}
+
+/****************************************************************
+ * UArray2_new_layout
+ * Description: Create a new unboxed 2D array stored in a custom
+ *              order
+ * Inputs: 1) Integer width, height and byte-size of the elements
+ *         2) Pointer to the UArray2_layout
+ * Output: UArray2_T type array
+ * Implementation: Allocate as many zeroed slots as the layout asks
+ *                 for. Stride and step are unused, since every
+ *                 access goes through layout->index.
+ *****************************************************************/
+T UArray2_new_layout(int width, int height, int size,
+                     const UArray2_layout *layout)
 {
     assert(width >= 0 && height >= 0);
     assert(size > 0);
+    assert(layout != NULL && layout->length != NULL &&
+           layout->index != NULL);
 
+    long slots = slot_count(layout->length(width, height), size);
     T uarray2;
     NEW(uarray2);
 
-    uarray2->array = UArray_new(width * height, size);
     uarray2->width = width;
     uarray2->height = height;
     uarray2->size = size;
+    uarray2->stride = 0;
+    uarray2->step = 0;
+    uarray2->elems = CALLOC(slots, size);
+    uarray2->layout = layout;
+    uarray2->owner = 1;
+    uarray2->map = NULL;
+    uarray2->map_length = 0;
+
+    return uarray2;
+}
+
+/****************************************************************
+ * UArray2_new_aligned
+ * Description: Create a new unboxed 2D array in one aligned block
+ * Inputs: 1) Integer width, height and byte-size of the elements
+ *         2) Alignment of the block in bytes
+ * Output: UArray2_T type array
+ * Implementation: The elements come first, so they get the block's
+ *                 alignment without padding in front, and the header
+ *                 goes after them. Huge pages are asked for before
+ *                 the elements are zeroed, so the first touch of the
+ *                 memory can already get them. UArray2_free knows
+ *                 from the owner that freeing the elements frees
+ *                 the header too.
+ *****************************************************************/
+T UArray2_new_aligned(int width, int height, int size, size_t alignment)
+{
+    assert(width >= 0 && height >= 0);
+    assert(size > 0);
+    assert(alignment >= sizeof(void *) &&
+           (alignment & (alignment - 1)) == 0);
+
+    size_t row_alignment = alignment < UArray2_CACHE_LINE ?
+                           alignment : UArray2_CACHE_LINE;
+    size_t stride = round_up((size_t) width * size, row_alignment);
+    if (height != 0 && stride > (size_t) LONG_MAX / height) {
+        RAISE(Mem_Failed);
+    }
+    size_t header_at = round_up(stride * height, sizeof(uint64_t));
+    size_t bytes = header_at + sizeof(struct T);
+
+    void *block;
+    if (posix_memalign(&block, alignment, bytes) != 0) {
+        RAISE(Mem_Failed);
+    }
+#ifdef MADV_HUGEPAGE
+    if (alignment % UArray2_HUGE_PAGE == 0) {
+        madvise(block, header_at, MADV_HUGEPAGE);
+    }
+#endif
+    memset(block, 0, header_at);
+
+    T uarray2 = (T) ((char *) block + header_at);
+    uarray2->width = width;
+    uarray2->height = height;
+    uarray2->size = size;
+    uarray2->stride = stride;
+    uarray2->step = size;
+    uarray2->elems = block;
+    uarray2->layout = NULL;
+    uarray2->owner = OWNER_BLOCK;
+    uarray2->map = NULL;
+    uarray2->map_length = 0;
+
+    return uarray2;
+}
+
+/****************************************************************
+ * UArray2_new_arena
+ * Description: Create a new unboxed 2D array in an arena
+ * Inputs: 1) Arena_T to allocate from
+ *         2) Integer width, height and byte-size of the elements
+ * Output: UArray2_T type array
+ * Implementation: Same as a row-major UArray2_new, with the header
+ *                 and zeroed elements from the arena. The owner
+ *                 tells UArray2_free to leave both alone.
+ *****************************************************************/
+T UArray2_new_arena(Arena_T arena, int width, int height, int size)
+{
+    assert(arena != NULL);
+    assert(width >= 0 && height >= 0);
+    assert(size > 0);
+
+    long slots = slot_count((uint64_t) width * height, size);
+    T uarray2 = Arena_alloc(arena, sizeof(*uarray2), __FILE__, __LINE__);
+
+    uarray2->width = width;
+    uarray2->height = height;
+    uarray2->size = size;
+    uarray2->stride = (size_t) width * size;
+    uarray2->step = size;
+    uarray2->elems = Arena_calloc(arena, slots, size, __FILE__, __LINE__);
+    uarray2->layout = NULL;
+    uarray2->owner = OWNER_ARENA;
+    uarray2->map = NULL;
+    uarray2->map_length = 0;
+
+    return uarray2;
+}
+
+/****************************************************************
+ * UArray2_wrap
+ * Description: Create an unboxed 2D array over a caller's buffer
+ * Inputs: 1) Pointer to element [0, 0] of the buffer
+ *         2) Integer width, height and byte-size of each element
+ *         3) Integer stride, bytes from one row to the next
+ * Output: UArray2_T type array that uses the buffer in place
+ * Implementation: Only the header is allocated. elems is the buffer
+ *                 and owner and map are unset, so UArray2_free
+ *                 leaves the buffer alone.
+ *****************************************************************/
+T UArray2_wrap(void *elems, int width, int height, int size, int stride)
+{
+    assert(width >= 0 && height >= 0);
+    assert(size > 0);
+    assert((size_t) stride >= (size_t) width * size);
+    assert(elems != NULL || width == 0 || height == 0);
+
+    T uarray2;
+    NEW(uarray2);
+
+    uarray2->width = width;
+    uarray2->height = height;
+    uarray2->size = size;
+    uarray2->stride = (size_t) stride;
+    uarray2->step = size;
+    uarray2->elems = (char *) elems;
+    uarray2->layout = NULL;
+    uarray2->owner = 0;
+    uarray2->map = NULL;
+    uarray2->map_length = 0;
+
+    return uarray2;
+}
+
+/****************************************************************
+ * UArray2_view
+ * Description: Create an unboxed 2D array for a rectangle of
+ *              another one, without copying
+ * Inputs: 1) UArray2_T type array being viewed
+ *         2) Integer column i and row j of the rectangle's corner
+ *         3) Integer width and height of the rectangle
+ * Output: UArray2_T type array whose [0, 0] is [i, j] of the other
+ * Implementation: Check the rectangle is inside the array, then
+ *                 wrap the array's own memory from element [i, j]
+ *                 with the array's stride and step.
+ *****************************************************************/
+T UArray2_view(T uarray2, int i, int j, int width, int height)
+{
+    assert(uarray2 != NULL);
+    assert(uarray2->layout == NULL);
+    assert(width >= 0 && height >= 0);
+    assert(i >= 0 && j >= 0);
+    assert(i + width <= uarray2->width && j + height <= uarray2->height);
+
+    char *corner = NULL;
+    if (width > 0 && height > 0) {
+        corner = uarray2->elems + j * uarray2->stride + i * uarray2->step;
+    }
+
+    T view;
+    NEW(view);
+
+    view->width = width;
+    view->height = height;
+    view->size = uarray2->size;
+    view->stride = uarray2->stride;
+    view->step = uarray2->step;
+    view->elems = corner;
+    view->layout = NULL;
+    view->owner = 0;
+    view->map = NULL;
+    view->map_length = 0;
+
+    return view;
+}
+
+/****************************************************************
+ * UArray2_map_file
+ * Description: Create an unboxed 2D array backed by a file that is
+ *              mapped into memory
+ * Inputs: 1) Path of the file
+ *         2) Integer width, height and byte-size of each element,
+ *            or 0 to take them from the file's header
+ *         3) UArray2_READONLY, UArray2_PRIVATE or UArray2_SHARED
+ * Output: UArray2_T type array, or NULL if the file could not be
+ *         opened, created or mapped, or its header does not match
+ * Implementation: Open the file, creating it for UArray2_SHARED if
+ *                 needed. An empty file is sized to hold the header
+ *                 and the elements, and gets a fresh header. Map the
+ *                 whole file, check the header, and point elems just
+ *                 past it. The file descriptor is not needed once the
+ *                 mapping exists, so it is closed right away.
+ *****************************************************************/
+T UArray2_map_file(const char *path, int width, int height, int size,
+                   UArray2_mapmode mode)
+{
+    assert(path != NULL);
+    assert(width >= 0 && height >= 0 && size >= 0);
+    assert(mode == UArray2_READONLY || mode == UArray2_PRIVATE ||
+           mode == UArray2_SHARED);
+
+    int fd;
+    if (mode == UArray2_SHARED) {
+        fd = open(path, O_RDWR | O_CREAT, 0666);
+    }
+    else {
+        fd = open(path, O_RDONLY);
+    }
+    if (fd < 0) {
+        return NULL;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return NULL;
+    }
+    size_t file_length = (size_t) info.st_size;
+
+    /* a new output file gets room for the header and the elements */
+    int fresh = 0;
+    if (file_length == 0 && mode == UArray2_SHARED) {
+        if (size == 0 || (uint64_t) width * height >
+                         (SIZE_MAX - FILE_HEADER_SIZE) / size) {
+            close(fd);
+            return NULL;
+        }
+        file_length = FILE_HEADER_SIZE +
+                      (size_t) width * (size_t) height * (size_t) size;
+        if (ftruncate(fd, (off_t) file_length) != 0) {
+            close(fd);
+            return NULL;
+        }
+        fresh = 1;
+    }
+    if (file_length < FILE_HEADER_SIZE) {
+        close(fd);
+        return NULL;
+    }
+
+    int prot = PROT_READ;
+    int flags = MAP_PRIVATE;
+    if (mode == UArray2_PRIVATE) {
+        prot = PROT_READ | PROT_WRITE;
+    }
+    else if (mode == UArray2_SHARED) {
+        prot = PROT_READ | PROT_WRITE;
+        flags = MAP_SHARED;
+    }
+    void *map = mmap(NULL, file_length, prot, flags, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return NULL;
+    }
+
+    struct file_header *header = (struct file_header *) map;
+    if (fresh) {
+        memset(header, 0, FILE_HEADER_SIZE);
+        memcpy(header->magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+        header->version = FILE_VERSION;
+        header->size = (uint32_t) size;
+        header->width = (uint64_t) width;
+        header->height = (uint64_t) height;
+        header->offset = FILE_HEADER_SIZE;
+    }
+    else if (!header_matches(header, file_length, width, height, size)) {
+        munmap(map, file_length);
+        return NULL;
+    }
+
+    T uarray2;
+    NEW(uarray2);
+
+    uarray2->width = (int) header->width;
+    uarray2->height = (int) header->height;
+    uarray2->size = (int) header->size;
+    uarray2->stride = (size_t) header->width * header->size;
+    uarray2->step = header->size;
+    uarray2->elems = (char *) map + header->offset;
+    uarray2->layout = NULL;
+    uarray2->owner = 0;
+    uarray2->map = map;
+    uarray2->map_length = file_length;
 
     return uarray2;
 }
 
+/****************************************************************
+ * round_up
+ * Description: Round a number of bytes up to a multiple of an
+ *              alignment
+ * Inputs: Bytes, and an alignment that is a power of two
+ * Output: The rounded bytes
+ *****************************************************************/
+static size_t round_up(size_t bytes, size_t alignment)
+{
+    return (bytes + alignment - 1) & ~(alignment - 1);
+}
+
+/****************************************************************
+ * slot_count
+ * Description: Count the slots to allocate for an array's elements
+ * Inputs: 1) Number of element slots, in 64 bits
+ *         2) Integer byte-size of an element
+ * Output: One more than the slots, as a long for CALLOC, so that an
+ *         empty array still gets a block
+ * Implementation: Mem_calloc takes its count and size as longs and
+ *                 multiplies them, so the bytes must fit in a long.
+ *                 If they do not, raise Mem_Failed, as running out
+ *                 of memory would, rather than wrap around and hand
+ *                 back a block that is too small.
+ *****************************************************************/
+static long slot_count(uint64_t slots, int size)
+{
+    if (slots >= (uint64_t) LONG_MAX / size) {
+        RAISE(Mem_Failed);
+    }
+    return (long) slots + 1;
+}
+
+/****************************************************************
+ * header_matches
+ * Description: Check that a mapped file holds a usable array
+ * Inputs: 1) Header at the start of the mapping
+ *         2) Length of the file in bytes
+ *         3) Integer width, height and size asked for, 0 for any
+ * Output: 1 if the header is valid, agrees with the requested
+ *         shape and the file is long enough, otherwise 0
+ * Implementation: Check magic and version, then that the dimensions
+ *                 fit in an int and the elements fit in the file,
+ *                 checking the offset is inside the file before
+ *                 taking it from the length.
+ *****************************************************************/
+static int header_matches(struct file_header *header, size_t file_length,
+                          int width, int height, int size)
+{
+    if (memcmp(header->magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 ||
+        header->version != FILE_VERSION ||
+        header->offset < FILE_HEADER_SIZE || header->size == 0 ||
+        header->width > INT32_MAX || header->height > INT32_MAX ||
+        header->size > INT32_MAX) {
+        return 0;
+    }
+    if ((width != 0 && header->width != (uint64_t) width) ||
+        (height != 0 && header->height != (uint64_t) height) ||
+        (size != 0 && header->size != (uint64_t) size)) {
+        return 0;
+    }
+
+    uint64_t elements = header->width * header->height;
+    if (header->width != 0 && elements / header->width != header->height) {
+        return 0;
+    }
+    if (header->offset > file_length ||
+        elements > (file_length - header->offset) / header->size) {
+        return 0;
+    }
+    return 1;
+}
+
 /******************************************************************
  * UArray2_width
  * Description: Get width value of unboxed array which is the
@@ -118,25 +607,59 @@ int UArray2_size(T uarray2)
  * Implementation: Check if unboxed array is not null. Also, check if
  *                 parameter index i is positive and less than width,
  *                 and if parameter index j is positive and less than
- *                 height of the unboxed array. Index of our 2D
- *                 unboxed array will correspond to width * j + i index
- *                 of UArray unboxed array, where we will be getting 
- *                 the value from.
+ *                 height of the unboxed array. Element [i, j] is j
+ *                 strides and i elements past element [0, 0], where
+ *                 we will be getting the value from, whether they
+ *                 live in our block, in a file or in someone else's
+ *                 memory. The code is UArray2_at_fast, shared with
+ *                 uarray2_inline.h.
  ******************************************************************/
 void *UArray2_at(T uarray2, int i, int j)
 {
-    assert(uarray2 != NULL);
-
-    int width = UArray2_width(uarray2);
-    int height = UArray2_height(uarray2);
-
-    assert(i >= 0 && i < width && j >= 0 && j < height);
+    return UArray2_at_fast(uarray2, i, j);
+}
 
-    int index = width * j + i;
+/******************************************************************
+ * UArray2_map
+ * Description: Apply a function to every element in storage order
+ * Inputs: Same as UArray2_map_row_major
+ * Output: Void
+ * Implementation: Without a layout, the smaller of step and stride
+ *                 is the direction that is contiguous in memory. A
+ *                 layout with an element function is walked slot by
+ *                 slot, skipping slots it does not use.
+ ******************************************************************/
+void UArray2_map(T uarray2, void apply(int i, int j, T uarray2,
+                 void *value, void *cl), void *cl)
+{
+    assert(uarray2 != NULL);
+    assert(apply != NULL);
 
-    void *element = UArray_at(uarray2->array, index);
+    const UArray2_layout *layout = uarray2->layout;
+    if (layout == NULL) {
+        if (uarray2->step <= uarray2->stride) {
+            UArray2_map_row_major(uarray2, apply, cl);
+        }
+        else {
+            UArray2_map_col_major(uarray2, apply, cl);
+        }
+        return;
+    }
+    if (layout->element == NULL) {
+        UArray2_map_row_major(uarray2, apply, cl);
+        return;
+    }
 
-    return element;
+    int width = uarray2->width;
+    int height = uarray2->height;
+    size_t length = layout->length(width, height);
+    for (size_t slot = 0; slot < length; slot++) {
+        int idx, jdx;
+        if (layout->element(slot, width, height, &idx, &jdx)) {
+            apply(idx, jdx, uarray2, uarray2->elems + slot * uarray2->size,
+                  cl);
+        }
+    }
 }
 
 /*****************************************************************
@@ -165,7 +688,7 @@ void UArray2_map_col_major(T uarray2, void apply(int i, int j, T uarray2,
 
     for (int idx = 0; idx < width; idx++) {
         for (int jdx = 0; jdx < height; jdx++) {
-            apply(idx, jdx, uarray2, UArray2_at(uarray2, idx, jdx), cl);
+            apply(idx, jdx, uarray2, UArray2_at_fast(uarray2, idx, jdx), cl);
         }
     }
 
@@ -197,26 +720,637 @@ void UArray2_map_row_major(T uarray2, void apply(int i, int j, T uarray2,
 
     for (int jdx = 0; jdx < height; jdx++) {
         for (int idx = 0; idx < width; idx++) {
-            apply(idx, jdx, uarray2, UArray2_at(uarray2, idx, jdx), cl);
+            apply(idx, jdx, uarray2, UArray2_at_fast(uarray2, idx, jdx), cl);
         }
     }
 
 } 
 
+/******************************************************************
+ * UArray2_map_row_major_until
+ * Description: Apply a function to the elements row by row until it
+ *              asks to stop
+ * Inputs: 1) UArray2_T type unboxed array
+ *         2) An int apply function, nonzero meaning stop
+ *         3) A void pointer closure
+ *         4) Integer pointers for where it stopped, or null
+ * Output: 1 if apply stopped the traversal, 0 if it did not
+ * Implementation: Return as soon as apply returns nonzero.
+ ******************************************************************/
+int UArray2_map_row_major_until(T uarray2, int apply(int i, int j,
+                                T uarray2, void *value, void *cl),
+                                void *cl, int *stop_i, int *stop_j)
+{
+    assert(uarray2 != NULL);
+    assert(apply != NULL);
+
+    for (int jdx = 0; jdx < uarray2->height; jdx++) {
+        for (int idx = 0; idx < uarray2->width; idx++) {
+            if (apply(idx, jdx, uarray2, UArray2_at_fast(uarray2, idx, jdx),
+                      cl)) {
+                if (stop_i != NULL) {
+                    *stop_i = idx;
+                }
+                if (stop_j != NULL) {
+                    *stop_j = jdx;
+                }
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+/******************************************************************
+ * UArray2_map_col_major_until
+ * Description: Apply a function to the elements column by column
+ *              until it asks to stop
+ * Inputs: Same as UArray2_map_row_major_until
+ * Output: 1 if apply stopped the traversal, 0 if it did not
+ * Implementation: Return as soon as apply returns nonzero.
+ ******************************************************************/
+int UArray2_map_col_major_until(T uarray2, int apply(int i, int j,
+                                T uarray2, void *value, void *cl),
+                                void *cl, int *stop_i, int *stop_j)
+{
+    assert(uarray2 != NULL);
+    assert(apply != NULL);
+
+    for (int idx = 0; idx < uarray2->width; idx++) {
+        for (int jdx = 0; jdx < uarray2->height; jdx++) {
+            if (apply(idx, jdx, uarray2, UArray2_at_fast(uarray2, idx, jdx),
+                      cl)) {
+                if (stop_i != NULL) {
+                    *stop_i = idx;
+                }
+                if (stop_j != NULL) {
+                    *stop_j = jdx;
+                }
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+/******************************************************************
+ * UArray2_orient
+ * Description: Make a transposed, rotated or flipped copy of an
+ *              unboxed array
+ * Inputs: 1) UArray2_T type unboxed array
+ *         2) UArray2_orientation saying how to turn it
+ * Output: New UArray2_T type array
+ * Implementation: Turns that swap rows and columns give a height by
+ *                 width array. UArray2_orient_into fills it.
+ ******************************************************************/
+T UArray2_orient(T uarray2, UArray2_orientation how)
+{
+    assert(uarray2 != NULL);
+
+    int swap = how == UArray2_TRANSPOSE || how == UArray2_ROTATE_90 ||
+               how == UArray2_ROTATE_270;
+    T result = UArray2_new(swap ? uarray2->height : uarray2->width,
+                           swap ? uarray2->width : uarray2->height,
+                           uarray2->size);
+
+    UArray2_orient_into(result, uarray2, how);
+    return result;
+}
+
+/******************************************************************
+ * UArray2_orient_into
+ * Description: Write a transposed, rotated or flipped copy of an
+ *              unboxed array into another
+ * Inputs: 1) UArray2_T type array to write
+ *         2) UArray2_T type array to read
+ *         3) UArray2_orientation saying how to turn it
+ * Output: Void
+ * Implementation: Every turn reads source element [u, v] for
+ *                 destination element [i, j], where (u, v) is (i, j)
+ *                 or (j, i), and u or v may be mirrored. So the
+ *                 source element for [i, j] is a fixed origin plus i
+ *                 steps of step_i bytes and j of step_j, and one loop
+ *                 does them all. The destination is written a
+ *                 contiguous line (row, or column if it is column-
+ *                 major) at a time. When going along a line jumps
+ *                 across source lines, the copy is done in tiles
+ *                 small enough that every source line a tile touches
+ *                 stays in the cache until the tile is done. Custom
+ *                 layouts go through orient_elements.
+ ******************************************************************/
+void UArray2_orient_into(T dest, T source, UArray2_orientation how)
+{
+    assert(dest != NULL && source != NULL);
+    assert(dest->size == source->size);
+
+    int swap = 0, mirror_u = 0, mirror_v = 0;
+    switch (how) {
+    case UArray2_TRANSPOSE:       swap = 1;                  break;
+    case UArray2_ROTATE_90:       swap = 1; mirror_v = 1;    break;
+    case UArray2_ROTATE_180:      mirror_u = 1; mirror_v = 1; break;
+    case UArray2_ROTATE_270:      swap = 1; mirror_u = 1;    break;
+    case UArray2_FLIP_HORIZONTAL: mirror_u = 1;              break;
+    case UArray2_FLIP_VERTICAL:   mirror_v = 1;              break;
+    default:                      assert(0);
+    }
+
+    int width = dest->width;
+    int height = dest->height;
+    assert(width == (swap ? source->height : source->width));
+    assert(height == (swap ? source->width : source->height));
+    if (width == 0 || height == 0) {
+        return;
+    }
+
+    int size = source->size;
+    ptrdiff_t step_u = mirror_u ? -(ptrdiff_t) source->step
+                                : (ptrdiff_t) source->step;
+    ptrdiff_t step_v = mirror_v ? -(ptrdiff_t) source->stride
+                                : (ptrdiff_t) source->stride;
+
+    /* lines are the destination's contiguous rows or columns */
+    size_t line_stride;
+    int line_length, lines;
+    ptrdiff_t along, across;
+    if (dest->layout == NULL && source->layout == NULL &&
+        dest->step == (size_t) size) {
+        line_stride = dest->stride;
+        line_length = width;
+        lines = height;
+        along = swap ? step_v : step_u;
+        across = swap ? step_u : step_v;
+    }
+    else if (dest->layout == NULL && source->layout == NULL &&
+             dest->stride == (size_t) size) {
+        line_stride = dest->step;
+        line_length = height;
+        lines = width;
+        along = swap ? step_u : step_v;
+        across = swap ? step_v : step_u;
+    }
+    else {
+        orient_elements(dest, source, swap, mirror_u, mirror_v);
+        return;
+    }
+
+    const char *origin = source->elems;
+    if (mirror_u) {
+        origin += (source->width - 1) * source->step;
+    }
+    if (mirror_v) {
+        origin += (source->height - 1) * source->stride;
+    }
+
+    if (along == size || along == -size) {
+        copy_block(dest->elems, line_stride, origin, along, across,
+                   line_length, lines, size);
+        return;
+    }
+    for (int line = 0; line < lines; line += TILE) {
+        int tile_lines = lines - line < TILE ? lines - line : TILE;
+        for (int k = 0; k < line_length; k += TILE) {
+            int tile_length = line_length - k < TILE ? line_length - k
+                                                     : TILE;
+            copy_block(dest->elems + line * line_stride + (size_t) k * size,
+                       line_stride, origin + k * along + line * across,
+                       along, across, tile_length, tile_lines, size);
+        }
+    }
+}
+
+/******************************************************************
+ * UArray2_fill
+ * Description: Set every element of a rectangle to one value
+ * Inputs: 1) UArray2_T type unboxed array
+ *         2) Integer column i and row j of the rectangle's corner
+ *         3) Integer width and height of the rectangle
+ *         4) Pointer to an element-sized value
+ * Output: Void
+ * Implementation: Work along the contiguous lines of the rectangle,
+ *                 its rows, or its columns in a column-major array.
+ *                 A value whose bytes are all the same is a memset,
+ *                 done in one call when the lines are back to back.
+ *                 Otherwise the first line is built by copying the
+ *                 value and then doubling what is done, and the
+ *                 other lines are copies of the first. A custom
+ *                 layout is filled one element at a time.
+ ******************************************************************/
+void UArray2_fill(T uarray2, int i, int j, int width, int height,
+                  const void *value)
+{
+    assert(uarray2 != NULL && value != NULL);
+    assert(width >= 0 && height >= 0 && i >= 0 && j >= 0);
+    assert(i + width <= uarray2->width && j + height <= uarray2->height);
+
+    if (width == 0 || height == 0) {
+        return;
+    }
+
+    int size = uarray2->size;
+    char *first;
+    size_t stride;
+    int line_length, lines;
+    if (rect_lines(uarray2, i, j, width, height, &first, &stride,
+                   &line_length, &lines) == 0) {
+        for (int row = j; row < j + height; row++) {
+            for (int col = i; col < i + width; col++) {
+                memcpy(UArray2_at_fast(uarray2, col, row), value, size);
+            }
+        }
+        return;
+    }
+
+    size_t line_bytes = (size_t) line_length * size;
+    const unsigned char *bytes = value;
+
+    int same = 1;
+    for (int k = 1; k < size; k++) {
+        if (bytes[k] != bytes[0]) {
+            same = 0;
+        }
+    }
+
+    if (same && line_bytes == stride) {
+        memset(first, bytes[0], line_bytes * lines);
+        return;
+    }
+    if (same) {
+        for (int line = 0; line < lines; line++) {
+            memset(first + line * stride, bytes[0], line_bytes);
+        }
+        return;
+    }
+
+    memcpy(first, value, size);
+    for (size_t done = size; done < line_bytes; done *= 2) {
+        memcpy(first + done, first,
+               done < line_bytes - done ? done : line_bytes - done);
+    }
+    for (int line = 1; line < lines; line++) {
+        memcpy(first + line * stride, first, line_bytes);
+    }
+}
+
+/******************************************************************
+ * UArray2_copy
+ * Description: Copy a rectangle of one unboxed array into another
+ * Inputs: 1) UArray2_T type array to write, and the corner to write
+ *            at
+ *         2) UArray2_T type array to read, and the corner to read
+ *            from
+ *         3) Integer width and height of the rectangle
+ * Output: Void
+ * Implementation: When both arrays store the rectangle in the same
+ *                 order, one memcpy per row (or column), or one for
+ *                 the whole rectangle when the lines are back to
+ *                 back in both. Otherwise one element at a time.
+ ******************************************************************/
+void UArray2_copy(T dest, int i, int j, T source, int source_i,
+                  int source_j, int width, int height)
+{
+    assert(dest != NULL && source != NULL);
+    assert(dest->size == source->size);
+    assert(width >= 0 && height >= 0);
+    assert(i >= 0 && j >= 0 && source_i >= 0 && source_j >= 0);
+    assert(i + width <= dest->width && j + height <= dest->height);
+    assert(source_i + width <= source->width &&
+           source_j + height <= source->height);
+
+    if (width == 0 || height == 0) {
+        return;
+    }
+
+    int size = dest->size;
+    char *to = NULL, *from = NULL;
+    size_t to_stride = 0, from_stride = 0;
+    int line_length, lines;
+    int to_kind = rect_lines(dest, i, j, width, height, &to, &to_stride,
+                             &line_length, &lines);
+    int from_kind = rect_lines(source, source_i, source_j, width, height,
+                               &from, &from_stride, &line_length, &lines);
+
+    if (to_kind == 0 || to_kind != from_kind) {
+        for (int row = 0; row < height; row++) {
+            for (int col = 0; col < width; col++) {
+                memcpy(UArray2_at_fast(dest, i + col, j + row),
+                       UArray2_at_fast(source, source_i + col,
+                                       source_j + row), size);
+            }
+        }
+        return;
+    }
+
+    size_t line_bytes = (size_t) line_length * size;
+    if (line_bytes == to_stride && line_bytes == from_stride) {
+        memcpy(to, from, line_bytes * lines);
+        return;
+    }
+    for (int line = 0; line < lines; line++) {
+        memcpy(to + line * to_stride, from + line * from_stride,
+               line_bytes);
+    }
+}
+
+/******************************************************************
+ * UArray2_clone
+ * Description: Make a copy of a whole unboxed array
+ * Inputs: UArray2_T type unboxed array
+ * Output: New UArray2_T type array owning a copy of the elements
+ * Implementation: Make a new array of the same shape and storage
+ *                 order. A custom layout's slots are copied as one
+ *                 block; other arrays, which may be views, go
+ *                 through UArray2_copy.
+ ******************************************************************/
+T UArray2_clone(T uarray2)
+{
+    assert(uarray2 != NULL);
+
+    int width = uarray2->width;
+    int height = uarray2->height;
+    int size = uarray2->size;
+    const UArray2_layout *layout = uarray2->layout;
+
+    if (layout != NULL) {
+        T clone = UArray2_new_layout(width, height, size, layout);
+        memcpy(clone->elems, uarray2->elems,
+               layout->length(width, height) * size);
+        return clone;
+    }
+
+    UArray2_order order = uarray2->step <= uarray2->stride ?
+                          UArray2_ROW_MAJOR : UArray2_COL_MAJOR;
+    T clone = UArray2_new_ordered(width, height, size, order);
+    UArray2_copy(clone, 0, 0, uarray2, 0, 0, width, height);
+    return clone;
+}
+
 /******************************************************************
  * UArray2_free
  * Description: Deallocate memory used by unboxed array
  * Inputs: An address to unboxed array
  * Output: Void
  * Implementation: Check if unboxed array or element inside are not
- *.                null. Then, free any allocated memery of UArray
- *                 unboxed array and our unboxed array.
+ *.                null. Then, free the elements if we allocated them
+ *                 (or unmap the file, which writes back
+ *                 a shared mapping) and our unboxed array. A view
+ *                 owns neither, so only the view itself is freed.
+ *                 An array from UArray2_new_aligned is one block,
+ *                 freed all at once, and one from UArray2_new_arena
+ *                 is left for its arena.
  ******************************************************************/
 void UArray2_free(T *uarray2)
 {
     assert(uarray2 != NULL && *uarray2 != NULL);
-    assert((*uarray2)->array != NULL);
 
-    UArray_free(&((*uarray2)->array));
+    if ((*uarray2)->map != NULL) {
+        munmap((*uarray2)->map, (*uarray2)->map_length);
+    }
+    else if ((*uarray2)->owner == OWNER_ARENA) {
+        return;
+    }
+    else if ((*uarray2)->owner == OWNER_BLOCK) {
+        free((*uarray2)->elems);
+        return;
+    }
+    else if ((*uarray2)->owner) {
+        FREE((*uarray2)->elems);
+    }
     free(*uarray2);
-}
\ No newline at end of file
+}
+
+/******************************************************************
+ * copy_block
+ * Description: Copy width by height elements into a block of an
+ *              array from elements read at arbitrary steps
+ * Inputs: 1) Pointer to the first destination element, and the
+ *            destination stride in bytes
+ *         2) Pointer to the first source element, and the bytes
+ *            between source elements along a destination row
+ *            (step_i) and between destination rows (step_j)
+ *         3) Integer width, height and element size
+ * Output: Void
+ * Implementation: Rows read in order are copied with memcpy. Other
+ *                 blocks go through copy_elements, called with a
+ *                 constant size for the common element sizes so each
+ *                 call becomes a loop of plain loads and stores.
+ ******************************************************************/
+static void copy_block(char *dest, size_t dest_stride, const char *source,
+                       ptrdiff_t step_i, ptrdiff_t step_j, int width,
+                       int height, int size)
+{
+    if (step_i == size) {
+        for (int j = 0; j < height; j++) {
+            memcpy(dest + j * dest_stride, source + j * step_j,
+                   (size_t) width * size);
+        }
+        return;
+    }
+
+    switch (size) {
+    case 1:
+        copy_elements(dest, dest_stride, source, step_i, step_j,
+                      width, height, 1);
+        break;
+    case 2:
+        copy_elements(dest, dest_stride, source, step_i, step_j,
+                      width, height, 2);
+        break;
+    case 4:
+        copy_elements(dest, dest_stride, source, step_i, step_j,
+                      width, height, 4);
+        break;
+    case 8:
+        copy_elements(dest, dest_stride, source, step_i, step_j,
+                      width, height, 8);
+        break;
+    default:
+        copy_elements(dest, dest_stride, source, step_i, step_j,
+                      width, height, size);
+    }
+}
+
+/******************************************************************
+ * copy_elements
+ * Description: The loop of copy_block, one element at a time
+ * Inputs: Same as copy_block
+ * Output: Void
+ ******************************************************************/
+static inline void copy_elements(char *dest, size_t dest_stride,
+                                 const char *source, ptrdiff_t step_i,
+                                 ptrdiff_t step_j, int width, int height,
+                                 int size)
+{
+    for (int j = 0; j < height; j++) {
+        char *to = dest + j * dest_stride;
+        const char *from = source + j * step_j;
+        for (int i = 0; i < width; i++) {
+            memcpy(to, from, size);
+            to += size;
+            from += step_i;
+        }
+    }
+}
+
+/******************************************************************
+ * orient_elements
+ * Description: Turn an array one element at a time
+ * Inputs: 1) UArray2_T type arrays to write and to read
+ *         2) Integer flags: swap rows and columns, mirror source
+ *            columns, mirror source rows
+ * Output: Void
+ * Implementation: Find the source element of every destination
+ *                 element and copy it. Used when either array has a
+ *                 custom layout, so there are no steps to follow.
+ ******************************************************************/
+static void orient_elements(T dest, T source, int swap, int mirror_u,
+                            int mirror_v)
+{
+    for (int j = 0; j < dest->height; j++) {
+        for (int i = 0; i < dest->width; i++) {
+            int u = swap ? j : i;
+            int v = swap ? i : j;
+            if (mirror_u) {
+                u = source->width - 1 - u;
+            }
+            if (mirror_v) {
+                v = source->height - 1 - v;
+            }
+            memcpy(UArray2_at_fast(dest, i, j),
+                   UArray2_at_fast(source, u, v), source->size);
+        }
+    }
+}
+
+/******************************************************************
+ * rect_lines
+ * Description: Describe a rectangle of an array as contiguous lines
+ * Inputs: 1) UArray2_T type unboxed array without a custom layout
+ *         2) Integer corner and size of a rectangle inside it
+ *         3) Pointers for the first element, the bytes from one
+ *            line to the next, the elements per line and the
+ *            number of lines
+ * Output: 1 if the lines are rows, 2 if they are columns, and 0 if
+ *         neither is contiguous, with the pointers left alone
+ * Implementation: Rows are contiguous when the step is one element,
+ *                 columns when the stride is.
+ ******************************************************************/
+static int rect_lines(T uarray2, int i, int j, int width, int height,
+                      char **first, size_t *line_stride,
+                      int *line_length, int *lines)
+{
+    size_t size = uarray2->size;
+
+    if (uarray2->layout != NULL) {
+        return 0;
+    }
+    *first = uarray2->elems + j * uarray2->stride + i * uarray2->step;
+    if (uarray2->step == size) {
+        *line_stride = uarray2->stride;
+        *line_length = width;
+        *lines = height;
+        return 1;
+    }
+    if (uarray2->stride == size) {
+        *line_stride = uarray2->step;
+        *line_length = height;
+        *lines = width;
+        return 2;
+    }
+    return 0;
+}
+
+/******************************************************************
+ * index_bits
+ * Description: Number of bits needed for the indices of a dimension
+ * Inputs: Integer length of the dimension
+ * Output: Smallest b with 2 to the b at least the length
+ ******************************************************************/
+static int index_bits(int length)
+{
+    int bits = 0;
+    while (bits < 31 && (1 << bits) < length) {
+        bits++;
+    }
+    return bits;
+}
+
+/******************************************************************
+ * spread_bits, gather_bits
+ * Description: Move the bits of a 32-bit value to the even bit
+ *              positions of a 64-bit one, and back
+ * Inputs: The value to spread or gather
+ * Output: The spread or gathered value
+ * Implementation: Halve the distance the bits move at every step,
+ *                 with masks that keep each group in its place.
+ ******************************************************************/
+static uint64_t spread_bits(uint32_t value)
+{
+    uint64_t bits = value;
+    bits = (bits | (bits << 16)) & 0x0000FFFF0000FFFFull;
+    bits = (bits | (bits << 8)) & 0x00FF00FF00FF00FFull;
+    bits = (bits | (bits << 4)) & 0x0F0F0F0F0F0F0F0Full;
+    bits = (bits | (bits << 2)) & 0x3333333333333333ull;
+    bits = (bits | (bits << 1)) & 0x5555555555555555ull;
+    return bits;
+}
+
+static uint32_t gather_bits(uint64_t bits)
+{
+    bits &= 0x5555555555555555ull;
+    bits = (bits | (bits >> 1)) & 0x3333333333333333ull;
+    bits = (bits | (bits >> 2)) & 0x0F0F0F0F0F0F0F0Full;
+    bits = (bits | (bits >> 4)) & 0x00FF00FF00FF00FFull;
+    bits = (bits | (bits >> 8)) & 0x0000FFFF0000FFFFull;
+    bits = (bits | (bits >> 16)) & 0x00000000FFFFFFFFull;
+    return (uint32_t) bits;
+}
+
+/******************************************************************
+ * morton_length, morton_index, morton_element
+ * Description: The UArray2_morton layout
+ * Inputs: As for the fields of UArray2_layout
+ * Output: As for the fields of UArray2_layout
+ * Implementation: The low bits of i and j that both dimensions have
+ *                 are interleaved, i in the even positions, and the
+ *                 extra high bits of the longer dimension go above
+ *                 them, so a long thin array is a row of square
+ *                 Z-ordered blocks and wastes less than a quarter of
+ *                 its slots.
+ ******************************************************************/
+static size_t morton_length(int width, int height)
+{
+    return (size_t) 1 << (index_bits(width) + index_bits(height));
+}
+
+static size_t morton_index(int i, int j, int width, int height)
+{
+    int bits_i = index_bits(width);
+    int bits_j = index_bits(height);
+    int shared = bits_i < bits_j ? bits_i : bits_j;
+    uint32_t low = ((uint32_t) 1 << shared) - 1;
+
+    return (spread_bits((uint32_t) i & low) |
+            spread_bits((uint32_t) j & low) << 1) |
+           (size_t) (((uint32_t) i >> shared) | ((uint32_t) j >> shared))
+           << (2 * shared);
+}
+
+static int morton_element(size_t slot, int width, int height, int *i,
+                          int *j)
+{
+    int bits_i = index_bits(width);
+    int bits_j = index_bits(height);
+    int shared = bits_i < bits_j ? bits_i : bits_j;
+    uint64_t low = ((uint64_t) 1 << (2 * shared)) - 1;
+    uint32_t high = (uint32_t) (slot >> (2 * shared));
+
+    *i = (int) gather_bits(slot & low);
+    *j = (int) gather_bits((slot & low) >> 1);
+    if (bits_i > bits_j) {
+        *i |= (int) (high << shared);
+    }
+    else {
+        *j |= (int) (high << shared);
+    }
+    return *i < width && *j < height;
+}
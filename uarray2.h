@@ -9,17 +9,73 @@
 * 
 * 
 *      Summary: This is the header file for the UArray2 data structure. 
-*               Our UArray2_T incorporate UArray_T unboxed array, allowing 
-*               for a representation of a 2D unboxed array.
+*               Our UArray2_T keeps its elements in one unboxed block,
+*               allowing for a representation of a 2D unboxed array.
+*               uarray2_inline.h has an inlined UArray2_at for hot loops.
+*               Indices are ints, but offsets are computed in size_t,
+*               so an array may hold more than 2^31 elements as long
+*               as each side is under 2^31.
 *     
 **************************************************************************/
 
 #ifndef UARRAY2_INCLUDED
 #define UARRAY2_INCLUDED
 
+#include <stddef.h>
+#include "arena.h"
+
 #define T UArray2_T
 typedef struct T *T;
 
+/* how UArray2_map_file maps its file */
+typedef enum {
+    UArray2_READONLY,   /* input, elements must not be written */
+    UArray2_PRIVATE,    /* input, writes stay in this process */
+    UArray2_SHARED      /* output, writes go to the file */
+} UArray2_mapmode;
+
+/* which index runs fastest in memory, for UArray2_new_ordered */
+typedef enum {
+    UArray2_ROW_MAJOR,          /* [i + 1, j] follows [i, j] */
+    UArray2_COL_MAJOR           /* [i, j + 1] follows [i, j] */
+} UArray2_order;
+
+/* alignments for UArray2_new_aligned */
+enum {
+    UArray2_CACHE_LINE = 64,            /* rows start on cache lines */
+    UArray2_HUGE_PAGE = 2 * 1024 * 1024 /* and the block on a huge page */
+};
+
+/*
+ * a custom storage order, for UArray2_new_layout. length gives the
+ * number of element slots a width by height array needs, and index
+ * the slot of element [i, j], which must differ for every element.
+ * element, which may be NULL, goes the other way: it sets i and j
+ * for a slot and returns 1, or returns 0 for a slot that is not used.
+ */
+typedef struct UArray2_layout {
+    size_t (*length)(int width, int height);
+    size_t (*index)(int i, int j, int width, int height);
+    int (*element)(size_t slot, int width, int height, int *i, int *j);
+} UArray2_layout;
+
+/*
+ * Morton (Z-order) layout: the bits of i and j are interleaved, so
+ * elements that are close in both directions are close in memory.
+ * It uses at most 4 * width * height slots.
+ */
+extern const UArray2_layout UArray2_morton;
+
+/* how UArray2_orient turns an array; rotations are clockwise */
+typedef enum {
+    UArray2_TRANSPOSE,          /* [i, j] goes to [j, i] */
+    UArray2_ROTATE_90,
+    UArray2_ROTATE_180,
+    UArray2_ROTATE_270,
+    UArray2_FLIP_HORIZONTAL,    /* mirror left to right */
+    UArray2_FLIP_VERTICAL       /* mirror top to bottom */
+} UArray2_orientation;
+
 /****************************************************************
  * UArray2_new
  * Description: Create a new unboxed 2D array with size of width
@@ -34,10 +90,151 @@ typedef struct T *T;
  *.             exit with assert.
  *              Otherwise, return an unboxed 2D array of given width
  *              & height with each element of given size.
+ *              If the elements cannot be allocated, or their total
+ *              bytes do not fit in a long, raise Mem_Failed.
  *****************************************************************/
 extern T UArray2_new(int width, int height, int size);
 
 
+/****************************************************************
+ * UArray2_new_ordered
+ * Description: Same as UArray2_new, but the caller chooses whether
+ *              rows or columns are contiguous in memory
+ * Inputs: 1) Integer width, height and byte-size, as for UArray2_new
+ *         2) UArray2_ROW_MAJOR (what UArray2_new gives) or
+ *            UArray2_COL_MAJOR
+ * Expectation: Same as UArray2_new.
+ * Output: UArray2_T type array. Indexing is the same whatever the
+ *         order; only the cost of walking rows or columns changes.
+ *****************************************************************/
+extern T UArray2_new_ordered(int width, int height, int size,
+                             UArray2_order order);
+
+
+/****************************************************************
+ * UArray2_new_layout
+ * Description: Same as UArray2_new, but elements are stored in a
+ *              custom order, such as UArray2_morton
+ * Inputs: 1) Integer width, height and byte-size, as for UArray2_new
+ *         2) Pointer to the UArray2_layout, which must outlive the
+ *            array
+ * Expectation: Same as UArray2_new, and layout with its length and
+ *              index functions must not be null.
+ * Output: UArray2_T type array. UArray2_view cannot be used on it.
+ *****************************************************************/
+extern T UArray2_new_layout(int width, int height, int size,
+                            const UArray2_layout *layout);
+
+
+/****************************************************************
+ * UArray2_new_aligned
+ * Description: Same as UArray2_new, but the array and its elements
+ *              are one allocation, and element [0, 0] is aligned
+ * Inputs: 1) Integer width, height and byte-size, as for UArray2_new
+ *         2) Alignment in bytes, a power of two at least the size
+ *            of a pointer, such as UArray2_CACHE_LINE
+ * Expectation: Same as UArray2_new, and the alignment must be a
+ *              power of two, or exit with assert.
+ * Output: UArray2_T type array. Every row starts on a boundary of
+ *         the alignment or 64 bytes, whichever is smaller, so rows
+ *         may be padded. With UArray2_HUGE_PAGE (or any multiple of
+ *         it) the elements are also marked for transparent huge
+ *         pages where the system has them.
+ * Expectation: If the block cannot be allocated, raise Mem_Failed.
+ *****************************************************************/
+extern T UArray2_new_aligned(int width, int height, int size,
+                             size_t alignment);
+
+
+/****************************************************************
+ * UArray2_new_arena
+ * Description: Same as UArray2_new, but the array and its elements
+ *              are allocated from a Hanson arena
+ * Inputs: 1) Arena_T to allocate from
+ *         2) Integer width, height and byte-size, as for UArray2_new
+ * Expectation: Same as UArray2_new, and the arena must not be null.
+ * Output: UArray2_T type array, released with everything else in
+ *         the arena by Arena_free or Arena_dispose. UArray2_free
+ *         may be called on it but frees nothing.
+ * Expectation: If the arena cannot grow, raise Arena_Failed.
+ *****************************************************************/
+extern T UArray2_new_arena(Arena_T arena, int width, int height, int size);
+
+
+/****************************************************************
+ * UArray2_map_file
+ * Description: Create an unboxed 2D array whose elements live in a
+ *              file mapped into memory. The file starts with a small
+ *              fixed header holding width, height and size, followed
+ *              by the elements row by row, so reopening a file costs
+ *              the same whatever its size.
+ * Inputs: 1) Path of the file
+ *         2) Integer value of width of the array, or 0
+ *         3) Integer value of height of the array, or 0
+ *         4) Integer value of byte-size of each element, or 0
+ *         5) UArray2_READONLY or UArray2_PRIVATE to map an existing
+ *            file, UArray2_SHARED to map a file and write to it,
+ *            creating it if it does not exist
+ * Expectation: Path must not be null and dimensions not negative.
+ *              A dimension of 0 means "whatever the file says"; a
+ *              non-zero dimension must agree with the file. A new
+ *              file is created with the given dimensions, which then
+ *              need a positive size.
+ *              Elements of a UArray2_READONLY array must not be
+ *              written.
+ * Output: UArray2_T type array, freed with UArray2_free
+ * Expectation: If path is null or a dimension is negative, exit
+ *              with assert.
+ *              If the file cannot be opened, created or mapped, or
+ *              its header is not valid or does not agree with the
+ *              given dimensions, return NULL.
+ *****************************************************************/
+extern T UArray2_map_file(const char *path, int width, int height,
+                          int size, UArray2_mapmode mode);
+
+
+/****************************************************************
+ * UArray2_wrap
+ * Description: Create an unboxed 2D array over a buffer owned by
+ *              the caller, without copying it
+ * Inputs: 1) Pointer to element [0, 0] of the buffer
+ *         2) Integer value of width of the array
+ *         3) Integer value of height of the array
+ *         4) Integer value of byte-size of each element
+ *         5) Integer value of stride, the number of bytes from the
+ *            start of one row to the start of the next
+ * Expectation: Width and height must not be negative, size must be
+ *              positive, and stride at least width * size. The
+ *              buffer must hold height rows and outlive the array.
+ * Output: UArray2_T type array that reads and writes the buffer
+ * Expectation: If a parameter is out of range, exit with assert.
+ *              UArray2_free frees the array but not the buffer.
+ *****************************************************************/
+extern T UArray2_wrap(void *elems, int width, int height, int size,
+                      int stride);
+
+
+/****************************************************************
+ * UArray2_view
+ * Description: Create an unboxed 2D array for a rectangle of
+ *              another unboxed array, without copying it
+ * Inputs: 1) UArray2_T type array being viewed
+ *         2) Integer value i, column of the rectangle's left side
+ *         3) Integer value j, row of the rectangle's top side
+ *         4) Integer value of width of the rectangle
+ *         5) Integer value of height of the rectangle
+ * Expectation: Parameter array must not be null and the rectangle
+ *              must be inside it. The array must outlive the view.
+ * Output: UArray2_T type array whose element [0, 0] is element
+ *         [i, j] of the array being viewed
+ * Expectation: If the array is null, has a custom layout, or the
+ *              rectangle is not inside it, exit with assert.
+ *              Writes through the view change the viewed array.
+ *              UArray2_free frees the view but not the array.
+ *****************************************************************/
+extern T UArray2_view(T uarray2, int i, int j, int width, int height);
+
+
 /******************************************************************
  * UArray2_width
  * Description: Get width value of unboxed array which is the
@@ -104,6 +301,25 @@ extern void *UArray2_at(T uarray2, int i, int j);
 
 
 
+/******************************************************************
+ * UArray2_map
+ * Description: Apply a function to every element, in whatever order
+ *              the elements are stored in
+ * Inputs: Same as UArray2_map_row_major
+ * Expectation: Parameter unboxed array and apply must not be null.
+ * Output: Void
+ * Expectation: If the parameter array or apply function is null,
+ *              exit with assert.
+ *              Every element is visited once. A row-major array is
+ *              visited row by row and a column-major one column by
+ *              column; a custom layout is visited slot by slot if it
+ *              has an element function, and row by row otherwise.
+ ******************************************************************/
+extern void UArray2_map(T uarray2, void apply(int i, int j, T uarray2,
+                        void *value, void *cl), void *cl);
+
+
+
 /*****************************************************************
 * UArray2_map_col_major
 * Description: Allows the client to specify a function apply that 
@@ -151,6 +367,121 @@ extern void UArray2_map_row_major(T uarray2, void apply(int i, int j,
 
 
 
+/******************************************************************
+ * UArray2_map_row_major_until, UArray2_map_col_major_until
+ * Description: Same as UArray2_map_row_major and
+ *              UArray2_map_col_major, except that apply returns
+ *              nonzero to stop the traversal there
+ * Inputs: 1) UArray2_T type unboxed array
+ *         2) An int apply function with the same parameters as for
+ *            the maps, returning 0 to go on or nonzero to stop
+ *         3) A void pointer closure
+ *         4) Integer pointers stop_i and stop_j, which may be null
+ * Expectation: Parameter unboxed array and apply must not be null.
+ * Output: 1 if apply stopped the traversal, with the column and row
+ *         where it stopped stored in stop_i and stop_j, and 0 if
+ *         every element was visited, with stop_i and stop_j left
+ *         alone.
+ * Expectation: If the parameter array or apply function is null,
+ *              exit with assert.
+ ******************************************************************/
+extern int UArray2_map_row_major_until(T uarray2, int apply(int i, int j,
+                                       T uarray2, void *value, void *cl),
+                                       void *cl, int *stop_i,
+                                       int *stop_j);
+extern int UArray2_map_col_major_until(T uarray2, int apply(int i, int j,
+                                       T uarray2, void *value, void *cl),
+                                       void *cl, int *stop_i,
+                                       int *stop_j);
+
+
+
+/******************************************************************
+ * UArray2_orient
+ * Description: Make a transposed, rotated or flipped copy of an
+ *              unboxed array
+ * Inputs: 1) UArray2_T type unboxed array
+ *         2) UArray2_orientation saying how to turn it
+ * Expectation: Parameter unboxed array must not be null.
+ * Output: New UArray2_T type array with the same element size. It is
+ *         height by width for a transpose or a 90 or 270 degree
+ *         rotation, and width by height otherwise.
+ * Expectation: If the parameter array is null, exit with assert.
+ *              The elements are copied a tile at a time, so columns
+ *              of the source are read while they are still in the
+ *              cache.
+ ******************************************************************/
+extern T UArray2_orient(T uarray2, UArray2_orientation how);
+
+
+/******************************************************************
+ * UArray2_orient_into
+ * Description: Same as UArray2_orient, but writes into an existing
+ *              array, which may be a view or a wrap
+ * Inputs: 1) UArray2_T type array to write
+ *         2) UArray2_T type array to read
+ *         3) UArray2_orientation saying how to turn it
+ * Expectation: Neither array may be null, they must have the same
+ *              element size, and the destination must have the
+ *              width and height of the result. The two must not
+ *              overlap.
+ * Output: Void
+ * Expectation: If an expectation is not met, exit with assert.
+ ******************************************************************/
+extern void UArray2_orient_into(T dest, T source, UArray2_orientation how);
+
+
+
+/******************************************************************
+ * UArray2_fill
+ * Description: Set every element of a rectangle to one value
+ * Inputs: 1) UArray2_T type unboxed array
+ *         2) Integer column i and row j of the rectangle's corner
+ *         3) Integer width and height of the rectangle
+ *         4) Pointer to an element-sized value
+ * Expectation: Parameter array and value must not be null and the
+ *              rectangle must be inside the array.
+ * Output: Void
+ * Expectation: If an expectation is not met, exit with assert.
+ *              Rows are set with memset when every byte of the value
+ *              is the same (such as zero), and with memcpy otherwise.
+ ******************************************************************/
+extern void UArray2_fill(T uarray2, int i, int j, int width, int height,
+                         const void *value);
+
+
+/******************************************************************
+ * UArray2_copy
+ * Description: Copy a rectangle of one unboxed array into another
+ * Inputs: 1) UArray2_T type array to write, and column i and row j
+ *            of the corner to write at
+ *         2) UArray2_T type array to read, and column and row of the
+ *            corner to read from
+ *         3) Integer width and height of the rectangle
+ * Expectation: Neither array may be null, they must have the same
+ *              element size, both rectangles must be inside their
+ *              arrays, and the rectangles must not overlap.
+ * Output: Void
+ * Expectation: If an expectation is not met, exit with assert.
+ *              Each row is copied with one memcpy.
+ ******************************************************************/
+extern void UArray2_copy(T dest, int i, int j, T source, int source_i,
+                         int source_j, int width, int height);
+
+
+/******************************************************************
+ * UArray2_clone
+ * Description: Make a copy of a whole unboxed array
+ * Inputs: UArray2_T type unboxed array, which may be a view
+ * Expectation: Parameter array must not be null.
+ * Output: New UArray2_T type array with the same width, height,
+ *         size and elements, which owns its elements
+ * Expectation: If the parameter array is null, exit with assert.
+ ******************************************************************/
+extern T UArray2_clone(T uarray2);
+
+
+
 /******************************************************************
  * UArray2_free
  * Description: Deallocate memory used by unboxed array
@@ -159,7 +490,9 @@ extern void UArray2_map_row_major(T uarray2, void apply(int i, int j,
  * Output: Void
  * Expectation: If the parameter address is null, exit with assert.
  *              Otherwise, deallocate memory of the address that the
- *              unboxed array holds.
+ *              unboxed array holds. An array from UArray2_map_file
+ *              is unmapped, and for UArray2_SHARED its elements are
+ *              left in the file.
  ******************************************************************/
 extern void UArray2_free(T *uarray2);
 
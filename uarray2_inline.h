@@ -0,0 +1,79 @@
+/*************************************************************************
+*                              uarray2_inline.h
+*
+*
+*      Authors: Jae Hyun Cheigh (jcheig01), Khanh Nguyen (cnguye10)
+*
+*      Fall 2020 - COMP40
+*      HW 2 - Part B
+*
+*
+*      Summary: This header shows the representation of UArray2_T so
+*               that hot loops can use UArray2_at_fast, a static inline
+*               copy of UArray2_at the compiler can fold into the loop
+*               instead of calling into uarray2.c for every element.
+*               Clients should use the accessor only and never the
+*               fields. Its bounds checks are CII asserts, so they stay
+*               in the default build and go away when compiled with
+*               -DNDEBUG (make RELEASE=1).
+*
+**************************************************************************/
+
+#ifndef UARRAY2_INLINE_INCLUDED
+#define UARRAY2_INLINE_INCLUDED
+
+#include <stddef.h>
+#include "uarray2.h"
+#include "assert.h"
+
+#define T UArray2_T
+
+/*
+ * data that our unboxed array holds. elems points at element [0, 0],
+ * either inside memory we allocated (owner is set; it is 2 when this
+ * header sits at the end of the same block, and 3 when both came from
+ * an arena), inside the mapped file (map is not NULL), or inside memory
+ * owned by someone else.
+ * Element [i, j] is j strides and i steps past elems: step is the
+ * element size for a row-major array, and stride the element size
+ * for a column-major one. With a custom layout, element [i, j] is
+ * instead in slot layout->index(i, j, width, height).
+ */
+struct T {
+    int width;
+    int height;
+    int size;
+    size_t stride;
+    size_t step;
+    char *elems;
+    const UArray2_layout *layout;
+    int owner;
+    void *map;
+    size_t map_length;
+};
+
+/******************************************************************
+ * UArray2_at_fast
+ * Description: Same as UArray2_at, but inlined into the caller
+ * Inputs: 1) UArray2_T type unboxed array
+ *         2) Integer value i which is column index of unboxed array
+ *         3) Integer value j which is row index of unboxed array
+ * Output: Void pointer to element at [i, j] index
+ * Implementation: Bounds are checked with assert, which -DNDEBUG
+ *                 removes, leaving only the address arithmetic and
+ *                 a well-predicted test for a custom layout.
+ ******************************************************************/
+static inline void *UArray2_at_fast(T uarray2, int i, int j)
+{
+    assert(uarray2 != NULL);
+    assert(i >= 0 && i < uarray2->width && j >= 0 && j < uarray2->height);
+
+    if (uarray2->layout != NULL) {
+        return uarray2->elems + uarray2->size *
+               uarray2->layout->index(i, j, uarray2->width, uarray2->height);
+    }
+    return uarray2->elems + j * uarray2->stride + i * uarray2->step;
+}
+
+#undef T
+#endif
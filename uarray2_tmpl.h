@@ -0,0 +1,195 @@
+/*************************************************************************
+*                              uarray2_tmpl.h
+*
+*
+*      Authors: Jae Hyun Cheigh (jcheig01), Khanh Nguyen (cnguye10)
+*
+*      Fall 2020 - COMP40
+*      HW 2 - Part B
+*
+*
+*      Summary: This is a template for 2D unboxed arrays of one fixed
+*               element type. Define UARRAY2_NAME and UARRAY2_TYPE and
+*               include this file to get the type UARRAY2_NAME_T and
+*               its functions, for example
+*
+*                   #define UARRAY2_NAME UArray2_int
+*                   #define UARRAY2_TYPE int
+*                   #include "uarray2_tmpl.h"
+*
+*               gives UArray2_int_T, UArray2_int_new, UArray2_int_at,
+*               and so on. The interface follows uarray2.h, but
+*               elements are typed instead of void *, there is no
+*               size argument, and every function is static inline,
+*               so maps with a known apply function compile down to
+*               plain loops over the elements. The file can be
+*               included once per element type; it undefines
+*               UARRAY2_NAME and UARRAY2_TYPE at the end.
+*
+**************************************************************************/
+
+#if !defined(UARRAY2_NAME) || !defined(UARRAY2_TYPE)
+#error "define UARRAY2_NAME and UARRAY2_TYPE before including uarray2_tmpl.h"
+#endif
+
+#ifndef UARRAY2_TMPL_INCLUDED
+#define UARRAY2_TMPL_INCLUDED
+
+#include <stddef.h>
+#include <stdint.h>
+#include <limits.h>
+#include "assert.h"
+#include "mem.h"
+
+/* pastes a suffix onto UARRAY2_NAME after expanding it */
+#define UARRAY2_PASTE(name, suffix) name##suffix
+#define UARRAY2_JOIN(name, suffix) UARRAY2_PASTE(name, suffix)
+#define UARRAY2_FN(suffix) UARRAY2_JOIN(UARRAY2_NAME, suffix)
+
+#endif
+
+#define T UARRAY2_FN(_T)
+typedef struct T *T;
+
+/* data that the array holds, elements row by row */
+struct T {
+    int width;
+    int height;
+    UARRAY2_TYPE *elems;
+};
+
+/****************************************************************
+ * _new
+ * Description: Create a new array of width by height elements,
+ *              all zero
+ * Inputs: Integer width and height, which must not be negative
+ * Output: The new array, freed with _free. Raises Mem_Failed if it
+ *         cannot be allocated, or its bytes do not fit in a long.
+ *****************************************************************/
+static inline T UARRAY2_FN(_new)(int width, int height)
+{
+    assert(width >= 0 && height >= 0);
+
+    /* Mem_calloc multiplies longs; raise Mem_Failed rather than wrap */
+    uint64_t elements = (uint64_t) width * height;
+    if (elements >= LONG_MAX / sizeof(UARRAY2_TYPE)) {
+        RAISE(Mem_Failed);
+    }
+
+    T array;
+    NEW(array);
+    array->width = width;
+    array->height = height;
+    array->elems = CALLOC((long) elements + 1, sizeof(UARRAY2_TYPE));
+    return array;
+}
+
+/****************************************************************
+ * _width, _height
+ * Description: Get the number of columns and rows of the array
+ *****************************************************************/
+static inline int UARRAY2_FN(_width)(T array)
+{
+    assert(array != NULL);
+    return array->width;
+}
+
+static inline int UARRAY2_FN(_height)(T array)
+{
+    assert(array != NULL);
+    return array->height;
+}
+
+/****************************************************************
+ * _at
+ * Description: Get a pointer to the element at column i, row j
+ * Inputs: Array and indices inside it
+ * Output: Typed pointer to the element
+ *****************************************************************/
+static inline UARRAY2_TYPE *UARRAY2_FN(_at)(T array, int i, int j)
+{
+    assert(array != NULL);
+    assert(i >= 0 && i < array->width && j >= 0 && j < array->height);
+    return &array->elems[(size_t) array->width * j + i];
+}
+
+/****************************************************************
+ * _get, _put
+ * Description: Read or write the element at column i, row j. _put
+ *              returns the element's previous value.
+ *****************************************************************/
+static inline UARRAY2_TYPE UARRAY2_FN(_get)(T array, int i, int j)
+{
+    return *UARRAY2_FN(_at)(array, i, j);
+}
+
+static inline UARRAY2_TYPE UARRAY2_FN(_put)(T array, int i, int j,
+                                            UARRAY2_TYPE value)
+{
+    UARRAY2_TYPE *element = UARRAY2_FN(_at)(array, i, j);
+    UARRAY2_TYPE previous = *element;
+    *element = value;
+    return previous;
+}
+
+/****************************************************************
+ * _map_row_major
+ * Description: Apply a function to every element, row by row
+ * Inputs: Array, apply function taking column and row indices, the
+ *         array, a pointer to the element and a closure, and the
+ *         closure
+ * Implementation: Walk the elements with a pointer in storage
+ *                 order, so the loop has no index arithmetic or
+ *                 bounds checks in it.
+ *****************************************************************/
+static inline void UARRAY2_FN(_map_row_major)(T array,
+        void apply(int i, int j, T array, UARRAY2_TYPE *value, void *cl),
+        void *cl)
+{
+    assert(array != NULL);
+    assert(apply != NULL);
+
+    UARRAY2_TYPE *element = array->elems;
+    for (int j = 0; j < array->height; j++) {
+        for (int i = 0; i < array->width; i++) {
+            apply(i, j, array, element++, cl);
+        }
+    }
+}
+
+/****************************************************************
+ * _map_col_major
+ * Description: Apply a function to every element, column by column
+ * Inputs: Same as _map_row_major
+ * Implementation: Step down each column one row width at a time.
+ *****************************************************************/
+static inline void UARRAY2_FN(_map_col_major)(T array,
+        void apply(int i, int j, T array, UARRAY2_TYPE *value, void *cl),
+        void *cl)
+{
+    assert(array != NULL);
+    assert(apply != NULL);
+
+    for (int i = 0; i < array->width; i++) {
+        UARRAY2_TYPE *element = array->elems + i;
+        for (int j = 0; j < array->height; j++) {
+            apply(i, j, array, element, cl);
+            element += array->width;
+        }
+    }
+}
+
+/****************************************************************
+ * _free
+ * Description: Deallocate the array and its elements
+ *****************************************************************/
+static inline void UARRAY2_FN(_free)(T *array)
+{
+    assert(array != NULL && *array != NULL);
+    FREE((*array)->elems);
+    FREE(*array);
+}
+
+#undef T
+#undef UARRAY2_NAME
+#undef UARRAY2_TYPE
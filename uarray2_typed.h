@@ -0,0 +1,32 @@
+/*************************************************************************
+*                              uarray2_typed.h
+*
+*
+*      Authors: Jae Hyun Cheigh (jcheig01), Khanh Nguyen (cnguye10)
+*
+*      Fall 2020 - COMP40
+*      HW 2 - Part B
+*
+*
+*      Summary: Type-specialized 2D unboxed arrays made from
+*               uarray2_tmpl.h: UArray2_int_T for int grids and
+*               UArray2_u8_T for 8-bit pixels. Other element types can
+*               be made the same way; useuarray2_typed.c checks these
+*               two and makes a third.
+*
+**************************************************************************/
+
+#ifndef UARRAY2_TYPED_INCLUDED
+#define UARRAY2_TYPED_INCLUDED
+
+#include <stdint.h>
+
+#define UARRAY2_NAME UArray2_int
+#define UARRAY2_TYPE int
+#include "uarray2_tmpl.h"
+
+#define UARRAY2_NAME UArray2_u8
+#define UARRAY2_TYPE uint8_t
+#include "uarray2_tmpl.h"
+
+#endif
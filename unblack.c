@@ -19,6 +19,25 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include "unblack.h"
+#include "bit2_inline.h"
+
+/*
+ * inlined at every call even where GCC would not, so a call with stats
+ * NULL drops the counting
+ */
+#define ALWAYS_INLINE static inline __attribute__((always_inline))
+
+/* entries in a stack's first array */
+#define INITIAL_STACK 1024
+
+/* push_to_stack, counting into stats unless it is NULL */
+ALWAYS_INLINE void push_counted(Index_stack *stack, int col, int row,
+                                Unblack_stats *stats);
+/* the DFS of unblack, counting into stats unless it is NULL */
+ALWAYS_INLINE void search(Bit2_T bitmap, Index_stack *stack, Bit2_T visited,
+                          Unblack_stats *stats);
+/* move a full stack to an array twice as long */
+static void grow_stack(Index_stack *stack);
 
 /****************************************************************
  * push_to_stack
@@ -27,15 +46,58 @@
  *         2) Integer value of column index
  *         3) Integer value of row index
  * Output: Void
- * Implementation: Allocate memory for index info (containing row &
- *                 column indices) and push to stack
+ * Implementation: Grow the stack's array if it is full, then fill
+ *                 in the row & column indices of the next entry.
+ *                 The push is counted if the stack has stats.
  *****************************************************************/
-void push_to_stack(Stack_T stack, int col, int row)
+void push_to_stack(Index_stack *stack, int col, int row)
 {
-    Index *index_p = (Index *) malloc(sizeof(Index));
+    push_counted(stack, col, row, stack->stats);
+}
+
+ALWAYS_INLINE void push_counted(Index_stack *stack, int col, int row,
+                                Unblack_stats *stats)
+{
+    if (stack->count == stack->capacity) {
+        grow_stack(stack);
+        if (stats != NULL) {
+            stats->stack_allocs++;
+        }
+    }
+    Index *index_p = &stack->items[stack->count++];
     index_p -> col = col; 
     index_p -> row = row; 
-    Stack_push(stack, index_p);
+
+    if (stats != NULL) {
+        stats->pushes++;
+        if (stack->count > stats->max_depth) {
+            stats->max_depth = stack->count;
+        }
+    }
+}
+
+/****************************************************************
+ * grow_stack
+ * Description: Make room on a full stack
+ * Inputs: Stack that is full, or has no array yet
+ * Output: Void
+ * Implementation: Carve an array of twice the capacity, or of
+ *                 INITIAL_STACK entries, from the stack's arena
+ *                 and copy the entries over. The old array stays
+ *                 in the arena until it is disposed of.
+ *****************************************************************/
+static void grow_stack(Index_stack *stack)
+{
+    size_t capacity = stack->capacity == 0 ? INITIAL_STACK
+                                           : 2 * stack->capacity;
+    Index *items = Arena_alloc(stack->arena,
+                               (long) (capacity * sizeof(Index)),
+                               __FILE__, __LINE__);
+    for (size_t i = 0; i < stack->count; i++) {
+        items[i] = stack->items[i];
+    }
+    stack->items = items;
+    stack->capacity = capacity;
 }
 
 /****************************************************************
@@ -48,7 +110,7 @@ void push_to_stack(Stack_T stack, int col, int row)
  * Implementation: Traverse through edges of pbm file and push
  *                 black pixels to stack
  *****************************************************************/
-void get_edges(Bit2_T bitmap, Stack_T stack, Bit2_T visited)
+void get_edges(Bit2_T bitmap, Index_stack *stack, Bit2_T visited)
 {      
     int row = 0;
     int col = 0; 
@@ -57,11 +119,11 @@ void get_edges(Bit2_T bitmap, Stack_T stack, Bit2_T visited)
 
     /* traverse columns and add black edge pixels to stack and unblack them */
     while (col < width) {
-        if (Bit2_get(bitmap, col, 0) == 1) {
+        if (Bit2_get_fast(bitmap, col, 0) == 1) {
             push_to_stack (stack, col, 0);
             unblack (bitmap, stack, visited); 
         }
-        if (Bit2_get(bitmap, col, height - 1) == 1)  {
+        if (Bit2_get_fast(bitmap, col, height - 1) == 1)  {
             push_to_stack (stack, col, height - 1);
             unblack (bitmap, stack, visited);
         }
@@ -69,11 +131,11 @@ void get_edges(Bit2_T bitmap, Stack_T stack, Bit2_T visited)
     }   
     /* traverse rows and add black edge pixels to stack and unblack them */
     while (row < height) {
-        if (Bit2_get(bitmap, 0, row) == 1) {
+        if (Bit2_get_fast(bitmap, 0, row) == 1) {
             push_to_stack (stack, 0, row);
             unblack(bitmap, stack, visited); 
         }
-        if (Bit2_get(bitmap, width - 1, row) == 1)  {
+        if (Bit2_get_fast(bitmap, width - 1, row) == 1)  {
             push_to_stack (stack, width - 1, row);
             unblack(bitmap, stack, visited);
         }
@@ -96,8 +158,8 @@ int unvisited_black(Bit2_T bitmap, Bit2_T visited, int col, int row)
 {
     return ((col >= 0) && (col < Bit2_width (bitmap)) && 
             (row >= 0) && (row < Bit2_height(bitmap)) &&
-            (Bit2_get (bitmap, col, row) == 1) &&
-            (Bit2_get (visited, col, row) == 0));
+            (Bit2_get_fast (bitmap, col, row) == 1) &&
+            (Bit2_get_fast (visited, col, row) == 0));
 }
 
 /****************************************************************
@@ -110,42 +172,172 @@ int unvisited_black(Bit2_T bitmap, Bit2_T visited, int col, int row)
  * Implementation: Until the stack containing the black pixels
  *                 that needed to be unblacked gets empty, check
  *                 for neighbor pixels that need to be unblacked
- *                 and push to stack.
+ *                 and push to stack. search is inlined twice, with
+ *                 stats NULL and not, so the search without
+ *                 stats has no counting in it at all.
  *****************************************************************/
-void unblack(Bit2_T bitmap, Stack_T stack, Bit2_T visited)
+void unblack(Bit2_T bitmap, Index_stack *stack, Bit2_T visited)
 { 
-    while (Stack_empty(stack) != 1) {
+    if (stack->stats == NULL) {
+        search(bitmap, stack, visited, NULL);
+    }
+    else {
+        search(bitmap, stack, visited, stack->stats);
+    }
+}
+
+ALWAYS_INLINE void search(Bit2_T bitmap, Index_stack *stack, Bit2_T visited,
+                          Unblack_stats *stats)
+{
+    while (stack->count > 0) {
         /* initialize black pixel index to be popped */
-        Index *popped = (Index *) Stack_pop(stack);
-        int col = popped->col;
-        int row = popped->row;
+        Index popped = stack->items[--stack->count];
+        int col = popped.col;
+        int row = popped.row;
+        if (stats != NULL) {
+            stats->pops++;
+        }
 
-        if (Bit2_get(visited, col, row) == 0) {
+        if (Bit2_get_fast(visited, col, row) == 0) {
             /* mark that we've visited this pixel */
-            Bit2_put(visited, col, row, 1); 
+            Bit2_put_fast(visited, col, row, 1); 
+            if (stats != NULL) {
+                stats->unblacked++;
+            }
 
             /* push unvisited black neighbors to stack */
             /* neighbor pixel in column c - 1, row r*/
             if (unvisited_black (bitmap, visited, col - 1, row)) {
-                push_to_stack (stack, col - 1, row); 
+                push_counted (stack, col - 1, row, stats); 
             }
             /* neighbor pixel in column c + 1, row r*/
             if (unvisited_black (bitmap, visited, col + 1, row)) {
-                push_to_stack (stack, col + 1, row);
+                push_counted (stack, col + 1, row, stats);
             }
             /* neighbor pixel in column c, row r - 1 */
             if (unvisited_black (bitmap, visited, col, row-1)) {
-                push_to_stack (stack, col, row - 1);
+                push_counted (stack, col, row - 1, stats);
             }
             /* neighbor pixel in column c, row r + 1 */
             if (unvisited_black (bitmap, visited, col, row+1)) {
-                push_to_stack (stack, col, row + 1);
+                push_counted (stack, col, row + 1, stats);
             }
                         
         }
         /* unblack pixel */
-        Bit2_put(bitmap, col, row, 0);
-        /* deallocate struct index */
-        free(popped);
+        Bit2_put_fast(bitmap, col, row, 0);
     }
-}
\ No newline at end of file
+}
+/****************************************************************
+ * unblack_runs
+ * Description: Unblack the black edges of a run-length encoded
+ *              bitmap
+ * Inputs: 1) Bit2RLE_T type bitmap representation of pbm file
+ *         2) Arena_T for the stack and the removed flags
+ *         3) Unblack_stats to count runs into, or NULL
+ * Output: Void
+ * Implementation: A run of black pixels is connected along the
+ *                 row, so the DFS can visit whole runs: runs in
+ *                 the first and last rows, or starting in the
+ *                 first column, or ending in the last, are marked
+ *                 and pushed. For each popped run, the runs of the
+ *                 rows above and below whose columns overlap it
+ *                 are its black neighbors; a binary search finds
+ *                 the first of them, and unmarked ones are marked
+ *                 and pushed. A run is pushed at most once, so the
+ *                 stack never holds more than all of them. Then
+ *                 every marked run is removed. Counting is per
+ *                 run, and the pixels unblacked are added up from
+ *                 the marked runs only when stats is not NULL.
+ *****************************************************************/
+void unblack_runs(Bit2RLE_T bitmap, Arena_T arena, Unblack_stats *stats)
+{
+    int width = Bit2RLE_width(bitmap);
+    int height = Bit2RLE_height(bitmap);
+    size_t count = Bit2RLE_run_count(bitmap);
+    unsigned char *removed = Arena_calloc(arena, (long) count + 1,
+                                          sizeof(unsigned char),
+                                          __FILE__, __LINE__);
+    size_t *stack = Arena_alloc(arena, (long) (count + 1) * sizeof(size_t),
+                                __FILE__, __LINE__);
+    int *rows = Arena_alloc(arena, (long) (count + 1) * sizeof(int),
+                            __FILE__, __LINE__);
+    size_t pushed = 0;
+    int start, end;
+
+    /* runs holding an edge pixel */
+    for (int row = 0; row < height; row++) {
+        size_t last = Bit2RLE_row_first(bitmap, row + 1);
+        for (size_t run = Bit2RLE_row_first(bitmap, row); run < last;
+             run++) {
+            Bit2RLE_run(bitmap, run, &start, &end);
+            if (row == 0 || row == height - 1 || start == 0 ||
+                end == width) {
+                removed[run] = 1;
+                stack[pushed] = run;
+                rows[pushed++] = row;
+            }
+        }
+    }
+    /* the most runs on the stack at once, for stats */
+    size_t most = pushed;
+
+    while (pushed > 0) {
+        pushed--;
+        size_t popped = stack[pushed];
+        int row = rows[pushed];
+        int low, high;
+        Bit2RLE_run(bitmap, popped, &low, &high);
+
+        /* overlapping runs of the row above, then the row below */
+        for (int next = row - 1; next <= row + 1; next += 2) {
+            if (next < 0 || next >= height) {
+                continue;
+            }
+            size_t first = Bit2RLE_row_first(bitmap, next);
+            size_t last = Bit2RLE_row_first(bitmap, next + 1);
+            /* first run of the row ending after column low */
+            while (first < last) {
+                size_t middle = first + (last - first) / 2;
+                Bit2RLE_run(bitmap, middle, &start, &end);
+                if (end <= low) {
+                    first = middle + 1;
+                }
+                else {
+                    last = middle;
+                }
+            }
+            last = Bit2RLE_row_first(bitmap, next + 1);
+            for (size_t run = first; run < last; run++) {
+                Bit2RLE_run(bitmap, run, &start, &end);
+                if (start >= high) {
+                    break;
+                }
+                if (!removed[run]) {
+                    removed[run] = 1;
+                    stack[pushed] = run;
+                    rows[pushed++] = next;
+                }
+            }
+        }
+        if (pushed > most) {
+            most = pushed;
+        }
+    }
+
+    if (stats != NULL) {
+        for (size_t run = 0; run < count; run++) {
+            if (removed[run]) {
+                Bit2RLE_run(bitmap, run, &start, &end);
+                stats->pushes++;
+                stats->pops++;
+                stats->unblacked += end - start;
+            }
+        }
+        if (most > stats->max_depth) {
+            stats->max_depth = most;
+        }
+    }
+
+    Bit2RLE_remove_runs(bitmap, removed);
+}
@@ -16,29 +16,55 @@
 #ifndef UNBLACK_INCLUDED
 #define UNBLACK_INCLUDED
 
+#include <stddef.h>
 #include "bit2.h"
-#include "stack.h"
+#include "bit2rle.h"
+#include "arena.h"
 
-/* 
- * struct holding column and row indices of black pixel that needs
- * to be unblacked
- */
+/* column and row indices of black pixel that needs to be unblacked */
 typedef struct BlackIndex {
     int col;
     int row;
 } Index;
 
 /*
- * makes an index struct out of a given column and row
- * indices, and pushes it to the stack. 
+ * what the search did, for unblackedges --stats: pushes and pops of
+ * the stack, the most it held at once, the pixels (or runs) turned
+ * white, and how many times the stack's array was carved from the
+ * arena. The runs search pushes each run once into one array.
+ */
+typedef struct Unblack_stats {
+    size_t pushes;
+    size_t pops;
+    size_t max_depth;
+    size_t unblacked;
+    size_t stack_allocs;
+} Unblack_stats;
+
+/*
+ * stack of black pixels for the DFS: an array of indices inside the
+ * page's arena. When it is full, an array twice as long is carved from
+ * the arena and the indices copied over, so a push allocates nothing
+ * and the stack is released together with the arena; the arrays left
+ * behind add up to less than the last one. Starts as { arena, NULL, 0,
+ * 0, stats }, where stats is NULL unless the search is counted.
  */
-void push_to_stack(Stack_T stack, int col, int row);
+typedef struct Index_stack {
+    Arena_T arena;
+    Index *items;
+    size_t count;
+    size_t capacity;
+    Unblack_stats *stats;
+} Index_stack;
+
+/* pushes the column and row indices of a black pixel to the stack */
+void push_to_stack(Index_stack *stack, int col, int row);
 
 /* 
  * traverses the edges of our bitmap, pushes black
  * edge pixels to the stack, and calls unblack function
  */
-void get_edges(Bit2_T bitmap, Stack_T stack, Bit2_T visited);
+void get_edges(Bit2_T bitmap, Index_stack *stack, Bit2_T visited);
 
 /* checks whether an index has a black, unvisited pixel */
 int unvisited_black(Bit2_T bitmap, Bit2_T visited, int col, int row);
@@ -48,6 +74,14 @@ int unvisited_black(Bit2_T bitmap, Bit2_T visited, int col, int row);
  * the stack, and push all of the pixel's unvisited black 
  * neighbors on the stack, and unblack the pixel in the bitmap
  */
-void unblack(Bit2_T bitmap, Stack_T stack, Bit2_T visited);
+void unblack(Bit2_T bitmap, Index_stack *stack, Bit2_T visited);
+
+/*
+ * the same search on a run-length encoded bitmap, a run at a time:
+ * runs touching an edge are removed, and so is every run overlapping
+ * the columns of a removed run in the row above or below. The stack
+ * and flags come from the arena. stats, if not NULL, counts runs.
+ */
+void unblack_runs(Bit2RLE_T bitmap, Arena_T arena, Unblack_stats *stats);
 
 #endif
\ No newline at end of file
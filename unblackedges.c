@@ -12,28 +12,76 @@
 *      Summary: This program takes pbm file as an input and unblack all
 *               the black edges using DFS algorithm which is implemented
 *               in unblack.c file. Then, we print out the right pbm format
-*               for unblacked file.
+*               for unblacked file. With --runs, the image is
+*               read straight into runs of black pixels instead, and
+*               the search and output go a run at a time, which
+*               takes far less memory for a scanned page.
+*               With --stats, the time of each phase (parsing, the
+*               unblack search and output), the pixels read and
+*               unblacked, what the search's stack did and the peak
+*               RSS go to standard error, as text, or as JSON with
+*               --stats=json.
+*
+*               Usage: unblackedges [--runs] [--stats[=json]] [pbm file]
 *     
 **************************************************************************/
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "bit2.h"
+#include "bit2_inline.h"
+#include "bit2rle.h"
 #include "unblack.h"
+#include "arena.h"
 #include "pnmrdr.h"
+#include "stats.h"
+
+/* bitmaps at least this many bits go on transparent huge pages */
+#define HUGE_BITMAP (8 * (size_t) Bit2_HUGE_PAGE)
 
 /* check for valid pbm input and use DFS algorithm to unblack
    to unblack edges */
-void process_unblack(FILE *fp);
+void process_unblack(FILE *fp, int use_runs, Stats_T stats);
+/* read the rest of the image as runs, unblack and print it */
+void process_runs(Pnmrdr_T rdr, int width, int height, Stats_T stats);
+/* record the counts of the search in the statistics */
+void count_search(Stats_T stats, Unblack_stats *search);
+/* make an aligned bitmap, on huge pages if it is large */
+Bit2_T new_bitmap(int width, int height);
 /* format unblack pbm output into P1 pbm format */
-void format_output(Bit2_T bitmap);
+void format_output(Bit2_T bitmap, Arena_T arena);
 /* apply function for Bit2_map_row_major used to print out
    bit value of unblacked pbm file */
 void print_format(int col, int row, Bit2_T bitmap, int val, void *cl);
+/* the same, for Bit2RLE_map_row_major */
+void print_run_format(int col, int row, Bit2RLE_T bitmap, int val,
+                      void *cl);
 
 int main(int argc, char *argv[])
 {
     FILE *fp = NULL;
+    int use_runs = 0;
+    Stats_T stats = NULL;
+
+    /* optional flags come before the file name: --runs asks for the
+       run-length encoded search, --stats for statistics */
+    while (argc > 1 && strncmp(argv[1], "--", 2) == 0) {
+        if (strcmp(argv[1], "--runs") == 0) {
+            use_runs = 1;
+        }
+        else if (strcmp(argv[1], "--stats") == 0 ||
+                 strcmp(argv[1], "--stats=json") == 0) {
+            Stats_free(&stats);
+            stats = Stats_new("unblackedges", argv[1][7] == '=');
+        }
+        else {
+            fprintf(stderr, "Unknown option: %s\n", argv[1]);
+            exit(EXIT_FAILURE);
+        }
+        argv++;
+        argc--;
+    }
 
     /* If no argument is given, program reads from standard input*/
     if (argc == 1) {
@@ -56,8 +104,10 @@ int main(int argc, char *argv[])
         exit(EXIT_FAILURE);
     }
 
-    process_unblack(fp);
+    process_unblack(fp, use_runs, stats);
 
+    Stats_print(stats, stderr);
+    Stats_free(&stats);
     return EXIT_SUCCESS;
 }
 
@@ -65,24 +115,29 @@ int main(int argc, char *argv[])
 * process_unblack
 * Description: Process "unblacking" any edges that contain
 *              black line by utilizing DFS algorithm.
-* Input: File pointer fp
+* Input: 1) File pointer fp
+*        2) Integer, nonzero to search runs with process_runs
+*        3) Stats_T to time the phases in, or NULL
 * Output: Void
 * Implementation: Check if the image in the correct format.
 *                 Check the width and height is not zero.
 *                 Make two bitmap of size of pbm image, one
 *                 for actual pbm image bit, and one for keep
 *                 tracking if the image bit was visited during
-*                 DFS process. Also, make stack which will
-*                 store all the black pixels that need to be
-*                 unblacked. By using get_edges, get edges
+*                 DFS process. Also, make an arena for the
+*                 stack which will store all the black pixels
+*                 that need to be unblacked and other scratch
+*                 memory, freed in one go when the image is
+*                 done. By using get_edges, get edges
 *                 of pbm image and unblack edges. Then,
 *                 format output that will print the unblacked
-*                 pbm.
+*                 pbm. With stats, the search is counted too.
 ***********************************************************/
-void process_unblack(FILE *fp)
+void process_unblack(FILE *fp, int use_runs, Stats_T stats)
 {
 
     Pnmrdr_T rdr;
+    Stats_phase(stats, "parse");
 
     /* check if pnm is correct format */
     TRY
@@ -116,53 +171,162 @@ void process_unblack(FILE *fp)
         exit(EXIT_FAILURE);
     }
 
+    if (use_runs) {
+        process_runs(rdr, width, height, stats);
+        Pnmrdr_free(&rdr);
+        fclose(fp);
+        return;
+    }
+
     /* make bitmap and put pixel value of pbm file that is read */
-    Bit2_T bitmap = Bit2_new(width, height);
+    Bit2_T bitmap = new_bitmap(width, height);
     for (int row = 0; row < height; row++) {
         for (int col = 0; col < width; col++) {
-            Bit2_put(bitmap, col, row, Pnmrdr_get(rdr));
+            Bit2_put_fast(bitmap, col, row, Pnmrdr_get(rdr));
         }
     }
+    Stats_count(stats, "pixels_read", (uint64_t) width * height);
 
+    Stats_phase(stats, "unblack");
     /* bitmap for keep track of already searched bit */
-    Bit2_T visited = Bit2_new(Bit2_width(bitmap), Bit2_height(bitmap));
+    Bit2_T visited = new_bitmap(Bit2_width(bitmap), Bit2_height(bitmap));
+
+    /* scratch memory for this image, released all at once */
+    Arena_T arena = Arena_new();
+    Unblack_stats search = { 0, 0, 0, 0, 0 };
 
-    /* stack holding black pixels that need to be unblacked */
-    Stack_T stack = Stack_new();
+    /* stack holding black pixels that need to be unblacked, inside
+       the arena */
+    Index_stack stack = { arena, NULL, 0, 0,
+                          stats != NULL ? &search : NULL };
 
     /* get edges and unblack pixels that need to unblacked */
-    get_edges(bitmap, stack, visited);
+    get_edges(bitmap, &stack, visited);
+    count_search(stats, &search);
+    Stats_count(stats, "stack_allocs", search.stack_allocs);
     /* format into P1 pbm and print out */
-    format_output(bitmap);
+    Stats_phase(stats, "output");
+    format_output(bitmap, arena);
+    Stats_phase(stats, NULL);
 
+    Arena_dispose(&arena);
     Bit2_free(&bitmap);
     Bit2_free(&visited);
-    Stack_free(&stack);
     Pnmrdr_free(&rdr);
     fclose(fp);
 }
 
+/***********************************************************
+* process_runs
+* Description: Unblack the edges of an image as runs of
+*              black pixels
+* Input: 1) Pnmrdr_T reader, just past the header
+*        2) Integer width and height of the image
+*        3) Stats_T to time the phases in, or NULL
+* Output: Void
+* Implementation: Add each run of black pixels to a
+*                 Bit2RLE_T as its row is read, so the image is
+*                 never held a bit per pixel. unblack_runs
+*                 removes the runs connected to the edges, using
+*                 the arena for its scratch memory, and the
+*                 runs left are printed in P1 pbm format.
+***********************************************************/
+void process_runs(Pnmrdr_T rdr, int width, int height, Stats_T stats)
+{
+    Bit2RLE_T bitmap = Bit2RLE_new(width, height);
+    for (int row = 0; row < height; row++) {
+        int start = -1;
+        for (int col = 0; col < width; col++) {
+            int val = Pnmrdr_get(rdr);
+            if (val == 1 && start < 0) {
+                start = col;
+            }
+            else if (val != 1 && start >= 0) {
+                Bit2RLE_add_run(bitmap, row, start, col);
+                start = -1;
+            }
+        }
+        if (start >= 0) {
+            Bit2RLE_add_run(bitmap, row, start, width);
+        }
+    }
+
+    Stats_count(stats, "pixels_read", (uint64_t) width * height);
+    Stats_count(stats, "runs", Bit2RLE_run_count(bitmap));
+    Stats_phase(stats, "unblack");
+    Arena_T arena = Arena_new();
+    Unblack_stats search = { 0, 0, 0, 0, 0 };
+    unblack_runs(bitmap, arena, stats != NULL ? &search : NULL);
+    count_search(stats, &search);
+
+    Stats_phase(stats, "output");
+    printf("P1\n");
+    printf("%d %d\n", width, height);
+    int *counter = Arena_alloc(arena, sizeof(int), __FILE__, __LINE__);
+    *counter = 0;
+    Bit2RLE_map_row_major(bitmap, print_run_format, counter);
+    Stats_phase(stats, NULL);
+
+    Arena_dispose(&arena);
+    Bit2RLE_free(&bitmap);
+}
+
+/***********************************************************
+* count_search
+* Description: Record what the unblack search did
+* Input: 1) Stats_T, or NULL to do nothing
+*        2) Unblack_stats the search counted into
+* Output: Void
+* Implementation: For the runs search, the pixels are those
+*                 of the runs removed, and each push is a run.
+***********************************************************/
+void count_search(Stats_T stats, Unblack_stats *search)
+{
+    Stats_count(stats, "pixels_unblacked", search->unblacked);
+    Stats_count(stats, "pushes", search->pushes);
+    Stats_count(stats, "pops", search->pops);
+    Stats_count(stats, "max_stack_depth", search->max_depth);
+}
+
+/***********************************************************
+* new_bitmap
+* Description: Make a bitmap for the DFS
+* Input: Integer width and height of the image
+* Output: New Bit2_T with every bit 0
+* Implementation: One aligned block, so the rows start on
+*                 cache lines. A bitmap of 2MB or more asks
+*                 for huge pages, since the DFS jumps between
+*                 rows and would otherwise miss the TLB on
+*                 most moves up or down.
+***********************************************************/
+Bit2_T new_bitmap(int width, int height)
+{
+    size_t bits = (size_t) width * height;
+    return Bit2_new_aligned(width, height, bits >= HUGE_BITMAP ?
+                            Bit2_HUGE_PAGE : Bit2_CACHE_LINE);
+}
+
 /***********************************************************
 * format_output
 * Purpose: Format the result output
-* Input: Bit2_T type bitmap is the bit array of unblacked
-*        pbm file
+* Input: 1) Bit2_T type bitmap is the bit array of unblacked
+*           pbm file
+*        2) Arena_T for scratch memory
 * Output: Void
 * Implementation: Print out in P1 pbm format and allocate
-*                 integer memory which will be passed onto
-*                 Bit2_map_row_major which is used to print
-*                 every bit value. The allocated integer
+*                 integer memory from the arena which will be
+*                 passed onto Bit2_map_row_major which is used
+*                 to print every bit value. The allocated integer
 *                 memory is used to make sure the output
 *                 doesn't print more than 70 columns
 ***********************************************************/
-void format_output(Bit2_T bitmap)
+void format_output(Bit2_T bitmap, Arena_T arena)
 {
     printf("P1\n");
     printf("%d %d\n", Bit2_width(bitmap), Bit2_height(bitmap));
-    int *counter = (int *) malloc(sizeof(int));
+    int *counter = Arena_alloc(arena, sizeof(int), __FILE__, __LINE__);
     *counter = 0; 
     Bit2_map_row_major(bitmap, print_format, counter);
-    free(counter);
 }
 
 /***********************************************************
@@ -200,4 +364,26 @@ void print_format(int col, int row, Bit2_T bitmap, int val, void *cl)
     else {
         printf("%d", val);
     }
-}
\ No newline at end of file
+}
+/***********************************************************
+* print_run_format
+* Description: Same as print_format, as the apply function
+*              for Bit2RLE_map_row_major
+* Input: As for print_format, with a Bit2RLE_T bitmap
+* Output: Void
+***********************************************************/
+void print_run_format(int col, int row, Bit2RLE_T bitmap, int val,
+                      void *cl)
+{
+    (void) row;
+
+    int *counter = (int *) cl;
+    (*counter)++;
+    if (col == Bit2RLE_width(bitmap) - 1 || *counter == 70) {
+        printf("%d\n", val);
+        *counter = 0;
+    }
+    else {
+        printf("%d", val);
+    }
+}
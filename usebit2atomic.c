@@ -0,0 +1,376 @@
+/*************************************************************************
+*                              usebit2atomic.c
+*
+*
+*      Authors: Jae Hyun Cheigh (jcheig01), Khanh Nguyen (cnguye10)
+*
+*      Fall 2020 - COMP40
+*      HW 2 - Part D
+*
+*
+*      Summary: This program checks the atomic operations of
+*               bit2_atomic.h with several threads on one bit array.
+*               The threads each try to claim every bit of a
+*               summarized bit array, or a sparse random set of them,
+*               with Bit2_test_and_set, each starting at a different
+*               bit and using a different memory order; exactly one
+*               thread must see each bit was 0, every word they made
+*               not 0 must be marked in the summary, and
+*               Bit2_map_ones, going by it, must find every bit. Then
+*               they clear the bits again with Bit2_test_and_clear.
+*               Last, they or runs of 1 to 64 bits, crossing word
+*               boundaries, into a view whose base is partway into a
+*               word with Bit2_fetch_or, each thread owning some
+*               columns of every run. It prints whether the atomics
+*               are OK and exits 1 if not.
+*
+*               "make check" runs it.
+*
+**************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "bit2.h"
+#include "bit2_atomic.h"
+
+#define THREADS 8
+
+/* one thread's share of the work, and what it saw */
+typedef struct Claim {
+    pthread_t thread;
+    int index;
+    Bit2_T bit2;
+    Bit2_T wanted;
+    int clear;
+    long won;
+    int good;
+} Claim;
+
+/* what Bit2_map_ones found */
+typedef struct Found {
+    Bit2_T wanted;
+    long count;
+    long last;
+    int good;
+} Found;
+
+/* memory order for a thread, so every order is used */
+Bit2_order order_for(int index);
+/* start THREADS threads running work on the claims, and join them */
+void run_threads(Claim *claims, Bit2_T bit2, Bit2_T wanted, int clear,
+                 void *work(void *));
+/* claim or clear the wanted bits, starting at this thread's share */
+void *claim_bits(void *arg);
+/* or this thread's columns of every run into each row */
+void *or_runs(void *arg);
+/* apply function for Bit2_map_ones, checking the bit was wanted */
+void found_one(int i, int j, Bit2_T bit2, int value, void *cl);
+/* check every word that is not 0 is marked at every summary level */
+int summary_covers(Bit2_T bit2);
+/* check claiming and clearing the bits of one array */
+int check_claims(int width, int height, int density, unsigned *seed);
+/* check Bit2_fetch_or on a view partway into a word */
+int check_fetch_or(int width, int height, int i, int j);
+/* next value of a fixed linear congruential generator */
+unsigned next_random(unsigned *seed);
+
+int main(int argc, char *argv[])
+{
+    (void) argc;
+    (void) argv;
+
+    int sizes[][2] = { { 1, 1 }, { 64, 64 }, { 131, 67 }, { 1000, 300 },
+                       { 4097, 20 } };
+    unsigned seed = 47;
+    int OK = 1;
+
+    int good = 1;
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        good &= check_claims(sizes[s][0], sizes[s][1], 1000, &seed);
+    }
+    printf("Claiming every bit is %sOK\n", good ? "" : "NOT ");
+    OK &= good;
+
+    good = 1;
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        good &= check_claims(sizes[s][0], sizes[s][1], 3, &seed);
+    }
+    printf("Claiming scattered bits is %sOK\n", good ? "" : "NOT ");
+    OK &= good;
+
+    good = check_fetch_or(200, 40, 37, 5) &&
+           check_fetch_or(64, 64, 1, 0) &&
+           check_fetch_or(1000, 30, 63, 7);
+    printf("Or-ing runs into a view is %sOK\n", good ? "" : "NOT ");
+    OK &= good;
+
+    printf("The atomic bit operations are %sOK!\n", OK ? "" : "NOT ");
+    return OK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/***********************************************************
+* order_for
+* Description: Pick a memory order for a thread
+* Input: Integer index of the thread
+* Output: Bit2_order, going round all five by index
+***********************************************************/
+Bit2_order order_for(int index)
+{
+    Bit2_order orders[5] = { Bit2_RELAXED, Bit2_ACQUIRE, Bit2_RELEASE,
+                             Bit2_ACQ_REL, Bit2_SEQ_CST };
+    return orders[index % 5];
+}
+
+/***********************************************************
+* run_threads
+* Description: Run a piece of work on THREADS threads
+* Input: 1) Array of THREADS claims, filled in here
+*        2) Bit array they work on, and the bits wanted
+*        3) Integer, 1 to clear bits instead of setting them
+*        4) Function each thread runs on its claim
+* Output: Void; the claims hold what each thread saw
+***********************************************************/
+void run_threads(Claim *claims, Bit2_T bit2, Bit2_T wanted, int clear,
+                 void *work(void *))
+{
+    for (int idx = 0; idx < THREADS; idx++) {
+        claims[idx].index = idx;
+        claims[idx].bit2 = bit2;
+        claims[idx].wanted = wanted;
+        claims[idx].clear = clear;
+        claims[idx].won = 0;
+        claims[idx].good = 1;
+        if (pthread_create(&claims[idx].thread, NULL, work,
+                           &claims[idx]) != 0) {
+            fprintf(stderr, "Could not start thread\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (int idx = 0; idx < THREADS; idx++) {
+        pthread_join(claims[idx].thread, NULL);
+    }
+}
+
+/***********************************************************
+* claim_bits
+* Description: Set or clear every wanted bit, counting the
+*              ones this thread changed
+* Input: Pointer to the thread's Claim
+* Output: NULL; won is the number of bits that were 0 before
+*         the set, or 1 before the clear
+* Implementation: Thread k starts k / THREADS of the way
+*                 through the bits in row-major order and wraps
+*                 around, so the threads meet on every word.
+***********************************************************/
+void *claim_bits(void *arg)
+{
+    Claim *claim = arg;
+    int width = Bit2_width(claim->bit2);
+    long total = (long) width * Bit2_height(claim->bit2);
+    long start = total * claim->index / THREADS;
+    Bit2_order order = order_for(claim->index);
+
+    for (long k = 0; k < total; k++) {
+        long p = (start + k) % total;
+        int i = (int) (p % width);
+        int j = (int) (p / width);
+        if (Bit2_get(claim->wanted, i, j) == 0) {
+            continue;
+        }
+        if (claim->clear) {
+            claim->won += Bit2_test_and_clear(claim->bit2, i, j, order);
+        }
+        else {
+            claim->won += !Bit2_test_and_set(claim->bit2, i, j, order);
+        }
+    }
+    return NULL;
+}
+
+/***********************************************************
+* or_runs
+* Description: Or this thread's columns into runs of each row
+* Input: Pointer to the thread's Claim
+* Output: NULL; good is 0 if a run's old bits already had one
+*         of this thread's bits, and won counts its bits
+* Implementation: Every thread cuts row j into the same runs,
+*                 of 1 to 64 bits from a generator seeded by j.
+*                 Thread k owns the columns that are k modulo
+*                 THREADS, and ors those of each run.
+***********************************************************/
+void *or_runs(void *arg)
+{
+    Claim *claim = arg;
+    int width = Bit2_width(claim->bit2);
+    int height = Bit2_height(claim->bit2);
+    Bit2_order order = order_for(claim->index);
+
+    for (int j = 0; j < height; j++) {
+        unsigned seed = (unsigned) j + 1;
+        int count;
+        for (int i = 0; i < width; i += count) {
+            count = (int) (next_random(&seed) % 64) + 1;
+            if (count > width - i) {
+                count = width - i;
+            }
+            uint64_t bits = 0;
+            for (int k = 0; k < count; k++) {
+                if ((i + k) % THREADS == claim->index) {
+                    bits |= (uint64_t) 1 << k;
+                }
+            }
+            uint64_t old = Bit2_fetch_or(claim->bit2, i, j, count, bits,
+                                         order);
+            claim->good &= (old & bits) == 0;
+            claim->won += __builtin_popcountll(bits);
+        }
+    }
+    return NULL;
+}
+
+/***********************************************************
+* found_one
+* Description: Count a bit Bit2_map_ones found
+* Input: Column i, row j, the bit array, its value and the
+*        Found record
+* Output: Void; good becomes 0 if the bit is 0, not wanted,
+*         or not after the last one found in row-major order
+***********************************************************/
+void found_one(int i, int j, Bit2_T bit2, int value, void *cl)
+{
+    Found *found = cl;
+    long p = (long) j * Bit2_width(bit2) + i;
+
+    found->good &= value == 1 && Bit2_get(bit2, i, j) == 1 &&
+                   Bit2_get(found->wanted, i, j) == 1 && p > found->last;
+    found->last = p;
+    found->count++;
+}
+
+/***********************************************************
+* summary_covers
+* Description: Check a summary marks every word that has a 1
+* Input: Bit2_T bit array with a summary
+* Output: 1 if every word, and every summary word, that is not
+*         0 has its bit set in the level above, 0 if not
+* Implementation: Clears leave summary bits over words that
+*                 are 0, which the summary allows, so only
+*                 missing bits are counted wrong.
+***********************************************************/
+int summary_covers(Bit2_T bit2)
+{
+    const Bit2_summary *summary = bit2->summary;
+    const uint64_t *below = bit2->words;
+    int good = summary != NULL;
+
+    for (int l = 0; good && l < summary->levels; l++) {
+        for (size_t k = 0; k < summary->length[l]; k++) {
+            uint64_t mark = summary->level[l][k / 64] >> (k % 64);
+            good &= below[k] == 0 || (mark & 1) == 1;
+        }
+        below = summary->level[l];
+    }
+    return good;
+}
+
+/***********************************************************
+* check_claims
+* Description: Check claiming and clearing bits with threads
+* Input: 1) Integer width and height of the bit array
+*        2) Integer density of the wanted bits per 1000
+*        3) Pointer to the seed
+* Output: 1 if each wanted bit was won by exactly one thread,
+*         the summary covers the words, and Bit2_map_ones found
+*         exactly the wanted bits after setting and none after
+*         clearing, 0 if not
+* Implementation: The bit array is summarized while blank, so
+*                 Bit2_map_ones only finds bits whose summary
+*                 bits the sets marked.
+***********************************************************/
+int check_claims(int width, int height, int density, unsigned *seed)
+{
+    Bit2_T bit2 = Bit2_new(width, height);
+    Bit2_T wanted = Bit2_new(width, height);
+    long expected = 0;
+    for (int j = 0; j < height; j++) {
+        for (int i = 0; i < width; i++) {
+            int bit = (int) (next_random(seed) % 1000) < density;
+            Bit2_put(wanted, i, j, bit);
+            expected += bit;
+        }
+    }
+    Bit2_summarize(bit2);
+
+    int good = 1;
+    for (int clear = 0; clear <= 1; clear++) {
+        Claim claims[THREADS];
+        run_threads(claims, bit2, wanted, clear, claim_bits);
+        long won = 0;
+        for (int idx = 0; idx < THREADS; idx++) {
+            won += claims[idx].won;
+        }
+
+        Found found = { wanted, 0, -1, 1 };
+        Bit2_map_ones(bit2, found_one, &found);
+        good &= won == expected && found.good && summary_covers(bit2) &&
+                found.count == (clear ? 0 : expected);
+    }
+
+    Bit2_free(&wanted);
+    Bit2_free(&bit2);
+    return good;
+}
+
+/***********************************************************
+* check_fetch_or
+* Description: Check Bit2_fetch_or with threads on a view
+* Input: 1) Integer width and height of the view
+*        2) Integer column i and row j of the view in a parent
+*           bigger by i + 50 columns and j + 3 rows
+* Output: 1 if no thread saw its own bits already set, every
+*         bit of the view ended up 1, the parent's summary covers
+*         its words, and Bit2_map_ones on the parent found exactly
+*         the view's bits, 0 if not
+***********************************************************/
+int check_fetch_or(int width, int height, int i, int j)
+{
+    Bit2_T parent = Bit2_new(width + i + 50, height + j + 3);
+    Bit2_summarize(parent);
+    Bit2_T view = Bit2_view(parent, i, j, width, height);
+    Bit2_T wanted = Bit2_new(width + i + 50, height + j + 3);
+    Bit2_fill(wanted, i, j, width, height, 1);
+
+    Claim claims[THREADS];
+    run_threads(claims, view, NULL, 0, or_runs);
+    int good = 1;
+    long won = 0;
+    for (int idx = 0; idx < THREADS; idx++) {
+        good &= claims[idx].good;
+        won += claims[idx].won;
+    }
+
+    Found found = { wanted, 0, -1, 1 };
+    Bit2_map_ones(parent, found_one, &found);
+    good &= won == (long) width * height && found.good &&
+            summary_covers(parent) && found.count == (long) width * height;
+
+    Bit2_free(&wanted);
+    Bit2_free(&view);
+    Bit2_free(&parent);
+    return good;
+}
+
+/***********************************************************
+* next_random
+* Description: Step a linear congruential generator
+* Input: Pointer to the seed, updated
+* Output: 15 random bits
+* Implementation: Same generator as pbmgen.
+***********************************************************/
+unsigned next_random(unsigned *seed)
+{
+    *seed = *seed * 1103515245 + 12345;
+    return (*seed / 65536) % 32768;
+}
@@ -0,0 +1,280 @@
+/*************************************************************************
+*                              usebit2sum.c
+*
+*
+*      Authors: Jae Hyun Cheigh (jcheig01), Khanh Nguyen (cnguye10)
+*
+*      Fall 2020 - COMP40
+*      HW 2 - Part D
+*
+*
+*      Summary: This program checks Bit2Sum_T against counting the bits
+*               of each rectangle one by one. It fills bit arrays and
+*               views of several sizes at several densities, counts
+*               random rectangles and every rectangle at the top left
+*               corner, then edits random bands of rows, calls
+*               Bit2Sum_update and counts again. It prints whether the
+*               table is OK and exits 1 if not.
+*
+*               The 32-bit entries only wrap, and Bit2Sum_count only
+*               splits a rectangle, past 2^32 pixels, whose table is
+*               over 16GB. So "my_usebit2sum side" also checks an all
+*               black side x side array, where every count is the
+*               rectangle's area: 65536 or more is past 2^32.
+*
+*               "make check" runs it without the side.
+*
+*               Usage: my_usebit2sum [side]
+*
+**************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "bit2.h"
+#include "bit2sum.h"
+#include "mem.h"
+
+/* random rectangles counted after each build or update */
+#define RECTANGLES 400
+/* bands edited and updated per array */
+#define BANDS 12
+
+/* fill a bit array with 1 bits, density per 1000 */
+void fill_random(Bit2_T bit2, int density, unsigned *seed);
+/* count the 1 bits of a rectangle one by one */
+uint64_t count_slowly(Bit2_T bit2, int i, int j, int width, int height);
+/* compare the table with counting on random and corner rectangles */
+int check_counts(Bit2Sum_T sum, Bit2_T bit2, unsigned *seed);
+/* check a table through builds and band updates */
+int check_array(Bit2_T bit2, int density, unsigned *seed);
+/* check an all black side x side array */
+int check_black(int side);
+/* next value of a fixed linear congruential generator */
+unsigned next_random(unsigned *seed);
+
+int main(int argc, char *argv[])
+{
+    if (argc > 2) {
+        fprintf(stderr, "Usage: %s [side]\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    int sizes[][2] = { { 1, 1 }, { 64, 3 }, { 65, 40 }, { 131, 67 },
+                       { 200, 150 }, { 1000, 90 } };
+    int densities[] = { 0, 20, 500, 1000 };
+    unsigned seed = 45;
+    int OK = 1;
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        int width = sizes[s][0];
+        int height = sizes[s][1];
+        int good = 1;
+        for (size_t d = 0; d < sizeof(densities) / sizeof(int); d++) {
+            Bit2_T bit2 = Bit2_new(width, height);
+            good &= check_array(bit2, densities[d], &seed);
+            Bit2_free(&bit2);
+
+            /* a view starting partway into a word */
+            Bit2_T parent = Bit2_new(width + 77, height + 5);
+            Bit2_T view = Bit2_view(parent, 37, 3, width, height);
+            fill_random(parent, 500, &seed);
+            good &= check_array(view, densities[d], &seed);
+            Bit2_free(&view);
+            Bit2_free(&parent);
+        }
+        printf("%dx%d arrays and views are %sOK\n", width, height,
+               good ? "" : "NOT ");
+        OK &= good;
+    }
+
+    if (argc == 2) {
+        int side = atoi(argv[1]);
+        int good = side > 0 && check_black(side);
+        printf("An all black %dx%d array is %sOK\n", side, side,
+               good ? "" : "NOT ");
+        OK &= good;
+    }
+
+    printf("The summed-area table is %sOK!\n", OK ? "" : "NOT ");
+    return OK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/***********************************************************
+* check_array
+* Description: Check a table through a build and updates
+* Input: 1) Bit2_T bit array, or view, to fill
+*        2) Integer density of 1 bits per 1000
+*        3) Pointer to the random seed
+* Output: 1 if every count matched, 0 if not
+* Implementation: Fill and build, then BANDS times change
+*                 the bits of a random band of rows (some
+*                 bands empty, some the whole array) and
+*                 update, checking the counts each time.
+***********************************************************/
+int check_array(Bit2_T bit2, int density, unsigned *seed)
+{
+    int width = Bit2_width(bit2);
+    int height = Bit2_height(bit2);
+
+    fill_random(bit2, density, seed);
+    Bit2Sum_T sum = Bit2Sum_new(bit2);
+    int good = Bit2Sum_width(sum) == width &&
+               Bit2Sum_height(sum) == height &&
+               check_counts(sum, bit2, seed);
+
+    for (int band = 0; band < BANDS && good; band++) {
+        int first = next_random(seed) % (height + 1);
+        int rows = next_random(seed) % (height - first + 1);
+        if (band == 0) {
+            first = 0;
+            rows = height;
+        }
+        for (int j = first; j < first + rows; j++) {
+            for (int i = 0; i < width; i++) {
+                if ((int) (next_random(seed) % 1000) < 300) {
+                    Bit2_put(bit2, i, j, 1 - Bit2_get(bit2, i, j));
+                }
+            }
+        }
+        Bit2Sum_update(sum, bit2, first, rows);
+        good = check_counts(sum, bit2, seed);
+    }
+
+    Bit2Sum_free(&sum);
+    return good;
+}
+
+/***********************************************************
+* check_counts
+* Description: Compare a table with counting bit by bit
+* Input: 1) Bit2Sum_T table
+*        2) Bit2_T bit array it is for
+*        3) Pointer to the random seed
+* Output: 1 if every count matched, 0 if not
+* Implementation: RECTANGLES random rectangles, some of
+*                 them empty, counted bit by bit, and every
+*                 rectangle at the top left corner, counted by
+*                 adding each row's running count to the
+*                 count of the rows above.
+***********************************************************/
+int check_counts(Bit2Sum_T sum, Bit2_T bit2, unsigned *seed)
+{
+    int width = Bit2_width(bit2);
+    int height = Bit2_height(bit2);
+    int good = 1;
+
+    for (int r = 0; r < RECTANGLES && good; r++) {
+        int i = next_random(seed) % (width + 1);
+        int j = next_random(seed) % (height + 1);
+        int w = next_random(seed) % (width - i + 1);
+        int h = next_random(seed) % (height - j + 1);
+        good = Bit2Sum_count(sum, i, j, w, h) ==
+               count_slowly(bit2, i, j, w, h);
+    }
+
+    /* corner[w] is the count of the w columns of the rows so far */
+    uint64_t *corner = CALLOC(width + 1, sizeof(uint64_t));
+    for (int h = 1; h <= height && good; h++) {
+        uint64_t row = 0;
+        for (int w = 1; w <= width && good; w++) {
+            row += Bit2_get(bit2, w - 1, h - 1);
+            corner[w] += row;
+            good = Bit2Sum_count(sum, 0, 0, w, h) == corner[w];
+        }
+    }
+    FREE(corner);
+    return good;
+}
+
+/***********************************************************
+* check_black
+* Description: Check the table of an all black array
+* Input: Integer side of the square array
+* Output: 1 if every count was the rectangle's area, 0 if not
+* Implementation: Counts of the whole array, of all but the
+*                 first row and column and of random ones; then a
+*                 band is cleared and updated, and the counts
+*                 are the area less the band's part.
+***********************************************************/
+int check_black(int side)
+{
+    Bit2_T bit2 = Bit2_new(side, side);
+    Bit2_fill(bit2, 0, 0, side, side, 1);
+    Bit2Sum_T sum = Bit2Sum_new(bit2);
+    uint64_t area = (uint64_t) side * side;
+    unsigned seed = 32;
+
+    int good = Bit2Sum_count(sum, 0, 0, side, side) == area &&
+               Bit2Sum_count(sum, 1, 1, side - 1, side - 1) ==
+               area - 2 * (uint64_t) side + 1;
+    for (int r = 0; r < RECTANGLES && good; r++) {
+        int i = next_random(&seed) % (side + 1);
+        int j = next_random(&seed) % (side + 1);
+        int w = next_random(&seed) % (side - i + 1);
+        int h = next_random(&seed) % (side - j + 1);
+        good = Bit2Sum_count(sum, i, j, w, h) == (uint64_t) w * h;
+    }
+
+    /* clear the middle third of the rows */
+    int first = side / 3;
+    int rows = side / 3;
+    Bit2_fill(bit2, 0, first, side, rows, 0);
+    Bit2Sum_update(sum, bit2, first, rows);
+    good &= Bit2Sum_count(sum, 0, 0, side, side) ==
+            area - (uint64_t) side * rows;
+    good &= Bit2Sum_count(sum, 0, first, side, rows) == 0;
+
+    Bit2Sum_free(&sum);
+    Bit2_free(&bit2);
+    return good;
+}
+
+/***********************************************************
+* count_slowly
+* Description: Count the 1 bits of a rectangle
+* Input: Bit2_T bit array, and the rectangle's column, row,
+*        width and height
+* Output: Number of 1 bits, from Bit2_get on each
+***********************************************************/
+uint64_t count_slowly(Bit2_T bit2, int i, int j, int width, int height)
+{
+    uint64_t count = 0;
+    for (int row = j; row < j + height; row++) {
+        for (int col = i; col < i + width; col++) {
+            count += Bit2_get(bit2, col, row);
+        }
+    }
+    return count;
+}
+
+/***********************************************************
+* fill_random
+* Description: Fill a bit array with random bits
+* Input: 1) Bit2_T bit array
+*        2) Integer density of 1 bits per 1000
+*        3) Pointer to the random seed
+* Output: Void
+***********************************************************/
+void fill_random(Bit2_T bit2, int density, unsigned *seed)
+{
+    for (int j = 0; j < Bit2_height(bit2); j++) {
+        for (int i = 0; i < Bit2_width(bit2); i++) {
+            Bit2_put(bit2, i, j, (int) (next_random(seed) % 1000) <
+                                 density);
+        }
+    }
+}
+
+/***********************************************************
+* next_random
+* Description: Step a linear congruential generator
+* Input: Pointer to the seed, updated
+* Output: 15 random bits
+* Implementation: Same generator as pbmgen.
+***********************************************************/
+unsigned next_random(unsigned *seed)
+{
+    *seed = *seed * 1103515245 + 12345;
+    return (*seed / 65536) % 32768;
+}
@@ -0,0 +1,412 @@
+/*************************************************************************
+*                              usebit2summary.c
+*
+*
+*      Authors: Jae Hyun Cheigh (jcheig01), Khanh Nguyen (cnguye10)
+*
+*      Fall 2020 - COMP40
+*      HW 2 - Part D
+*
+*
+*      Summary: This program checks the occupancy summary of
+*               Bit2_summarize. It makes random edits to summarized
+*               bit arrays, and to views of them, with Bit2_put,
+*               Bit2_fill setting and clearing, Bit2_copy and
+*               Bit2_orient_into, and after each one checks every
+*               level of the summary against the words below it, and
+*               every so often checks Bit2_next_set and Bit2_map_ones
+*               against reading every bit. It checks Bit2_next_set on
+*               views whose rows have 1 bits between them, from every
+*               start, with and without a summary. Last, it checks a
+*               summary made on a view: writes through the view keep
+*               it current, and another Bit2_summarize brings in
+*               writes through the array viewed. It prints whether
+*               the summaries are OK and exits 1 if not.
+*
+*               "make check" runs it.
+*
+**************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "bit2.h"
+#include "bit2_inline.h"
+
+/* edits per array, and how often the 1 bits are all looked for */
+#define EDITS 300
+#define SEARCH_EVERY 25
+
+/* what Bit2_map_ones found, compared with reading every bit */
+typedef struct Found {
+    int i, j;
+    long count;
+    int good;
+} Found;
+
+/* check every summary bit says whether the word below is 0 */
+int summary_exact(Bit2_T bit2);
+/* check Bit2_next_set from every start, and Bit2_map_ones */
+int search_matches(Bit2_T bit2, int every_start);
+/* apply function for Bit2_map_ones, checking it is the next 1 bit */
+void found_one(int i, int j, Bit2_T bit2, int value, void *cl);
+/* move to the next 1 bit by reading every bit, 0 if there is none */
+int next_slowly(Bit2_T bit2, int *i, int *j);
+/* make one random edit of a bit array */
+void edit(Bit2_T bit2, Bit2_T other, unsigned *seed);
+/* check a summary through random edits */
+int check_edits(Bit2_T bit2, Bit2_T summarized, unsigned *seed);
+/* check Bit2_next_set on a view inside 1 bits */
+int check_gaps(int width, int height, int i, int j, unsigned *seed);
+/* check a summary made on a view */
+int check_view_summary(unsigned *seed);
+/* next value of a fixed linear congruential generator */
+unsigned next_random(unsigned *seed);
+
+int main(int argc, char *argv[])
+{
+    (void) argc;
+    (void) argv;
+
+    int sizes[][2] = { { 1, 1 }, { 64, 64 }, { 131, 67 }, { 4097, 70 } };
+    unsigned seed = 46;
+    int OK = 1;
+
+    int good = 1;
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        int width = sizes[s][0];
+        int height = sizes[s][1];
+        Bit2_T bit2 = Bit2_new(width, height);
+        Bit2_summarize(bit2);
+        good &= check_edits(bit2, bit2, &seed);
+        Bit2_free(&bit2);
+
+        /* a view made after the summary shares it */
+        Bit2_T parent = Bit2_new(width + 77, height + 5);
+        Bit2_summarize(parent);
+        Bit2_T view = Bit2_view(parent, 37, 3, width, height);
+        good &= check_edits(view, parent, &seed);
+        Bit2_free(&view);
+        Bit2_free(&parent);
+    }
+    printf("Summaries after edits are %sOK\n", good ? "" : "NOT ");
+    OK &= good;
+
+    good = check_gaps(1, 1, 5, 1, &seed) &&
+           check_gaps(100, 10, 37, 3, &seed) &&
+           check_gaps(64, 20, 64, 2, &seed) &&
+           check_gaps(200, 30, 63, 1, &seed);
+    printf("Searching views between rows is %sOK\n", good ? "" : "NOT ");
+    OK &= good;
+
+    good = check_view_summary(&seed);
+    printf("Summaries made on views are %sOK\n", good ? "" : "NOT ");
+    OK &= good;
+
+    printf("The bit array summaries are %sOK!\n", OK ? "" : "NOT ");
+    return OK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/***********************************************************
+* summary_exact
+* Description: Check a summary against the words it covers
+* Input: Bit2_T bit array with a summary
+* Output: 1 if each bit of level 0 is set exactly when its
+*         word is not 0, each bit of a level above exactly when
+*         its word of the level below is not 0, and the bits
+*         past the end of each level are 0, 0 if not
+***********************************************************/
+int summary_exact(Bit2_T bit2)
+{
+    const Bit2_summary *summary = bit2->summary;
+    const uint64_t *below = bit2->words;
+    int good = summary != NULL;
+
+    for (int l = 0; good && l < summary->levels; l++) {
+        size_t length = summary->length[l];
+        for (size_t k = 0; k < (length + 63) / 64 * 64; k++) {
+            int mark = (summary->level[l][k / 64] >> (k % 64)) & 1;
+            good &= mark == (k < length && below[k] != 0);
+        }
+        below = summary->level[l];
+    }
+    return good;
+}
+
+/***********************************************************
+* search_matches
+* Description: Check Bit2_next_set and Bit2_map_ones against
+*              reading every bit
+* Input: 1) Bit2_T bit array
+*        2) Integer, 1 to start Bit2_next_set at every bit, 0 to
+*           only step from one 1 bit to the next
+* Output: 1 if they find the same bits as next_slowly, 0 if not
+***********************************************************/
+int search_matches(Bit2_T bit2, int every_start)
+{
+    int width = Bit2_width(bit2);
+    int height = Bit2_height(bit2);
+    int good = 1;
+
+    for (int j = 0; every_start && j < height; j++) {
+        for (int i = 0; i < width; i++) {
+            int fast_i = i, fast_j = j, slow_i = i, slow_j = j;
+            int fast = Bit2_next_set(bit2, &fast_i, &fast_j);
+            int slow = next_slowly(bit2, &slow_i, &slow_j);
+            good &= fast == slow &&
+                    (!fast || (fast_i == slow_i && fast_j == slow_j));
+        }
+    }
+    int end_i = 0, end_j = height;
+    good &= Bit2_next_set(bit2, &end_i, &end_j) == 0;
+
+    Found found = { 0, 0, 0, 1 };
+    Bit2_map_ones(bit2, found_one, &found);
+    int i = found.i, j = found.j;
+    good &= found.good && next_slowly(bit2, &i, &j) == 0;
+    return good;
+}
+
+/***********************************************************
+* found_one
+* Description: Check a bit Bit2_map_ones found is the next 1
+* Input: Column i, row j, the bit array, its value and the
+*        Found record, holding where to look from
+* Output: Void; good becomes 0 if the bit is not the first 1
+*         from there, which then moves just past it
+***********************************************************/
+void found_one(int i, int j, Bit2_T bit2, int value, void *cl)
+{
+    Found *found = cl;
+    int slow_i = found->i, slow_j = found->j;
+
+    found->good &= value == 1 && next_slowly(bit2, &slow_i, &slow_j) &&
+                   slow_i == i && slow_j == j;
+    found->count++;
+    found->i = i + 1;
+    found->j = j;
+    if (found->i == Bit2_width(bit2)) {
+        found->i = 0;
+        found->j++;
+    }
+}
+
+/***********************************************************
+* next_slowly
+* Description: Find the next 1 bit at or after [*i, *j] in
+*              row-major order, one Bit2_get at a time
+* Input: Bit2_T bit array, and pointers to the start, which
+*        may be one past the last row at column 0
+* Output: 1 with *i and *j at the bit, or 0 if there is none
+***********************************************************/
+int next_slowly(Bit2_T bit2, int *i, int *j)
+{
+    int width = Bit2_width(bit2);
+
+    for (int row = *j; row < Bit2_height(bit2); row++) {
+        for (int col = row == *j ? *i : 0; col < width; col++) {
+            if (Bit2_get(bit2, col, row)) {
+                *i = col;
+                *j = row;
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+/***********************************************************
+* edit
+* Description: Make one random edit to a bit array
+* Input: 1) Bit2_T bit array to edit
+*        2) Bit2_T bit array of random bits, at least as big, to
+*           copy and turn from
+*        3) Pointer to the seed
+* Output: Void
+* Implementation: One of: put a few bits to 1 or 0, fill a
+*                 rectangle with 1 or 0, copy a rectangle of other
+*                 or of another part of the bit array, or turn a
+*                 square of other into a view of the bit array.
+*                 Rectangles are small, so the array stays sparse
+*                 enough for the summary to matter.
+***********************************************************/
+void edit(Bit2_T bit2, Bit2_T other, unsigned *seed)
+{
+    int width = Bit2_width(bit2);
+    int height = Bit2_height(bit2);
+    int w = (int) (next_random(seed) % (width < 80 ? width : 80)) + 1;
+    int h = (int) (next_random(seed) % (height < 20 ? height : 20)) + 1;
+    int i = (int) (next_random(seed) % (width - w + 1));
+    int j = (int) (next_random(seed) % (height - h + 1));
+
+    switch (next_random(seed) % 6) {
+    case 0:
+        for (int k = 0; k < 8; k++) {
+            Bit2_put(bit2, (int) (next_random(seed) % width),
+                     (int) (next_random(seed) % height),
+                     (int) (next_random(seed) % 2));
+        }
+        break;
+    case 1:
+        Bit2_fill(bit2, i, j, w, h, 1);
+        break;
+    case 2:
+        Bit2_fill(bit2, i, j, w * 3 / 2 < width - i ? w * 3 / 2
+                                                    : width - i, h, 0);
+        break;
+    case 3:
+        Bit2_copy(bit2, i, j, other, (int) (next_random(seed) % 5),
+                  (int) (next_random(seed) % 5), w, h);
+        break;
+    case 4:
+        /* the rectangle above or below, whichever fits, if any */
+        if (j >= h) {
+            Bit2_copy(bit2, i, j - h, bit2, i, j, w, h);
+        }
+        else if (j + 2 * h <= height) {
+            Bit2_copy(bit2, i, j + h, bit2, i, j, w, h);
+        }
+        break;
+    default: {
+        int side = w < h ? w : h;
+        Bit2_T square = Bit2_view(bit2, i, j, side, side);
+        Bit2_T turn = Bit2_view(other, 1, 2, side, side);
+        Bit2_orient_into(square, turn,
+                         (Bit2_orientation) (next_random(seed) % 6));
+        Bit2_free(&turn);
+        Bit2_free(&square);
+        break;
+    }
+    }
+}
+
+/***********************************************************
+* check_edits
+* Description: Check a summary through random edits
+* Input: 1) Bit2_T bit array to edit, summarized or sharing a
+*           summary
+*        2) Bit2_T bit array holding the summary
+*        3) Pointer to the seed
+* Output: 1 if the summary was exact after every edit and the
+*         searches matched reading every bit, 0 if not
+***********************************************************/
+int check_edits(Bit2_T bit2, Bit2_T summarized, unsigned *seed)
+{
+    int width = Bit2_width(bit2);
+    int height = Bit2_height(bit2);
+    Bit2_T other = Bit2_new(width + 5, height + 5);
+    for (int j = 0; j < height + 5; j++) {
+        for (int i = 0; i < width + 5; i++) {
+            Bit2_put(other, i, j, (int) (next_random(seed) % 4 == 0));
+        }
+    }
+
+    int good = summary_exact(summarized);
+    for (int e = 1; good && e <= EDITS; e++) {
+        edit(bit2, other, seed);
+        good &= summary_exact(summarized);
+        if (e % SEARCH_EVERY == 0) {
+            good &= search_matches(bit2, width * height <= 10000);
+        }
+    }
+
+    Bit2_free(&other);
+    return good;
+}
+
+/***********************************************************
+* check_gaps
+* Description: Check Bit2_next_set on a view of an array whose
+*              bits outside the view are all 1
+* Input: 1) Integer width and height of the view
+*        2) Integer column i and row j of its corner in the
+*           array, which is 50 columns and 4 rows bigger
+*        3) Pointer to the seed
+* Output: 1 if from every start in the view, before and after
+*         summarizing the array, Bit2_next_set finds the same
+*         bit as reading every bit of the view, 0 if not
+* Implementation: The 1 bits before and after each row of the
+*                 view are in the same words as the row's ends,
+*                 or the words between rows, so the search has to
+*                 pass over them to the next row.
+***********************************************************/
+int check_gaps(int width, int height, int i, int j, unsigned *seed)
+{
+    Bit2_T parent = Bit2_new(width + i + 50, height + j + 4);
+    Bit2_fill(parent, 0, 0, width + i + 50, height + j + 4, 1);
+    Bit2_T view = Bit2_view(parent, i, j, width, height);
+    Bit2_fill(view, 0, 0, width, height, 0);
+
+    /* a few 1 bits in the view, with empty rows between some */
+    for (int k = 0; k < height / 3 + 1; k++) {
+        Bit2_put(view, (int) (next_random(seed) % width),
+                 (int) (next_random(seed) % height), 1);
+    }
+    int good = search_matches(view, 1);
+
+    Bit2_summarize(parent);
+    Bit2_T summarized = Bit2_view(parent, i, j, width, height);
+    good &= search_matches(summarized, 1);
+
+    Bit2_free(&summarized);
+    Bit2_free(&view);
+    Bit2_free(&parent);
+    return good;
+}
+
+/***********************************************************
+* check_view_summary
+* Description: Check a summary made on a view
+* Input: Pointer to the seed
+* Output: 1 if writes through the view kept its summary exact,
+*         and summarizing the view again after writes through
+*         the array it views made it exact again, 0 if not
+* Implementation: The summary covers the words from the start
+*                 of the viewed array's words to the view's last
+*                 one, so the array's own writes, above the view
+*                 and into it, are what the second call brings in.
+***********************************************************/
+int check_view_summary(unsigned *seed)
+{
+    Bit2_T parent = Bit2_new(300, 40);
+    Bit2_T view = Bit2_view(parent, 70, 6, 150, 30);
+    Bit2_summarize(view);
+    int good = parent->summary == NULL && summary_exact(view);
+
+    Bit2_T other = Bit2_new(155, 35);
+    for (int e = 0; good && e < EDITS / 3; e++) {
+        edit(view, other, seed);
+        good &= summary_exact(view);
+    }
+    good &= search_matches(view, 1);
+
+    Bit2_fill(parent, 0, 0, 300, 40, 0);
+    Bit2_put(parent, 5, 1, 1);
+    Bit2_put(parent, 100, 20, 1);
+    Bit2_fill(parent, 200, 30, 20, 5, 1);
+    Bit2_summarize(view);
+    good &= summary_exact(view);
+    int i = 0, j = 0;
+    good &= Bit2_next_set(view, &i, &j) && i == 30 && j == 14;
+    i++;
+    good &= Bit2_next_set(view, &i, &j) && i == 130 && j == 24;
+    good &= search_matches(view, 1);
+
+    Bit2_free(&other);
+    Bit2_free(&view);
+    Bit2_free(&parent);
+    return good;
+}
+
+/***********************************************************
+* next_random
+* Description: Step a linear congruential generator
+* Input: Pointer to the seed, updated
+* Output: 15 random bits
+* Implementation: Same generator as pbmgen.
+***********************************************************/
+unsigned next_random(unsigned *seed)
+{
+    *seed = *seed * 1103515245 + 12345;
+    return (*seed / 65536) % 32768;
+}
@@ -0,0 +1,513 @@
+/*************************************************************************
+*                              usebulk.c
+*
+*
+*      Authors: Jae Hyun Cheigh (jcheig01), Khanh Nguyen (cnguye10)
+*
+*      Fall 2020 - COMP40
+*      HW 2 - Part D
+*
+*
+*      Summary: This program checks the bulk operations, Bit2_fill,
+*               Bit2_copy, Bit2_clone, UArray2_fill, UArray2_copy and
+*               UArray2_clone, against doing the same one element at
+*               a time on a plain copy of the array. It makes random
+*               rectangles, most of them starting and ending partway
+*               into a word, on bit arrays, views whose base is
+*               partway into a word and wraps whose rows do not start
+*               on words, and on row-major, column-major and Morton
+*               arrays and views of 1, 3 and 8 byte elements. After
+*               every operation it compares the whole array around
+*               the one written. It prints whether the operations are
+*               OK and exits 1 if not.
+*
+*               "make check" runs it.
+*
+**************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "bit2.h"
+#include "uarray2.h"
+#include "mem.h"
+
+/* operations per array */
+#define OPERATIONS 150
+/* largest element size checked */
+#define MAX_SIZE 8
+
+/* how a test bit array is made */
+typedef enum { BIT2_PLAIN, BIT2_VIEW, BIT2_WRAP, BIT2_KINDS } Bit2_kind;
+
+/* how a test unboxed array is made */
+typedef enum {
+    UARRAY2_ROW, UARRAY2_COL, UARRAY2_MORTON, UARRAY2_ROW_VIEW,
+    UARRAY2_COL_VIEW, UARRAY2_KINDS
+} UArray2_kind;
+
+/*
+ * a test array, the array it is part of (itself if it is not a
+ * view or wrap) and where in it, the words of a wrap, and a plain
+ * copy of the array it is part of, written one element at a time
+ */
+typedef struct Bit2_made {
+    Bit2_T bit2;
+    Bit2_T parent;
+    int i, j;
+    uint64_t *words;
+    Bit2_T shadow;
+} Bit2_made;
+
+typedef struct UArray2_made {
+    UArray2_T array;
+    UArray2_T parent;
+    int i, j;
+    UArray2_T shadow;
+} UArray2_made;
+
+/* a random rectangle of a width x height array */
+typedef struct Rectangle {
+    int i, j, width, height;
+} Rectangle;
+
+/* pick a rectangle inside a width x height array */
+Rectangle pick(int width, int height, unsigned *seed);
+/* make a bit array and its shadow, with random bits in both */
+Bit2_made make_bit2(Bit2_kind kind, int width, int height, unsigned *seed);
+void free_bit2(Bit2_made *made);
+/* check the made bit array, and all around it, matches its shadow */
+int bit2_matches(Bit2_made *made);
+/* check bulk operations on one bit array */
+int check_bit2(int width, int height, Bit2_kind kind, unsigned *seed);
+/* make an unboxed array and its shadow, with random bytes in both */
+UArray2_made make_uarray2(UArray2_kind kind, int width, int height,
+                          int size, unsigned *seed);
+void free_uarray2(UArray2_made *made);
+/* check the made array, and all around it, matches its shadow */
+int uarray2_matches(UArray2_made *made);
+/* check bulk operations on one unboxed array */
+int check_uarray2(int width, int height, UArray2_kind kind, int size,
+                  unsigned *seed);
+/* next value of a fixed linear congruential generator */
+unsigned next_random(unsigned *seed);
+
+int main(int argc, char *argv[])
+{
+    (void) argc;
+    (void) argv;
+
+    int sizes[][2] = { { 1, 1 }, { 64, 3 }, { 65, 40 }, { 131, 67 },
+                       { 200, 30 }, { 3, 90 } };
+    int num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+    unsigned seed = 36;
+    int OK = 1;
+
+    int good = 1;
+    for (int s = 0; s < num_sizes; s++) {
+        for (int kind = 0; kind < BIT2_KINDS; kind++) {
+            good &= check_bit2(sizes[s][0], sizes[s][1], kind, &seed);
+        }
+    }
+    printf("Bit array fill, copy and clone are %sOK\n",
+           good ? "" : "NOT ");
+    OK &= good;
+
+    int element_sizes[3] = { 1, 3, 8 };
+    good = 1;
+    for (int s = 0; s < num_sizes; s++) {
+        for (int kind = 0; kind < UARRAY2_KINDS; kind++) {
+            for (int e = 0; e < 3; e++) {
+                good &= check_uarray2(sizes[s][0], sizes[s][1], kind,
+                                      element_sizes[e], &seed);
+            }
+        }
+    }
+    printf("Unboxed array fill, copy and clone are %sOK\n",
+           good ? "" : "NOT ");
+    OK &= good;
+
+    printf("The bulk operations are %sOK!\n", OK ? "" : "NOT ");
+    return OK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/***********************************************************
+* pick
+* Description: Pick a random rectangle inside an array
+* Input: Integer width and height of the array, at least 1,
+*        and a pointer to the seed
+* Output: Rectangle of 1 to width columns and 1 to height
+*         rows; one in eight is the whole array
+***********************************************************/
+Rectangle pick(int width, int height, unsigned *seed)
+{
+    Rectangle rect = { 0, 0, width, height };
+    if (next_random(seed) % 8 == 0) {
+        return rect;
+    }
+    rect.width = (int) (next_random(seed) % width) + 1;
+    rect.height = (int) (next_random(seed) % height) + 1;
+    rect.i = (int) (next_random(seed) % (width - rect.width + 1));
+    rect.j = (int) (next_random(seed) % (height - rect.height + 1));
+    return rect;
+}
+
+/***********************************************************
+* make_bit2, free_bit2
+* Description: Make a bit array to work on, or free one
+* Input: 1) Bit2_kind: a new bit array, a view starting 37
+*           bits into a word of a bigger one, or a wrap whose
+*           rows are 13 bits longer than it
+*        2) Integer width and height
+*        3) Pointer to the seed
+* Output: Bit2_made holding the bit array, its parent, and a
+*         shadow of the parent, every bit random
+***********************************************************/
+Bit2_made make_bit2(Bit2_kind kind, int width, int height, unsigned *seed)
+{
+    Bit2_made made = { NULL, NULL, 0, 0, NULL, NULL };
+
+    if (kind == BIT2_PLAIN) {
+        made.bit2 = made.parent = Bit2_new(width, height);
+    }
+    else if (kind == BIT2_VIEW) {
+        made.parent = Bit2_new(width + 77, height + 5);
+        made.i = 37;
+        made.j = 3;
+        made.bit2 = Bit2_view(made.parent, made.i, made.j, width, height);
+    }
+    else {
+        int stride = width + 13;
+        made.words = CALLOC(((long) stride * height + 63) / 64,
+                            sizeof(uint64_t));
+        made.parent = Bit2_wrap(made.words, stride, height, stride);
+        made.bit2 = Bit2_wrap(made.words, width, height, stride);
+    }
+
+    made.shadow = Bit2_new(Bit2_width(made.parent),
+                           Bit2_height(made.parent));
+    for (int j = 0; j < Bit2_height(made.parent); j++) {
+        for (int i = 0; i < Bit2_width(made.parent); i++) {
+            int bit = next_random(seed) & 1;
+            Bit2_put(made.parent, i, j, bit);
+            Bit2_put(made.shadow, i, j, bit);
+        }
+    }
+    return made;
+}
+
+void free_bit2(Bit2_made *made)
+{
+    if (made->parent != made->bit2) {
+        Bit2_free(&made->parent);
+    }
+    Bit2_free(&made->bit2);
+    Bit2_free(&made->shadow);
+    if (made->words != NULL) {
+        FREE(made->words);
+    }
+}
+
+/***********************************************************
+* bit2_matches
+* Description: Compare a made bit array with its shadow
+* Input: Pointer to the Bit2_made
+* Output: 1 if every bit of the parent, inside the bit array
+*         and around it, is the same in the shadow, 0 if not
+***********************************************************/
+int bit2_matches(Bit2_made *made)
+{
+    int good = 1;
+    for (int j = 0; j < Bit2_height(made->parent); j++) {
+        for (int i = 0; i < Bit2_width(made->parent); i++) {
+            good &= Bit2_get(made->parent, i, j) ==
+                    Bit2_get(made->shadow, i, j);
+        }
+    }
+    return good;
+}
+
+/***********************************************************
+* check_bit2
+* Description: Check fill, copy and clone on one bit array
+* Input: 1) Integer width and height of the bit array
+*        2) Bit2_kind of the bit array
+*        3) Pointer to the seed
+* Output: 1 if after every operation the bit array and all
+*         around it match the shadow, and every clone matches
+*         the bit array, 0 if not
+* Implementation: Each operation is one of: fill a rectangle
+*                 with 0 or 1, copy a rectangle from another
+*                 made bit array of a random kind, copy one to
+*                 the place beside it in the same bit array, if
+*                 there is room, or clone the bit array, and
+*                 check a put into the clone does not reach it.
+***********************************************************/
+int check_bit2(int width, int height, Bit2_kind kind, unsigned *seed)
+{
+    Bit2_made made = make_bit2(kind, width, height, seed);
+    Bit2_made other = make_bit2(next_random(seed) % BIT2_KINDS, width,
+                                height, seed);
+    int good = 1;
+
+    for (int op = 0; good && op < OPERATIONS; op++) {
+        Rectangle rect = pick(width, height, seed);
+        int choice = next_random(seed) % 4;
+
+        if (choice == 0) {
+            int value = next_random(seed) & 1;
+            Bit2_fill(made.bit2, rect.i, rect.j, rect.width, rect.height,
+                      value);
+            for (int j = 0; j < rect.height; j++) {
+                for (int i = 0; i < rect.width; i++) {
+                    Bit2_put(made.shadow, made.i + rect.i + i,
+                             made.j + rect.j + j, value);
+                }
+            }
+        }
+        else if (choice == 1) {
+            Rectangle from = pick(width - rect.width + 1,
+                                  height - rect.height + 1, seed);
+            Bit2_copy(made.bit2, rect.i, rect.j, other.bit2, from.i,
+                      from.j, rect.width, rect.height);
+            for (int j = 0; j < rect.height; j++) {
+                for (int i = 0; i < rect.width; i++) {
+                    Bit2_put(made.shadow, made.i + rect.i + i,
+                             made.j + rect.j + j,
+                             Bit2_get(other.bit2, from.i + i,
+                                      from.j + j));
+                }
+            }
+        }
+        else if (choice == 2 && rect.i + 2 * rect.width <= width) {
+            /* to the right of itself, in the same bit array */
+            int to_i = rect.i + rect.width;
+            Bit2_copy(made.bit2, to_i, rect.j, made.bit2, rect.i,
+                      rect.j, rect.width, rect.height);
+            for (int j = 0; j < rect.height; j++) {
+                for (int i = 0; i < rect.width; i++) {
+                    Bit2_put(made.shadow, made.i + to_i + i,
+                             made.j + rect.j + j,
+                             Bit2_get(made.shadow, made.i + rect.i + i,
+                                      made.j + rect.j + j));
+                }
+            }
+        }
+        else if (choice == 3) {
+            Bit2_T clone = Bit2_clone(made.bit2);
+            good &= Bit2_width(clone) == width &&
+                    Bit2_height(clone) == height;
+            for (int j = 0; good && j < height; j++) {
+                for (int i = 0; i < width; i++) {
+                    good &= Bit2_get(clone, i, j) ==
+                            Bit2_get(made.bit2, i, j);
+                }
+            }
+            Bit2_put(clone, rect.i, rect.j,
+                     !Bit2_get(clone, rect.i, rect.j));
+            Bit2_free(&clone);
+        }
+        good &= bit2_matches(&made);
+    }
+
+    free_bit2(&other);
+    free_bit2(&made);
+    return good;
+}
+
+/***********************************************************
+* make_uarray2, free_uarray2
+* Description: Make an unboxed array to work on, or free one
+* Input: 1) UArray2_kind: row-major, column-major or Morton
+*           order, or a view into a bigger row-major or
+*           column-major array
+*        2) Integer width, height and element size
+*        3) Pointer to the seed
+* Output: UArray2_made holding the array, its parent, and a
+*         row-major shadow of the parent, every byte random
+***********************************************************/
+UArray2_made make_uarray2(UArray2_kind kind, int width, int height,
+                          int size, unsigned *seed)
+{
+    UArray2_made made = { NULL, NULL, 0, 0, NULL };
+
+    switch (kind) {
+    case UARRAY2_ROW:
+        made.parent = UArray2_new(width, height, size);
+        break;
+    case UARRAY2_COL:
+        made.parent = UArray2_new_ordered(width, height, size,
+                                          UArray2_COL_MAJOR);
+        break;
+    case UARRAY2_MORTON:
+        made.parent = UArray2_new_layout(width, height, size,
+                                         &UArray2_morton);
+        break;
+    case UARRAY2_ROW_VIEW:
+        made.parent = UArray2_new(width + 7, height + 5, size);
+        break;
+    default:
+        made.parent = UArray2_new_ordered(width + 7, height + 5, size,
+                                          UArray2_COL_MAJOR);
+        break;
+    }
+    if (kind == UARRAY2_ROW_VIEW || kind == UARRAY2_COL_VIEW) {
+        made.i = 3;
+        made.j = 2;
+        made.array = UArray2_view(made.parent, made.i, made.j, width,
+                                  height);
+    }
+    else {
+        made.array = made.parent;
+    }
+
+    made.shadow = UArray2_new(UArray2_width(made.parent),
+                              UArray2_height(made.parent), size);
+    for (int j = 0; j < UArray2_height(made.parent); j++) {
+        for (int i = 0; i < UArray2_width(made.parent); i++) {
+            unsigned char *element = UArray2_at(made.parent, i, j);
+            for (int b = 0; b < size; b++) {
+                element[b] = (unsigned char) next_random(seed);
+            }
+            memcpy(UArray2_at(made.shadow, i, j), element, size);
+        }
+    }
+    return made;
+}
+
+void free_uarray2(UArray2_made *made)
+{
+    if (made->parent != made->array) {
+        UArray2_free(&made->parent);
+    }
+    UArray2_free(&made->array);
+    UArray2_free(&made->shadow);
+}
+
+/***********************************************************
+* uarray2_matches
+* Description: Compare a made unboxed array with its shadow
+* Input: Pointer to the UArray2_made
+* Output: 1 if every element of the parent, inside the array
+*         and around it, is the same in the shadow, 0 if not
+***********************************************************/
+int uarray2_matches(UArray2_made *made)
+{
+    int size = UArray2_size(made->parent);
+    int good = 1;
+    for (int j = 0; j < UArray2_height(made->parent); j++) {
+        for (int i = 0; i < UArray2_width(made->parent); i++) {
+            good &= memcmp(UArray2_at(made->parent, i, j),
+                           UArray2_at(made->shadow, i, j), size) == 0;
+        }
+    }
+    return good;
+}
+
+/***********************************************************
+* check_uarray2
+* Description: Check fill, copy and clone on one unboxed array
+* Input: 1) Integer width and height of the array
+*        2) UArray2_kind of the array
+*        3) Integer element size, at most MAX_SIZE
+*        4) Pointer to the seed
+* Output: 1 if after every operation the array and all around
+*         it match the shadow, and every clone matches the
+*         array, 0 if not
+* Implementation: As check_bit2. Half the fill values have the
+*                 same byte throughout, which UArray2_fill sets
+*                 with memset, and half do not.
+***********************************************************/
+int check_uarray2(int width, int height, UArray2_kind kind, int size,
+                  unsigned *seed)
+{
+    UArray2_made made = make_uarray2(kind, width, height, size, seed);
+    UArray2_made other = make_uarray2(next_random(seed) % UARRAY2_KINDS,
+                                      width, height, size, seed);
+    int good = 1;
+
+    for (int op = 0; good && op < OPERATIONS; op++) {
+        Rectangle rect = pick(width, height, seed);
+        int choice = next_random(seed) % 4;
+
+        if (choice == 0) {
+            unsigned char value[MAX_SIZE];
+            int same = next_random(seed) & 1;
+            for (int b = 0; b < size; b++) {
+                value[b] = (unsigned char) (same && b > 0
+                                            ? value[0]
+                                            : next_random(seed));
+            }
+            UArray2_fill(made.array, rect.i, rect.j, rect.width,
+                         rect.height, value);
+            for (int j = 0; j < rect.height; j++) {
+                for (int i = 0; i < rect.width; i++) {
+                    memcpy(UArray2_at(made.shadow, made.i + rect.i + i,
+                                      made.j + rect.j + j), value, size);
+                }
+            }
+        }
+        else if (choice == 1) {
+            Rectangle from = pick(width - rect.width + 1,
+                                  height - rect.height + 1, seed);
+            UArray2_copy(made.array, rect.i, rect.j, other.array, from.i,
+                         from.j, rect.width, rect.height);
+            for (int j = 0; j < rect.height; j++) {
+                for (int i = 0; i < rect.width; i++) {
+                    memcpy(UArray2_at(made.shadow, made.i + rect.i + i,
+                                      made.j + rect.j + j),
+                           UArray2_at(other.array, from.i + i, from.j + j),
+                           size);
+                }
+            }
+        }
+        else if (choice == 2 && rect.j + 2 * rect.height <= height) {
+            /* below itself, in the same array */
+            int to_j = rect.j + rect.height;
+            UArray2_copy(made.array, rect.i, to_j, made.array, rect.i,
+                         rect.j, rect.width, rect.height);
+            for (int j = 0; j < rect.height; j++) {
+                for (int i = 0; i < rect.width; i++) {
+                    memcpy(UArray2_at(made.shadow, made.i + rect.i + i,
+                                      made.j + to_j + j),
+                           UArray2_at(made.shadow, made.i + rect.i + i,
+                                      made.j + rect.j + j), size);
+                }
+            }
+        }
+        else if (choice == 3) {
+            UArray2_T clone = UArray2_clone(made.array);
+            good &= UArray2_width(clone) == width &&
+                    UArray2_height(clone) == height &&
+                    UArray2_size(clone) == size;
+            for (int j = 0; good && j < height; j++) {
+                for (int i = 0; i < width; i++) {
+                    good &= memcmp(UArray2_at(clone, i, j),
+                                   UArray2_at(made.array, i, j),
+                                   size) == 0;
+                }
+            }
+            memset(UArray2_at(clone, rect.i, rect.j), 0xA5, size);
+            UArray2_free(&clone);
+        }
+        good &= uarray2_matches(&made);
+    }
+
+    free_uarray2(&other);
+    free_uarray2(&made);
+    return good;
+}
+
+/***********************************************************
+* next_random
+* Description: Step a linear congruential generator
+* Input: Pointer to the seed, updated
+* Output: 15 random bits
+* Implementation: Same generator as pbmgen.
+***********************************************************/
+unsigned next_random(unsigned *seed)
+{
+    *seed = *seed * 1103515245 + 12345;
+    return (*seed / 65536) % 32768;
+}
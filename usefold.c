@@ -0,0 +1,375 @@
+/*************************************************************************
+*                              usefold.c
+*
+*
+*      Authors: Jae Hyun Cheigh (jcheig01), Khanh Nguyen (cnguye10)
+*
+*      Fall 2020 - COMP40
+*      HW 2 - Part B
+*
+*
+*      Summary: This program checks the folds in fold.h against serial
+*               loops. It fills arrays of bytes and ints in row-major,
+*               column-major and Morton order, views of them, and bit
+*               arrays and views of those, then compares Bit2_count,
+*               the sums and the histograms, and UArray2_fold and
+*               Bit2_fold with a callback that also checks every
+*               element comes once and in row order, with the serial
+*               answers on several numbers of threads. It prints
+*               whether the folds are OK and exits 1 if not.
+*
+*               "make check" runs it.
+*
+**************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "fold.h"
+#include "mem.h"
+
+/* int elements are from -LIMIT to LIMIT, and histograms have BINS bins,
+   so the negative ones and some positive ones have no bin */
+#define LIMIT 1000
+#define BINS 700
+
+/* accumulator of the callback folds: the elements of rows first_row to
+   next_j - 1, and column next_i of row next_j, come next */
+typedef struct Rows {
+    int first_row;
+    int next_i;
+    int next_j;
+    int64_t total;
+    int ordered;
+} Rows;
+
+/* check every fold of one array of bytes or ints against loops */
+int check_uarray2(UArray2_T uarray2, int threads);
+/* check Bit2_count and Bit2_fold against a loop */
+int check_bit2(Bit2_T bit2, int threads);
+/* init, accumulate and combine of the callback folds */
+void *rows_init(void *cl);
+void uarray2_accumulate(int i, int j, UArray2_T uarray2, void *value,
+                        void *acc, void *cl);
+void bit2_accumulate(int i, int j, Bit2_T bit2, int value, void *acc,
+                     void *cl);
+void *rows_combine(void *left, void *right, void *cl);
+/* note that element [i, j] came next */
+void rows_visit(Rows *rows, int i, int j, int width, int64_t value);
+/* fill an array of bytes or ints, or a bit array, with random values */
+void fill_uarray2(UArray2_T uarray2, unsigned *seed);
+void fill_bit2(Bit2_T bit2, unsigned *seed);
+/* next value of a fixed linear congruential generator */
+unsigned next_random(unsigned *seed);
+
+int main(int argc, char *argv[])
+{
+    (void) argc;
+    (void) argv;
+
+    /* 0 is one thread per online CPU; 1 is the serial path */
+    int threads[] = { 0, 1, 2, 3, 7, 16 };
+    int num_threads = sizeof(threads) / sizeof(int);
+    unsigned seed = 37;
+    int OK = 1;
+
+    int sizes[] = { 1, sizeof(int) };
+    for (int s = 0; s < 2; s++) {
+        int size = sizes[s];
+        const char *kind = size == 1 ? "byte" : "int";
+        UArray2_T arrays[5];
+        const char *names[5] = { "row-major", "column-major", "Morton",
+                                 "row-major view", "one-row" };
+        arrays[0] = UArray2_new(1200, 500, size);
+        arrays[1] = UArray2_new_ordered(900, 700, size, UArray2_COL_MAJOR);
+        arrays[2] = UArray2_new_layout(700, 600, size, &UArray2_morton);
+        arrays[3] = UArray2_view(arrays[0], 11, 9, 1001, 413);
+        arrays[4] = UArray2_new(50, 1, size);
+        for (int a = 0; a < 5; a++) {
+            if (a != 3) {
+                fill_uarray2(arrays[a], &seed);
+            }
+        }
+
+        for (int a = 0; a < 5; a++) {
+            int good = 1;
+            for (int t = 0; t < num_threads; t++) {
+                good &= check_uarray2(arrays[a], threads[t]);
+            }
+            printf("Folds of a %s %s array are %sOK\n", names[a], kind,
+                   good ? "" : "NOT ");
+            OK &= good;
+        }
+        UArray2_free(&arrays[3]);
+        for (int a = 0; a < 5; a++) {
+            if (a != 3) {
+                UArray2_free(&arrays[a]);
+            }
+        }
+    }
+
+    Bit2_T parent = Bit2_new(2000, 700);
+    Bit2_T bits[3] = { parent, Bit2_view(parent, 29, 5, 1900, 650),
+                       Bit2_new(70, 3) };
+    const char *names[3] = { "bit array", "bit array view",
+                             "small bit array" };
+    fill_bit2(bits[0], &seed);
+    fill_bit2(bits[2], &seed);
+    for (int b = 0; b < 3; b++) {
+        int good = 1;
+        for (int t = 0; t < num_threads; t++) {
+            good &= check_bit2(bits[b], threads[t]);
+        }
+        printf("Folds of a %s are %sOK\n", names[b], good ? "" : "NOT ");
+        OK &= good;
+    }
+    Bit2_free(&bits[1]);
+    Bit2_free(&bits[0]);
+    Bit2_free(&bits[2]);
+
+    printf("The folds are %sOK!\n", OK ? "" : "NOT ");
+    return OK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/***********************************************************
+* check_uarray2
+* Description: Check the folds of an array against loops
+* Input: 1) UArray2_T array of unsigned bytes or ints
+*        2) Integer number of threads
+* Output: 1 if the sum, the histogram and UArray2_fold all
+*         matched, 0 if not
+***********************************************************/
+int check_uarray2(UArray2_T uarray2, int threads)
+{
+    int width = UArray2_width(uarray2);
+    int height = UArray2_height(uarray2);
+    int bytes = UArray2_size(uarray2) == 1;
+    int bins = bytes ? 256 : BINS;
+
+    int64_t sum = 0;
+    uint64_t *counts = CALLOC(bins, sizeof(uint64_t));
+    for (int j = 0; j < height; j++) {
+        for (int i = 0; i < width; i++) {
+            int value = bytes ? *(uint8_t *) UArray2_at(uarray2, i, j)
+                              : *(int *) UArray2_at(uarray2, i, j);
+            sum += value;
+            if (value >= 0 && value < bins) {
+                counts[value]++;
+            }
+        }
+    }
+
+    uint64_t *folded = CALLOC(bins, sizeof(uint64_t));
+    int good;
+    if (bytes) {
+        good = UArray2_sum_u8(uarray2, threads) == (uint64_t) sum;
+        UArray2_histogram_u8(uarray2, folded, threads);
+    }
+    else {
+        good = UArray2_sum_int(uarray2, threads) == sum;
+        UArray2_histogram_int(uarray2, bins, folded, threads);
+    }
+    good &= memcmp(folded, counts, bins * sizeof(uint64_t)) == 0;
+
+    Rows *rows = UArray2_fold(uarray2, threads, rows_init,
+                              uarray2_accumulate, rows_combine, &width);
+    good &= rows->ordered && rows->first_row == 0 &&
+            rows->next_i == 0 && rows->next_j == height &&
+            rows->total == sum;
+
+    FREE(rows);
+    FREE(folded);
+    FREE(counts);
+    return good;
+}
+
+/***********************************************************
+* check_bit2
+* Description: Check Bit2_count and Bit2_fold against a loop
+* Input: 1) Bit2_T bit array
+*        2) Integer number of threads
+* Output: 1 if both matched, 0 if not
+***********************************************************/
+int check_bit2(Bit2_T bit2, int threads)
+{
+    int width = Bit2_width(bit2);
+    int height = Bit2_height(bit2);
+
+    int64_t ones = 0;
+    for (int j = 0; j < height; j++) {
+        for (int i = 0; i < width; i++) {
+            ones += Bit2_get(bit2, i, j);
+        }
+    }
+
+    int good = Bit2_count(bit2, threads) == (uint64_t) ones;
+    Rows *rows = Bit2_fold(bit2, threads, rows_init, bit2_accumulate,
+                           rows_combine, &width);
+    good &= rows->ordered && rows->first_row == 0 &&
+            rows->next_i == 0 && rows->next_j == height &&
+            rows->total == ones;
+    FREE(rows);
+    return good;
+}
+
+/***********************************************************
+* rows_init
+* Description: init function of the callback folds
+* Input: Unused closure
+* Output: New Rows that has seen no element
+***********************************************************/
+void *rows_init(void *cl)
+{
+    (void) cl;
+
+    Rows *rows;
+    NEW(rows);
+    rows->first_row = -1;
+    rows->next_i = 0;
+    rows->next_j = 0;
+    rows->total = 0;
+    rows->ordered = 1;
+    return rows;
+}
+
+/***********************************************************
+* uarray2_accumulate, bit2_accumulate
+* Description: accumulate functions of the callback folds
+* Input: 1) Integer column i and row j of the element
+*        2) The array, and the element or bit
+*        3) Pointer to the Rows accumulator
+*        4) Pointer to the width of the array
+* Output: Void
+***********************************************************/
+void uarray2_accumulate(int i, int j, UArray2_T uarray2, void *value,
+                        void *acc, void *cl)
+{
+    int64_t element = UArray2_size(uarray2) == 1 ? *(uint8_t *) value
+                                                 : *(int *) value;
+    rows_visit(acc, i, j, *(int *) cl, element);
+}
+
+void bit2_accumulate(int i, int j, Bit2_T bit2, int value, void *acc,
+                     void *cl)
+{
+    (void) bit2;
+    rows_visit(acc, i, j, *(int *) cl, value);
+}
+
+/***********************************************************
+* rows_visit
+* Description: Add an element to a Rows accumulator
+* Input: 1) Pointer to the Rows
+*        2) Integer column i and row j of the element
+*        3) Integer width of the array
+*        4) The element's value
+* Output: Void
+* Implementation: A band starts at column 0 of some row, and
+*                 each element after must be the one after the
+*                 last in row-major order; if not, the Rows are
+*                 marked out of order.
+***********************************************************/
+void rows_visit(Rows *rows, int i, int j, int width, int64_t value)
+{
+    if (rows->first_row < 0) {
+        rows->first_row = j;
+        rows->next_j = j;
+    }
+    if (i != rows->next_i || j != rows->next_j) {
+        rows->ordered = 0;
+    }
+    rows->total += value;
+    rows->next_i = i + 1;
+    rows->next_j = j;
+    if (rows->next_i == width) {
+        rows->next_i = 0;
+        rows->next_j++;
+    }
+}
+
+/***********************************************************
+* rows_combine
+* Description: combine function of the callback folds
+* Input: 1) Pointers to the Rows of the upper and lower band
+*        2) Unused closure
+* Output: Left, holding both, after right is freed
+* Implementation: The lower band must start where the upper
+*                 one ends; a band with no elements is skipped.
+***********************************************************/
+void *rows_combine(void *left, void *right, void *cl)
+{
+    Rows *upper = left;
+    Rows *lower = right;
+    (void) cl;
+
+    if (upper->first_row < 0) {
+        FREE(upper);
+        return lower;
+    }
+    if (lower->first_row >= 0) {
+        upper->ordered &= lower->ordered &&
+                          upper->next_i == 0 &&
+                          upper->next_j == lower->first_row;
+        upper->total += lower->total;
+        upper->next_i = lower->next_i;
+        upper->next_j = lower->next_j;
+    }
+    FREE(lower);
+    return upper;
+}
+
+/***********************************************************
+* fill_uarray2
+* Description: Fill an array with random values
+* Input: 1) UArray2_T array of unsigned bytes or ints
+*        2) Pointer to the random seed
+* Output: Void
+* Implementation: Bytes take every value; ints are from
+*                 -LIMIT to LIMIT.
+***********************************************************/
+void fill_uarray2(UArray2_T uarray2, unsigned *seed)
+{
+    for (int j = 0; j < UArray2_height(uarray2); j++) {
+        for (int i = 0; i < UArray2_width(uarray2); i++) {
+            unsigned value = next_random(seed);
+            if (UArray2_size(uarray2) == 1) {
+                *(uint8_t *) UArray2_at(uarray2, i, j) = value % 256;
+            }
+            else {
+                *(int *) UArray2_at(uarray2, i, j) =
+                    (int) (value % (2 * LIMIT + 1)) - LIMIT;
+            }
+        }
+    }
+}
+
+/***********************************************************
+* fill_bit2
+* Description: Fill a bit array with random bits, about a
+*              third of them 1
+* Input: 1) Bit2_T bit array
+*        2) Pointer to the random seed
+* Output: Void
+***********************************************************/
+void fill_bit2(Bit2_T bit2, unsigned *seed)
+{
+    for (int j = 0; j < Bit2_height(bit2); j++) {
+        for (int i = 0; i < Bit2_width(bit2); i++) {
+            Bit2_put(bit2, i, j, next_random(seed) % 3 == 0);
+        }
+    }
+}
+
+/***********************************************************
+* next_random
+* Description: Step a linear congruential generator
+* Input: Pointer to the seed, updated
+* Output: 15 random bits
+* Implementation: Same generator as pbmgen.
+***********************************************************/
+unsigned next_random(unsigned *seed)
+{
+    *seed = *seed * 1103515245 + 12345;
+    return (*seed / 65536) % 32768;
+}
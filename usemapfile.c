@@ -0,0 +1,263 @@
+/*************************************************************************
+*                              usemapfile.c
+*
+*
+*      Authors: Jae Hyun Cheigh (jcheig01), Khanh Nguyen (cnguye10)
+*
+*      Fall 2020 - COMP40
+*      HW 2 - Part B
+*
+*
+*      Summary: This program checks UArray2_map_file. It creates an
+*               array file with UArray2_SHARED, fills it, and reopens
+*               it read-only, private and shared, checking the header
+*               gives the dimensions back, the elements are there, and
+*               only shared writes reach the file. Then it checks that
+*               dimensions that disagree with the file, and files that
+*               are missing, empty, truncated, garbage or have a bad
+*               header field, all give NULL. It prints whether the
+*               mapped arrays are OK and exits 1 if not.
+*
+*               The files are made in the current directory, named
+*               after the program, and removed at the end.
+*
+*               "make check" runs it.
+*
+**************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "uarray2.h"
+
+#define ARRAY_FILE "my_usemapfile.array.tmp"
+#define BAD_FILE "my_usemapfile.bad.tmp"
+
+#define WIDTH 37
+#define HEIGHT 23
+/* the header is this long, and its fields start at these bytes */
+#define HEADER 64
+#define VERSION_AT 8
+#define SIZE_AT 12
+#define WIDTH_AT 16
+#define OFFSET_AT 32
+
+/* check that the file holds the elements WIDTH x HEIGHT ints should */
+int check_elements(UArray2_mapmode mode, int changed);
+/* check that a copy of the array file changed by edit gives NULL */
+int check_bad(const char *what, long length, long at, const void *value,
+              int bytes);
+/* read a whole file, or write one */
+char *read_file(const char *path, long *length);
+void write_file(const char *path, const char *bytes, long length);
+
+int main(int argc, char *argv[])
+{
+    (void) argc;
+    (void) argv;
+
+    int OK = 1;
+    remove(ARRAY_FILE);
+
+    /* create, fill, and write back by freeing */
+    UArray2_T array = UArray2_map_file(ARRAY_FILE, WIDTH, HEIGHT,
+                                       sizeof(int), UArray2_SHARED);
+    int good = array != NULL && UArray2_width(array) == WIDTH &&
+               UArray2_height(array) == HEIGHT &&
+               UArray2_size(array) == sizeof(int);
+    for (int j = 0; good && j < HEIGHT; j++) {
+        for (int i = 0; i < WIDTH; i++) {
+            good &= *(int *) UArray2_at(array, i, j) == 0;
+            *(int *) UArray2_at(array, i, j) = 100 * i + j;
+        }
+    }
+    if (array != NULL) {
+        UArray2_free(&array);
+    }
+    good &= check_elements(UArray2_READONLY, 0);
+    printf("Creating a shared array file is %sOK\n", good ? "" : "NOT ");
+    OK &= good;
+
+    /* private writes stay in the process, shared ones reach the file */
+    good = check_elements(UArray2_PRIVATE, 0) &&
+           check_elements(UArray2_READONLY, 0) &&
+           check_elements(UArray2_SHARED, 0) &&
+           check_elements(UArray2_READONLY, 1);
+    printf("Reopening it private and shared is %sOK\n", good ? "" : "NOT ");
+    OK &= good;
+
+    /* dimensions that agree, and ones that do not */
+    int shapes[][3] = { { WIDTH, 0, 0 }, { 0, HEIGHT, 0 },
+                        { 0, 0, sizeof(int) },
+                        { WIDTH, HEIGHT, sizeof(int) },
+                        { WIDTH + 1, 0, 0 }, { 0, HEIGHT - 1, 0 },
+                        { 0, 0, sizeof(double) },
+                        { HEIGHT, WIDTH, sizeof(int) } };
+    good = 1;
+    for (int s = 0; s < 8; s++) {
+        array = UArray2_map_file(ARRAY_FILE, shapes[s][0], shapes[s][1],
+                                 shapes[s][2], UArray2_READONLY);
+        good &= (array != NULL) == (s < 4);
+        if (array != NULL) {
+            UArray2_free(&array);
+        }
+    }
+    printf("Checking dimensions against the file is %sOK\n",
+           good ? "" : "NOT ");
+    OK &= good;
+
+    /* files that are not arrays */
+    uint32_t version = 2;
+    uint32_t size = 0;
+    uint64_t huge = (uint64_t) 1 << 40;
+    uint64_t past_end = HEADER + WIDTH * HEIGHT * sizeof(int) + 8;
+    uint64_t wrapping = UINT64_MAX;
+    good = check_bad("an empty file", 0, -1, NULL, 0) &&
+           check_bad("a file shorter than its header", 40, -1, NULL, 0) &&
+           check_bad("a truncated file", HEADER + 100, -1, NULL, 0) &&
+           check_bad("a bad magic number", -1, 0, "UARRAY3", 8) &&
+           check_bad("a bad version", -1, VERSION_AT, &version, 4) &&
+           check_bad("a size of 0", -1, SIZE_AT, &size, 4) &&
+           check_bad("a huge width", -1, WIDTH_AT, &huge, 8) &&
+           check_bad("an offset past the end", -1, OFFSET_AT, &past_end,
+                     8) &&
+           check_bad("an offset near 2^64", -1, OFFSET_AT, &wrapping, 8);
+
+    char garbage[4096];
+    unsigned seed = 31;
+    for (int b = 0; b < (int) sizeof(garbage); b++) {
+        seed = seed * 1103515245 + 12345;
+        garbage[b] = (char) (seed >> 16);
+    }
+    write_file(BAD_FILE, garbage, sizeof(garbage));
+    array = UArray2_map_file(BAD_FILE, 0, 0, 0, UArray2_READONLY);
+    good &= array == NULL;
+    remove(BAD_FILE);
+    array = UArray2_map_file(BAD_FILE, 0, 0, 0, UArray2_READONLY);
+    good &= array == NULL;
+    array = UArray2_map_file(BAD_FILE, WIDTH, HEIGHT, 0, UArray2_SHARED);
+    good &= array == NULL;
+    remove(BAD_FILE);
+    printf("Rejecting files that are not arrays is %sOK\n",
+           good ? "" : "NOT ");
+    OK &= good;
+
+    remove(ARRAY_FILE);
+    printf("The mapped arrays are %sOK!\n", OK ? "" : "NOT ");
+    return OK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/***********************************************************
+* check_elements
+* Description: Map the array file and check its elements
+* Input: 1) Mode to map it with
+*        2) Integer, 1 if the elements were changed by a
+*           shared map, 0 if not
+* Output: 1 if the dimensions come from the header and every
+*         element is as expected, 0 if not
+* Implementation: Element [i, j] is 100 * i + j, negated if
+*                 changed. Private and shared maps then negate
+*                 every element, so a later map shows whether
+*                 the writes reached the file.
+***********************************************************/
+int check_elements(UArray2_mapmode mode, int changed)
+{
+    UArray2_T array = UArray2_map_file(ARRAY_FILE, 0, 0, 0, mode);
+    if (array == NULL) {
+        return 0;
+    }
+
+    int good = UArray2_width(array) == WIDTH &&
+               UArray2_height(array) == HEIGHT &&
+               UArray2_size(array) == sizeof(int);
+    for (int j = 0; good && j < HEIGHT; j++) {
+        for (int i = 0; i < WIDTH; i++) {
+            int *element = UArray2_at(array, i, j);
+            good &= *element == (changed ? -1 : 1) * (100 * i + j);
+            if (mode != UArray2_READONLY) {
+                *element = -*element;
+            }
+        }
+    }
+    UArray2_free(&array);
+    return good;
+}
+
+/***********************************************************
+* check_bad
+* Description: Check that a damaged copy of the array file is
+*              not mapped
+* Input: 1) Name of the damage, printed if it is mapped
+*        2) Bytes of the file to keep, or -1 for all
+*        3) Byte at which to write a value, or -1 for none
+*        4) The value and its number of bytes
+* Output: 1 if UArray2_map_file gave NULL, read-only and
+*         private, 0 if not
+***********************************************************/
+int check_bad(const char *what, long length, long at, const void *value,
+              int bytes)
+{
+    long full;
+    char *contents = read_file(ARRAY_FILE, &full);
+    if (contents == NULL) {
+        return 0;
+    }
+    if (at >= 0) {
+        memcpy(contents + at, value, bytes);
+    }
+    write_file(BAD_FILE, contents, length >= 0 ? length : full);
+    free(contents);
+
+    int good = 1;
+    for (int mode = 0; mode < 2; mode++) {
+        UArray2_T array = UArray2_map_file(BAD_FILE, 0, 0, 0,
+                                           mode == 0 ? UArray2_READONLY
+                                                     : UArray2_PRIVATE);
+        if (array != NULL) {
+            fprintf(stderr, "%s was mapped\n", what);
+            UArray2_free(&array);
+            good = 0;
+        }
+    }
+    remove(BAD_FILE);
+    return good;
+}
+
+/***********************************************************
+* read_file, write_file
+* Description: Read a whole file into a block from malloc,
+*              or write a block as a whole file
+* Input: Name of the file, and the block and its length
+* Output: read_file gives the block, or NULL if the file
+*         cannot be read, and sets *length
+***********************************************************/
+char *read_file(const char *path, long *length)
+{
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL) {
+        return NULL;
+    }
+    fseek(fp, 0, SEEK_END);
+    *length = ftell(fp);
+    rewind(fp);
+    char *bytes = malloc(*length + 1);
+    if (bytes == NULL ||
+        fread(bytes, 1, *length, fp) != (size_t) *length) {
+        free(bytes);
+        bytes = NULL;
+    }
+    fclose(fp);
+    return bytes;
+}
+
+void write_file(const char *path, const char *bytes, long length)
+{
+    FILE *fp = fopen(path, "wb");
+    if (fp == NULL) {
+        fprintf(stderr, "Could not write %s\n", path);
+        exit(EXIT_FAILURE);
+    }
+    fwrite(bytes, 1, length, fp);
+    fclose(fp);
+}
@@ -0,0 +1,244 @@
+/*************************************************************************
+*                              usemapuntil.c
+*
+*
+*      Authors: Jae Hyun Cheigh (jcheig01), Khanh Nguyen (cnguye10)
+*
+*      Fall 2020 - COMP40
+*      HW 2 - Part D
+*
+*
+*      Summary: This program checks UArray2_map_row_major_until,
+*               UArray2_map_col_major_until, Bit2_map_row_major_until
+*               and Bit2_map_col_major_until. On arrays of several
+*               sizes and orders, and on views, it has apply stop at
+*               the first element, the second, one in the middle and
+*               the last, and not at all, and checks the elements were
+*               visited in order up to the stop, the result, and the
+*               stop_i and stop_j given back, which must be left alone
+*               when nothing stops. It prints whether the maps are OK
+*               and exits 1 if not.
+*
+*               "make check" runs it.
+*
+**************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "uarray2.h"
+#include "bit2.h"
+
+/* what stop_i and stop_j start as, to see if they are written */
+#define UNTOUCHED -99
+
+/* what a map has visited: element number next comes next */
+typedef struct Visit {
+    int col_major;
+    int next;
+    int stop_at;
+    int ordered;
+} Visit;
+
+/* apply functions, stopping at element number stop_at */
+int visit_element(int i, int j, UArray2_T uarray2, void *value, void *cl);
+int visit_bit(int i, int j, Bit2_T bit2, int value, void *cl);
+/* check that a map visited and stopped where it should have */
+int check_stop(Visit *visit, int stopped, int stop_i, int stop_j,
+               int width, int height);
+/* check both until maps on one array, stopping at every place */
+int check_uarray2(UArray2_T uarray2);
+int check_bit2(Bit2_T bit2);
+
+int main(int argc, char *argv[])
+{
+    (void) argc;
+    (void) argv;
+
+    int sizes[][2] = { { 1, 1 }, { 7, 5 }, { 64, 3 }, { 1, 9 },
+                       { 131, 67 } };
+    int num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+    int OK = 1;
+
+    int good = 1;
+    for (int s = 0; s < num_sizes; s++) {
+        int width = sizes[s][0];
+        int height = sizes[s][1];
+        UArray2_T arrays[4] = {
+            UArray2_new(width, height, sizeof(int)),
+            UArray2_new_ordered(width, height, sizeof(int),
+                                UArray2_COL_MAJOR),
+            UArray2_new_layout(width, height, sizeof(int),
+                               &UArray2_morton),
+            UArray2_new(width + 7, height + 5, sizeof(int))
+        };
+        UArray2_T view = UArray2_view(arrays[3], 3, 2, width, height);
+        for (int a = 0; a < 3; a++) {
+            good &= check_uarray2(arrays[a]);
+            UArray2_free(&arrays[a]);
+        }
+        good &= check_uarray2(view);
+        UArray2_free(&view);
+        UArray2_free(&arrays[3]);
+    }
+    printf("Stopping unboxed array maps is %sOK\n", good ? "" : "NOT ");
+    OK &= good;
+
+    good = 1;
+    for (int s = 0; s < num_sizes; s++) {
+        int width = sizes[s][0];
+        int height = sizes[s][1];
+        Bit2_T bit2 = Bit2_new(width, height);
+        Bit2_T parent = Bit2_new(width + 77, height + 5);
+        Bit2_T view = Bit2_view(parent, 37, 3, width, height);
+        for (int j = 0; j < height; j++) {
+            for (int i = 0; i < width; i++) {
+                Bit2_put(bit2, i, j, (i * 7 + j * 3) % 5 == 0);
+                Bit2_put(view, i, j, (i + j) % 3 == 0);
+            }
+        }
+        good &= check_bit2(bit2) && check_bit2(view);
+        Bit2_free(&view);
+        Bit2_free(&parent);
+        Bit2_free(&bit2);
+    }
+    printf("Stopping bit array maps is %sOK\n", good ? "" : "NOT ");
+    OK &= good;
+
+    printf("The stopping maps are %sOK!\n", OK ? "" : "NOT ");
+    return OK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/***********************************************************
+* visit_element, visit_bit
+* Description: Apply functions that check the visit is the
+*              next in order and stop at element stop_at
+* Input: Column i, row j, the array, the element or its value,
+*        and the Visit
+* Output: Nonzero, varying, to stop at element stop_at, and 0
+*         before it
+***********************************************************/
+int visit_element(int i, int j, UArray2_T uarray2, void *value, void *cl)
+{
+    Visit *visit = cl;
+    int width = UArray2_width(uarray2);
+    int height = UArray2_height(uarray2);
+    int number = visit->col_major ? i * height + j : j * width + i;
+
+    visit->ordered &= number == visit->next &&
+                      value == UArray2_at(uarray2, i, j);
+    visit->next++;
+    return number == visit->stop_at ? number + 1 : 0;
+}
+
+int visit_bit(int i, int j, Bit2_T bit2, int value, void *cl)
+{
+    Visit *visit = cl;
+    int width = Bit2_width(bit2);
+    int height = Bit2_height(bit2);
+    int number = visit->col_major ? i * height + j : j * width + i;
+
+    visit->ordered &= number == visit->next &&
+                      value == Bit2_get(bit2, i, j);
+    visit->next++;
+    return number == visit->stop_at ? -1 - number : 0;
+}
+
+/***********************************************************
+* check_stop
+* Description: Check what an until map did
+* Input: 1) Pointer to the Visit after the map
+*        2) Integer result of the map, and the stop_i and stop_j
+*           it gave back, which started as UNTOUCHED
+*        3) Integer width and height of the array
+* Output: 1 if the elements were visited in order, and either
+*         the map stopped at element stop_at, after visiting it,
+*         and gave back its column and row, or stop_at was past
+*         the end, every element was visited, the result was 0
+*         and stop_i and stop_j were left alone, 0 if not
+***********************************************************/
+int check_stop(Visit *visit, int stopped, int stop_i, int stop_j,
+               int width, int height)
+{
+    int count = width * height;
+    if (visit->stop_at >= count) {
+        return visit->ordered && visit->next == count && stopped == 0 &&
+               stop_i == UNTOUCHED && stop_j == UNTOUCHED;
+    }
+
+    int number = visit->stop_at;
+    int i = visit->col_major ? number / height : number % width;
+    int j = visit->col_major ? number % height : number / width;
+    return visit->ordered && visit->next == number + 1 && stopped == 1 &&
+           stop_i == i && stop_j == j;
+}
+
+/***********************************************************
+* check_uarray2, check_bit2
+* Description: Check both until maps on one array
+* Input: UArray2_T or Bit2_T array of at least one element
+* Output: 1 if stopping at the first, second, middle and last
+*         elements, and not stopping, all went as check_stop
+*         says, and a map given null stop_i and stop_j still
+*         stopped, 0 if not
+***********************************************************/
+int check_uarray2(UArray2_T uarray2)
+{
+    int width = UArray2_width(uarray2);
+    int height = UArray2_height(uarray2);
+    int count = width * height;
+    int stops[5] = { 0, 1, count / 2, count - 1, count };
+    int good = 1;
+
+    for (int col_major = 0; col_major <= 1; col_major++) {
+        for (int s = 0; s < 5; s++) {
+            Visit visit = { col_major, 0, stops[s], 1 };
+            int stop_i = UNTOUCHED, stop_j = UNTOUCHED;
+            int stopped = col_major
+                ? UArray2_map_col_major_until(uarray2, visit_element,
+                                              &visit, &stop_i, &stop_j)
+                : UArray2_map_row_major_until(uarray2, visit_element,
+                                              &visit, &stop_i, &stop_j);
+            good &= check_stop(&visit, stopped, stop_i, stop_j, width,
+                               height);
+        }
+
+        Visit visit = { col_major, 0, count / 2, 1 };
+        int stopped = col_major
+            ? UArray2_map_col_major_until(uarray2, visit_element, &visit,
+                                          NULL, NULL)
+            : UArray2_map_row_major_until(uarray2, visit_element, &visit,
+                                          NULL, NULL);
+        good &= stopped == 1 && visit.next == count / 2 + 1;
+    }
+    return good;
+}
+
+int check_bit2(Bit2_T bit2)
+{
+    int width = Bit2_width(bit2);
+    int height = Bit2_height(bit2);
+    int count = width * height;
+    int stops[5] = { 0, 1, count / 2, count - 1, count };
+    int good = 1;
+
+    for (int col_major = 0; col_major <= 1; col_major++) {
+        for (int s = 0; s < 5; s++) {
+            Visit visit = { col_major, 0, stops[s], 1 };
+            int stop_i = UNTOUCHED, stop_j = UNTOUCHED;
+            int stopped = col_major
+                ? Bit2_map_col_major_until(bit2, visit_bit, &visit,
+                                           &stop_i, &stop_j)
+                : Bit2_map_row_major_until(bit2, visit_bit, &visit,
+                                           &stop_i, &stop_j);
+            good &= check_stop(&visit, stopped, stop_i, stop_j, width,
+                               height);
+        }
+
+        Visit visit = { col_major, 0, count / 2, 1 };
+        int stopped = col_major
+            ? Bit2_map_col_major_until(bit2, visit_bit, &visit, NULL, NULL)
+            : Bit2_map_row_major_until(bit2, visit_bit, &visit, NULL, NULL);
+        good &= stopped == 1 && visit.next == count / 2 + 1;
+    }
+    return good;
+}
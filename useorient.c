@@ -0,0 +1,390 @@
+/*************************************************************************
+*                              useorient.c
+*
+*
+*      Authors: Jae Hyun Cheigh (jcheig01), Khanh Nguyen (cnguye10)
+*
+*      Fall 2020 - COMP40
+*      HW 2 - Part D
+*
+*
+*      Summary: This program checks Bit2_orient_into, Bit2_orient,
+*               UArray2_orient_into and UArray2_orient against moving
+*               one element at a time. For every orientation it turns
+*               random arrays whose sides are and are not multiples of
+*               64, including exactly 64 x 64, between plain arrays,
+*               views whose base is partway into a word, wraps whose
+*               rows do not start on words, and column-major and
+*               Morton arrays, and checks every element landed where
+*               the turn puts it and that nothing around a view or
+*               wrap changed. It prints whether the turns are OK and
+*               exits 1 if not.
+*
+*               "make check" runs it.
+*
+**************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "bit2.h"
+#include "uarray2.h"
+#include "mem.h"
+
+/* how a test bit array is made */
+typedef enum { BIT2_PLAIN, BIT2_VIEW, BIT2_WRAP, BIT2_KINDS } Bit2_kind;
+
+/* how a test unboxed array is made */
+typedef enum {
+    UARRAY2_ROW, UARRAY2_COL, UARRAY2_MORTON, UARRAY2_ROW_VIEW,
+    UARRAY2_COL_VIEW, UARRAY2_KINDS
+} UArray2_kind;
+
+/*
+ * a test array, the array it is part of (itself if it is not a
+ * view or wrap) and where in it, and the words of a wrap
+ */
+typedef struct Bit2_made {
+    Bit2_T bit2;
+    Bit2_T parent;
+    int i, j;
+    uint64_t *words;
+} Bit2_made;
+
+typedef struct UArray2_made {
+    UArray2_T array;
+    UArray2_T parent;
+    int i, j;
+} UArray2_made;
+
+/* where a turn puts element [i, j] of a width x height array */
+void destination(int how, int width, int height, int i, int j, int *x,
+                 int *y);
+/* make a bit array, with random bits in it and around it */
+Bit2_made make_bit2(Bit2_kind kind, int width, int height, unsigned *seed);
+void free_bit2(Bit2_made *made);
+/* check one turn of a bit array */
+int check_bit2(int width, int height, Bit2_kind from, Bit2_kind to,
+               Bit2_orientation how, unsigned *seed);
+/* make an unboxed array of ints, with random ones in and around it */
+UArray2_made make_uarray2(UArray2_kind kind, int width, int height,
+                          unsigned *seed);
+void free_uarray2(UArray2_made *made);
+/* check one turn of an unboxed array */
+int check_uarray2(int width, int height, UArray2_kind from,
+                  UArray2_kind to, UArray2_orientation how,
+                  unsigned *seed);
+/* next value of a fixed linear congruential generator */
+unsigned next_random(unsigned *seed);
+
+int main(int argc, char *argv[])
+{
+    (void) argc;
+    (void) argv;
+
+    int sizes[][2] = { { 1, 1 }, { 64, 64 }, { 63, 65 }, { 130, 67 },
+                       { 200, 129 }, { 1, 100 } };
+    int num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+    const char *names[6] = { "Transposing", "Rotating by 90",
+                             "Rotating by 180", "Rotating by 270",
+                             "Flipping horizontally",
+                             "Flipping vertically" };
+    unsigned seed = 35;
+    int OK = 1;
+
+    for (int how = 0; how < 6; how++) {
+        int good = 1;
+        for (int s = 0; s < num_sizes; s++) {
+            for (int from = 0; from < BIT2_KINDS; from++) {
+                for (int to = 0; to < BIT2_KINDS; to++) {
+                    good &= check_bit2(sizes[s][0], sizes[s][1], from, to,
+                                       how, &seed);
+                }
+            }
+        }
+        printf("%s bit arrays is %sOK\n", names[how], good ? "" : "NOT ");
+        OK &= good;
+
+        good = 1;
+        for (int s = 0; s < num_sizes; s++) {
+            for (int from = 0; from < UARRAY2_KINDS; from++) {
+                for (int to = 0; to < UARRAY2_KINDS; to++) {
+                    good &= check_uarray2(sizes[s][0], sizes[s][1], from,
+                                          to, how, &seed);
+                }
+            }
+        }
+        printf("%s unboxed arrays is %sOK\n", names[how],
+               good ? "" : "NOT ");
+        OK &= good;
+    }
+
+    printf("The turned arrays are %sOK!\n", OK ? "" : "NOT ");
+    return OK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/***********************************************************
+* destination
+* Description: Find where a turn puts an element
+* Input: 1) Integer how, a Bit2_orientation or the
+*           UArray2_orientation in the same place
+*        2) Integer width and height of the array turned
+*        3) Integer column i and row j of the element
+*        4) Integer pointers x and y for its new place
+* Output: Void
+* Implementation: Rotations are clockwise, so the top row
+*                 becomes the right column at 90 degrees.
+***********************************************************/
+void destination(int how, int width, int height, int i, int j, int *x,
+                 int *y)
+{
+    switch (how) {
+    case Bit2_TRANSPOSE:       *x = j;              *y = i;              break;
+    case Bit2_ROTATE_90:       *x = height - 1 - j; *y = i;              break;
+    case Bit2_ROTATE_180:      *x = width - 1 - i;  *y = height - 1 - j; break;
+    case Bit2_ROTATE_270:      *x = j;              *y = width - 1 - i;  break;
+    case Bit2_FLIP_HORIZONTAL: *x = width - 1 - i;  *y = j;              break;
+    default:                   *x = i;              *y = height - 1 - j; break;
+    }
+}
+
+/***********************************************************
+* make_bit2, free_bit2
+* Description: Make a bit array to turn or turn into, or free
+*              one
+* Input: 1) Bit2_kind: a new bit array, a view starting 37
+*           bits into a word of a bigger one, or a wrap whose
+*           rows are 13 bits longer than it
+*        2) Integer width and height
+*        3) Pointer to the seed
+* Output: Bit2_made holding the bit array and its parent, every
+*         bit of the parent random
+***********************************************************/
+Bit2_made make_bit2(Bit2_kind kind, int width, int height, unsigned *seed)
+{
+    Bit2_made made = { NULL, NULL, 0, 0, NULL };
+
+    if (kind == BIT2_PLAIN) {
+        made.bit2 = made.parent = Bit2_new(width, height);
+    }
+    else if (kind == BIT2_VIEW) {
+        made.parent = Bit2_new(width + 77, height + 5);
+        made.i = 37;
+        made.j = 3;
+        made.bit2 = Bit2_view(made.parent, made.i, made.j, width, height);
+    }
+    else {
+        int stride = width + 13;
+        made.words = CALLOC(((long) stride * height + 63) / 64,
+                            sizeof(uint64_t));
+        made.parent = Bit2_wrap(made.words, stride, height, stride);
+        made.bit2 = Bit2_wrap(made.words, width, height, stride);
+    }
+
+    for (int j = 0; j < Bit2_height(made.parent); j++) {
+        for (int i = 0; i < Bit2_width(made.parent); i++) {
+            Bit2_put(made.parent, i, j, next_random(seed) & 1);
+        }
+    }
+    return made;
+}
+
+void free_bit2(Bit2_made *made)
+{
+    if (made->parent != made->bit2) {
+        Bit2_free(&made->parent);
+    }
+    Bit2_free(&made->bit2);
+    if (made->words != NULL) {
+        FREE(made->words);
+    }
+}
+
+/***********************************************************
+* check_bit2
+* Description: Check Bit2_orient_into and Bit2_orient on one
+*              turn of one size of bit array
+* Input: 1) Integer width and height of the bit array turned
+*        2) Bit2_kind of the bit array turned and turned into
+*        3) Bit2_orientation of the turn
+*        4) Pointer to the seed
+* Output: 1 if every bit is where destination puts it, the
+*         bits around the destination kept their values, and
+*         Bit2_orient gave the same bits, 0 if not
+***********************************************************/
+int check_bit2(int width, int height, Bit2_kind from, Bit2_kind to,
+               Bit2_orientation how, unsigned *seed)
+{
+    int swap = how == Bit2_TRANSPOSE || how == Bit2_ROTATE_90 ||
+               how == Bit2_ROTATE_270;
+    Bit2_made source = make_bit2(from, width, height, seed);
+    Bit2_made dest = make_bit2(to, swap ? height : width,
+                               swap ? width : height, seed);
+    Bit2_T before = Bit2_clone(dest.parent);
+
+    Bit2_orient_into(dest.bit2, source.bit2, how);
+    Bit2_T turned = Bit2_orient(source.bit2, how);
+
+    int good = Bit2_width(turned) == Bit2_width(dest.bit2) &&
+               Bit2_height(turned) == Bit2_height(dest.bit2);
+    for (int j = 0; good && j < height; j++) {
+        for (int i = 0; i < width; i++) {
+            int x, y;
+            destination(how, width, height, i, j, &x, &y);
+            int bit = Bit2_get(source.bit2, i, j);
+            good &= Bit2_get(dest.bit2, x, y) == bit &&
+                    Bit2_get(turned, x, y) == bit;
+        }
+    }
+
+    int dest_width = Bit2_width(dest.bit2);
+    int dest_height = Bit2_height(dest.bit2);
+    for (int j = 0; good && j < Bit2_height(dest.parent); j++) {
+        for (int i = 0; i < Bit2_width(dest.parent); i++) {
+            int inside = i >= dest.i && i < dest.i + dest_width &&
+                         j >= dest.j && j < dest.j + dest_height;
+            good &= inside || Bit2_get(dest.parent, i, j) ==
+                              Bit2_get(before, i, j);
+        }
+    }
+
+    Bit2_free(&turned);
+    Bit2_free(&before);
+    free_bit2(&dest);
+    free_bit2(&source);
+    return good;
+}
+
+/***********************************************************
+* make_uarray2, free_uarray2
+* Description: Make an unboxed array of ints to turn or turn
+*              into, or free one
+* Input: 1) UArray2_kind: row-major, column-major or Morton
+*           order, or a view into a bigger row-major or
+*           column-major array
+*        2) Integer width and height
+*        3) Pointer to the seed
+* Output: UArray2_made holding the array and its parent, every
+*         element of the parent random
+***********************************************************/
+UArray2_made make_uarray2(UArray2_kind kind, int width, int height,
+                          unsigned *seed)
+{
+    UArray2_made made = { NULL, NULL, 0, 0 };
+    int size = sizeof(int);
+
+    switch (kind) {
+    case UARRAY2_ROW:
+        made.parent = UArray2_new(width, height, size);
+        break;
+    case UARRAY2_COL:
+        made.parent = UArray2_new_ordered(width, height, size,
+                                          UArray2_COL_MAJOR);
+        break;
+    case UARRAY2_MORTON:
+        made.parent = UArray2_new_layout(width, height, size,
+                                         &UArray2_morton);
+        break;
+    case UARRAY2_ROW_VIEW:
+        made.parent = UArray2_new(width + 7, height + 5, size);
+        break;
+    default:
+        made.parent = UArray2_new_ordered(width + 7, height + 5, size,
+                                          UArray2_COL_MAJOR);
+        break;
+    }
+    if (kind == UARRAY2_ROW_VIEW || kind == UARRAY2_COL_VIEW) {
+        made.i = 3;
+        made.j = 2;
+        made.array = UArray2_view(made.parent, made.i, made.j, width,
+                                  height);
+    }
+    else {
+        made.array = made.parent;
+    }
+
+    for (int j = 0; j < UArray2_height(made.parent); j++) {
+        for (int i = 0; i < UArray2_width(made.parent); i++) {
+            *(int *) UArray2_at(made.parent, i, j) = next_random(seed);
+        }
+    }
+    return made;
+}
+
+void free_uarray2(UArray2_made *made)
+{
+    if (made->parent != made->array) {
+        UArray2_free(&made->parent);
+    }
+    UArray2_free(&made->array);
+}
+
+/***********************************************************
+* check_uarray2
+* Description: Check UArray2_orient_into and UArray2_orient
+*              on one turn of one size of unboxed array
+* Input: 1) Integer width and height of the array turned
+*        2) UArray2_kind of the array turned and turned into
+*        3) UArray2_orientation of the turn
+*        4) Pointer to the seed
+* Output: 1 if every element is where destination puts it,
+*         the elements around the destination kept their
+*         values, and UArray2_orient gave the same elements, 0
+*         if not
+***********************************************************/
+int check_uarray2(int width, int height, UArray2_kind from,
+                  UArray2_kind to, UArray2_orientation how,
+                  unsigned *seed)
+{
+    int swap = how == UArray2_TRANSPOSE || how == UArray2_ROTATE_90 ||
+               how == UArray2_ROTATE_270;
+    UArray2_made source = make_uarray2(from, width, height, seed);
+    UArray2_made dest = make_uarray2(to, swap ? height : width,
+                                     swap ? width : height, seed);
+    UArray2_T before = UArray2_clone(dest.parent);
+
+    UArray2_orient_into(dest.array, source.array, how);
+    UArray2_T turned = UArray2_orient(source.array, how);
+
+    int good = UArray2_width(turned) == UArray2_width(dest.array) &&
+               UArray2_height(turned) == UArray2_height(dest.array);
+    for (int j = 0; good && j < height; j++) {
+        for (int i = 0; i < width; i++) {
+            int x, y;
+            destination(how, width, height, i, j, &x, &y);
+            int value = *(int *) UArray2_at(source.array, i, j);
+            good &= *(int *) UArray2_at(dest.array, x, y) == value &&
+                    *(int *) UArray2_at(turned, x, y) == value;
+        }
+    }
+
+    int dest_width = UArray2_width(dest.array);
+    int dest_height = UArray2_height(dest.array);
+    for (int j = 0; good && j < UArray2_height(dest.parent); j++) {
+        for (int i = 0; i < UArray2_width(dest.parent); i++) {
+            int inside = i >= dest.i && i < dest.i + dest_width &&
+                         j >= dest.j && j < dest.j + dest_height;
+            good &= inside || *(int *) UArray2_at(dest.parent, i, j) ==
+                              *(int *) UArray2_at(before, i, j);
+        }
+    }
+
+    UArray2_free(&turned);
+    UArray2_free(&before);
+    free_uarray2(&dest);
+    free_uarray2(&source);
+    return good;
+}
+
+/***********************************************************
+* next_random
+* Description: Step a linear congruential generator
+* Input: Pointer to the seed, updated
+* Output: 15 random bits
+* Implementation: Same generator as pbmgen.
+***********************************************************/
+unsigned next_random(unsigned *seed)
+{
+    *seed = *seed * 1103515245 + 12345;
+    return (*seed / 65536) % 32768;
+}
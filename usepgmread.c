@@ -0,0 +1,170 @@
+/*************************************************************************
+*                              usepgmread.c
+*
+*
+*      Authors: Jae Hyun Cheigh (jcheig01), Khanh Nguyen (cnguye10)
+*
+*      Fall 2020 - COMP40
+*      HW 2 - Part B
+*
+*
+*      Summary: This program checks read_pgm_header and read_pgm_pixels
+*               on pnm headers Pnmrdr_T accepts, with comments and
+*               whitespace in every place they may go, and on ones it
+*               rejects: a bad magic number, a missing, non-numeric or
+*               out of range field, an early end, and no separator or
+*               a comment where a raw file needs one whitespace byte.
+*               After each accepted graymap header it appends pixels
+*               and checks they are read back. It prints whether the
+*               headers are OK and exits 1 if not.
+*
+*               "make check" runs it.
+*
+**************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "pgmread.h"
+
+/* a header, and the fields read from it, or a format of 0 if rejected */
+typedef struct Header_case {
+    const char *bytes;
+    Pgm_header expected;
+} Header_case;
+
+/* check one case, returning 1 if it is read as expected */
+int check_case(const Header_case *test);
+
+int main(int argc, char *argv[])
+{
+    (void) argc;
+    (void) argv;
+
+    Header_case accepted[] = {
+        { "P2\n9 9\n9\n",                  { 2, 9, 9, 9 } },
+        { "P2\n9 9\n9#x\n",                { 2, 9, 9, 9 } },
+        { "P2\n9 9\n9 # after maxval\n",   { 2, 9, 9, 9 } },
+        { "P2\n9 9\n9#\n#another\n",       { 2, 9, 9, 9 } },
+        { "P2#x\n9#x\n9#x\n9\n",           { 2, 9, 9, 9 } },
+        { "P2 # c\n 9\t9\r\n9\t",          { 2, 9, 9, 9 } },
+        { "P2\n4 4\n4\n",                  { 2, 4, 4, 4 } },
+        { "P2\n0009 09\n009\n",            { 2, 9, 9, 9 } },
+        { "P2\n9 9\n65535\n",              { 2, 9, 9, 65535 } },
+        { "P5\n9 9\n9\n",                  { 5, 9, 9, 9 } },
+        { "P5 # c\n9 9\n#x\n9 ",           { 5, 9, 9, 9 } },
+        { "P5\n9 9\n255\r",                { 5, 9, 9, 255 } },
+        { "P1\n9 9\n",                     { 1, 9, 9, 1 } },
+        { "P1\n9 9#x\n",                   { 1, 9, 9, 1 } },
+        { "P4\n9 9\n",                     { 4, 9, 9, 1 } },
+        { "P3\n9 9\n9#x\n",                { 3, 9, 9, 9 } },
+        { "P6\n9 9\n9\n",                  { 6, 9, 9, 9 } },
+    };
+    Header_case rejected[] = {
+        { "",                              { 0, 0, 0, 0 } },
+        { "P",                             { 0, 0, 0, 0 } },
+        { "P2",                            { 0, 0, 0, 0 } },
+        { "Q2\n9 9\n9\n",                  { 0, 0, 0, 0 } },
+        { "p2\n9 9\n9\n",                  { 0, 0, 0, 0 } },
+        { "P0\n9 9\n9\n",                  { 0, 0, 0, 0 } },
+        { "P7\n9 9\n9\n",                  { 0, 0, 0, 0 } },
+        { " P2\n9 9\n9\n",                 { 0, 0, 0, 0 } },
+        { "P 2\n9 9\n9\n",                 { 0, 0, 0, 0 } },
+        { "P2\n9\n",                       { 0, 0, 0, 0 } },
+        { "P2\n9 9\n",                     { 0, 0, 0, 0 } },
+        { "P2\n9 9\n9",                    { 0, 0, 0, 0 } },
+        { "P2\nx 9\n9\n",                  { 0, 0, 0, 0 } },
+        { "P2\n9 x\n9\n",                  { 0, 0, 0, 0 } },
+        { "P2\n9 9\nx\n",                  { 0, 0, 0, 0 } },
+        { "P2\n-9 9\n9\n",                 { 0, 0, 0, 0 } },
+        { "P2\n9 9\n0\n",                  { 0, 0, 0, 0 } },
+        { "P2\n9 9\n65536\n",              { 0, 0, 0, 0 } },
+        { "P2\n9 9\n9x\n",                 { 0, 0, 0, 0 } },
+        { "P2\n9 9 # no newline",          { 0, 0, 0, 0 } },
+        { "P2\n9 9\n9#x",                  { 0, 0, 0, 0 } },
+        { "P5\n9 9\n9#x\n",                { 0, 0, 0, 0 } },
+        { "P5\n9 9\n9",                    { 0, 0, 0, 0 } },
+        { "P4\n9 9#x\n",                   { 0, 0, 0, 0 } },
+        { "P6\n9 9\n9#x\n",                { 0, 0, 0, 0 } },
+    };
+    int OK = 1;
+
+    int good = 1;
+    for (size_t c = 0; c < sizeof(accepted) / sizeof(accepted[0]); c++) {
+        good &= check_case(&accepted[c]);
+    }
+    printf("Reading good headers is %sOK\n", good ? "" : "NOT ");
+    OK &= good;
+
+    good = 1;
+    for (size_t c = 0; c < sizeof(rejected) / sizeof(rejected[0]); c++) {
+        good &= check_case(&rejected[c]);
+    }
+    printf("Rejecting bad headers is %sOK\n", good ? "" : "NOT ");
+    OK &= good;
+
+    printf("The pnm headers are %sOK!\n", OK ? "" : "NOT ");
+    return OK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/***********************************************************
+* check_case
+* Description: Read a header and, for a graymap, its pixels
+* Input: Header_case holding the bytes and what they give
+* Output: 1 if read_pgm_header accepts exactly the headers
+*         expected, with the fields expected, and the pixels
+*         after a graymap header are read back, 0 if not
+* Implementation: The bytes go in a tmpfile. A graymap with
+*                 maxval below 256 gets width x height pixels
+*                 appended, counting from 1 to maxval, written in
+*                 decimal for P2 and as bytes for P5, so a raw
+*                 separator left unread shows up as the first
+*                 pixel.
+***********************************************************/
+int check_case(const Header_case *test)
+{
+    const Pgm_header *expected = &test->expected;
+    int graymap = (expected->format == 2 || expected->format == 5) &&
+                  expected->maxval < 256;
+    int count = graymap ? (int) (expected->width * expected->height) : 0;
+
+    FILE *fp = tmpfile();
+    if (fp == NULL) {
+        fprintf(stderr, "Could not make a temporary file\n");
+        exit(EXIT_FAILURE);
+    }
+    fputs(test->bytes, fp);
+    for (int idx = 0; idx < count; idx++) {
+        unsigned pixel = idx % expected->maxval + 1;
+        if (expected->format == 2) {
+            fprintf(fp, "%u ", pixel);
+        }
+        else {
+            putc((int) pixel, fp);
+        }
+    }
+    rewind(fp);
+
+    Pgm_header header;
+    int read = read_pgm_header(fp, &header);
+    int good = read == (expected->format != 0);
+    if (good && read) {
+        good = header.format == expected->format &&
+               header.width == expected->width &&
+               header.height == expected->height &&
+               header.maxval == expected->maxval;
+    }
+
+    if (good && count > 0) {
+        unsigned char pixels[count];
+        good = read_pgm_pixels(fp, &header, pixels, count);
+        for (int idx = 0; good && idx < count; idx++) {
+            good = pixels[idx] == idx % expected->maxval + 1;
+        }
+    }
+    if (!good) {
+        fprintf(stderr, "The header \"%s\" was not read as expected\n",
+                test->bytes);
+    }
+    fclose(fp);
+    return good;
+}
@@ -0,0 +1,411 @@
+/*************************************************************************
+*                              userle.c
+*
+*
+*      Authors: Jae Hyun Cheigh (jcheig01), Khanh Nguyen (cnguye10)
+*
+*      Fall 2020 - COMP40
+*      HW 2 - Part D
+*
+*
+*      Summary: This program checks Bit2RLE_T against the Bit2_T it
+*               encodes. It converts bit arrays and views of runs of
+*               random lengths, including empty and all black rows
+*               and runs crossing words, to runs and back, and checks
+*               Bit2RLE_get on every bit, the runs read by number and
+*               by the maps, and the bits around a view written by
+*               Bit2RLE_to_bit2. It builds arrays with Bit2RLE_add_run,
+*               some runs touching, and removes random sets of runs
+*               with Bit2RLE_remove_runs. Last, it unblacks random
+*               noisy pages with both unblack and unblack_runs and
+*               checks they leave the same pixels. It prints whether
+*               the runs are OK and exits 1 if not.
+*
+*               "make check" runs it.
+*
+**************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "bit2.h"
+#include "bit2rle.h"
+#include "unblack.h"
+#include "arena.h"
+#include "mem.h"
+
+/* what a map has seen: the next bit, or the end of the last run */
+typedef struct Walk {
+    Bit2_T bit2;
+    int i, j;
+    size_t runs;
+    int good;
+} Walk;
+
+/* fill a bit array with runs of random lengths */
+void fill_runs(Bit2_T bit2, int longest, unsigned *seed);
+/* check a Bit2RLE_T has exactly the bits of a Bit2_T */
+int rle_matches(Bit2RLE_T rle, Bit2_T bit2);
+/* apply functions for the maps, checking against the Bit2_T */
+void walk_bit(int i, int j, Bit2RLE_T rle, int value, void *cl);
+void walk_run(int j, int start, int end, Bit2RLE_T rle, void *cl);
+/* check converting one bit array to runs and back */
+int check_round_trip(Bit2_T bit2);
+/* check Bit2RLE_add_run and Bit2RLE_remove_runs on one size */
+int check_add_remove(int width, int height, unsigned *seed);
+/* check unblack and unblack_runs agree on a noisy page */
+int check_unblack(int width, int height, int noise, unsigned *seed);
+/* next value of a fixed linear congruential generator */
+unsigned next_random(unsigned *seed);
+
+int main(int argc, char *argv[])
+{
+    (void) argc;
+    (void) argv;
+
+    int sizes[][2] = { { 1, 1 }, { 64, 3 }, { 65, 40 }, { 131, 67 },
+                       { 1000, 20 } };
+    int num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+    int longest[] = { 1, 5, 70, 300 };
+    unsigned seed = 44;
+    int OK = 1;
+
+    int good = 1;
+    for (int s = 0; s < num_sizes; s++) {
+        int width = sizes[s][0];
+        int height = sizes[s][1];
+        for (int l = 0; l < 4; l++) {
+            Bit2_T bit2 = Bit2_new(width, height);
+            fill_runs(bit2, longest[l], &seed);
+            good &= check_round_trip(bit2);
+            Bit2_free(&bit2);
+
+            /* a view starting partway into a word */
+            Bit2_T parent = Bit2_new(width + 77, height + 5);
+            fill_runs(parent, longest[l], &seed);
+            Bit2_T view = Bit2_view(parent, 37, 3, width, height);
+            good &= check_round_trip(view);
+            Bit2_free(&view);
+            Bit2_free(&parent);
+        }
+    }
+    printf("Converting to runs and back is %sOK\n", good ? "" : "NOT ");
+    OK &= good;
+
+    good = 1;
+    for (int s = 0; s < num_sizes; s++) {
+        good &= check_add_remove(sizes[s][0], sizes[s][1], &seed);
+    }
+    printf("Adding and removing runs is %sOK\n", good ? "" : "NOT ");
+    OK &= good;
+
+    int noises[] = { 0, 20, 300, 550 };
+    good = 1;
+    for (int n = 0; n < 4; n++) {
+        good &= check_unblack(1, 1, noises[n], &seed) &&
+                check_unblack(130, 90, noises[n], &seed) &&
+                check_unblack(400, 300, noises[n], &seed);
+    }
+    printf("Unblacking runs is %sOK\n", good ? "" : "NOT ");
+    OK &= good;
+
+    printf("The run-length encoded arrays are %sOK!\n", OK ? "" : "NOT ");
+    return OK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/***********************************************************
+* fill_runs
+* Description: Fill a bit array with runs of 0s and 1s
+* Input: 1) Bit2_T bit array
+*        2) Integer length of the longest run
+*        3) Pointer to the seed
+* Output: Void
+* Implementation: Runs of 1 to longest bits, 0 and 1 by
+*                 turns, go on from one row into the next. One
+*                 row in ten is then made all 0 or all 1.
+***********************************************************/
+void fill_runs(Bit2_T bit2, int longest, unsigned *seed)
+{
+    int width = Bit2_width(bit2);
+    int height = Bit2_height(bit2);
+    int value = next_random(seed) & 1;
+    int left = 0;
+
+    for (int j = 0; j < height; j++) {
+        for (int i = 0; i < width; i++) {
+            if (left == 0) {
+                value = !value;
+                left = (int) (next_random(seed) % longest) + 1;
+            }
+            Bit2_put(bit2, i, j, value);
+            left--;
+        }
+        if (next_random(seed) % 10 == 0) {
+            Bit2_fill(bit2, 0, j, width, 1, next_random(seed) & 1);
+        }
+    }
+}
+
+/***********************************************************
+* rle_matches
+* Description: Compare a Bit2RLE_T with a Bit2_T
+* Input: Bit2RLE_T and Bit2_T of the same bits
+* Output: 1 if the sizes agree, Bit2RLE_get agrees on every
+*         bit, the runs read by number are in order, maximal
+*         and cover exactly the 1 bits, Bit2RLE_row_first
+*         finds each row's first run, and both maps agree, 0
+*         if not
+***********************************************************/
+int rle_matches(Bit2RLE_T rle, Bit2_T bit2)
+{
+    int width = Bit2_width(bit2);
+    int height = Bit2_height(bit2);
+    int good = Bit2RLE_width(rle) == width &&
+               Bit2RLE_height(rle) == height;
+
+    for (int j = 0; good && j < height; j++) {
+        for (int i = 0; i < width; i++) {
+            good &= Bit2RLE_get(rle, i, j) == Bit2_get(bit2, i, j);
+        }
+    }
+
+    size_t run = 0;
+    for (int j = 0; good && j < height; j++) {
+        good &= Bit2RLE_row_first(rle, j) == run;
+        int i = 0;
+        while (i < width) {
+            if (Bit2_get(bit2, i, j) == 0) {
+                i++;
+                continue;
+            }
+            int end = i;
+            while (end < width && Bit2_get(bit2, end, j) == 1) {
+                end++;
+            }
+            int start, stop;
+            good &= run < Bit2RLE_run_count(rle);
+            if (!good) {
+                break;
+            }
+            Bit2RLE_run(rle, run, &start, &stop);
+            good &= start == i && stop == end;
+            run++;
+            i = end;
+        }
+    }
+    good &= run == Bit2RLE_run_count(rle) &&
+            Bit2RLE_row_first(rle, height) == run;
+
+    Walk walk = { bit2, 0, 0, 0, good };
+    Bit2RLE_map_row_major(rle, walk_bit, &walk);
+    good &= walk.good && walk.i == 0 && walk.j == height;
+
+    Walk runs = { bit2, -1, 0, 0, good };
+    Bit2RLE_map_runs(rle, walk_run, &runs);
+    return runs.good && runs.runs == Bit2RLE_run_count(rle);
+}
+
+/***********************************************************
+* walk_bit, walk_run
+* Description: Check a map of a Bit2RLE_T against the Bit2_T
+* Input: The bit, or the run's row, first column and the
+*        column after its last, the Bit2RLE_T and the Walk
+* Output: Void; good becomes 0 if walk_bit gets a bit out of
+*         row-major order or with the wrong value, or walk_run
+*         a run out of order or not exactly a run of 1 bits
+***********************************************************/
+void walk_bit(int i, int j, Bit2RLE_T rle, int value, void *cl)
+{
+    Walk *walk = cl;
+    (void) rle;
+
+    walk->good &= i == walk->i && j == walk->j &&
+                  value == Bit2_get(walk->bit2, i, j);
+    walk->i = i + 1;
+    if (walk->i == Bit2_width(walk->bit2)) {
+        walk->i = 0;
+        walk->j++;
+    }
+}
+
+void walk_run(int j, int start, int end, Bit2RLE_T rle, void *cl)
+{
+    Walk *walk = cl;
+    int width = Bit2_width(walk->bit2);
+    (void) rle;
+
+    int good = (j > walk->j || (j == walk->j && start > walk->i)) &&
+               start < end && end <= width;
+    for (int i = start; good && i < end; i++) {
+        good = Bit2_get(walk->bit2, i, j) == 1;
+    }
+    good = good && (start == 0 || Bit2_get(walk->bit2, start - 1, j) == 0);
+    good = good && (end == width || Bit2_get(walk->bit2, end, j) == 0);
+    walk->good &= good;
+    walk->i = end;
+    walk->j = j;
+    walk->runs++;
+}
+
+/***********************************************************
+* check_round_trip
+* Description: Convert a bit array to runs and back
+* Input: Bit2_T bit array, which may be a view
+* Output: 1 if the runs match it and Bit2RLE_to_bit2 writes
+*         the same bits into a new bit array and into a view,
+*         leaving the bits around the view alone, 0 if not
+***********************************************************/
+int check_round_trip(Bit2_T bit2)
+{
+    int width = Bit2_width(bit2);
+    int height = Bit2_height(bit2);
+    Bit2RLE_T rle = Bit2RLE_from_bit2(bit2);
+    int good = rle_matches(rle, bit2);
+
+    Bit2_T back = Bit2_new(width, height);
+    Bit2_fill(back, 0, 0, width, height, 1);
+    Bit2RLE_to_bit2(back, rle);
+
+    Bit2_T parent = Bit2_new(width + 70, height + 4);
+    for (int j = 0; j < height + 4; j++) {
+        for (int i = 0; i < width + 70; i++) {
+            Bit2_put(parent, i, j, (i + j) % 3 == 0);
+        }
+    }
+    Bit2_T view = Bit2_view(parent, 61, 2, width, height);
+    Bit2RLE_to_bit2(view, rle);
+
+    for (int j = 0; j < height + 4; j++) {
+        for (int i = 0; i < width + 70; i++) {
+            int inside = i >= 61 && i < 61 + width && j >= 2 &&
+                         j < 2 + height;
+            int bit = inside ? Bit2_get(bit2, i - 61, j - 2)
+                             : (i + j) % 3 == 0;
+            good &= Bit2_get(parent, i, j) == bit;
+            if (inside) {
+                good &= Bit2_get(back, i - 61, j - 2) == bit;
+            }
+        }
+    }
+
+    Bit2_free(&view);
+    Bit2_free(&parent);
+    Bit2_free(&back);
+    Bit2RLE_free(&rle);
+    return good;
+}
+
+/***********************************************************
+* check_add_remove
+* Description: Check building runs and removing them
+* Input: 1) Integer width and height
+*        2) Pointer to the seed
+* Output: 1 if runs added with Bit2RLE_add_run, a third of
+*         them starting where the last ended, match a bit array
+*         with the same bits set, and still match it after
+*         random sets of runs are removed with
+*         Bit2RLE_remove_runs and cleared in the bit array, 0
+*         if not
+***********************************************************/
+int check_add_remove(int width, int height, unsigned *seed)
+{
+    Bit2RLE_T rle = Bit2RLE_new(width, height);
+    Bit2_T bit2 = Bit2_new(width, height);
+    int good = rle_matches(rle, bit2);
+
+    for (int j = 0; j < height; j++) {
+        int i = (int) (next_random(seed) % 4);
+        while (i < width) {
+            int end = i + (int) (next_random(seed) % 40) + 1;
+            end = end < width ? end : width;
+            Bit2RLE_add_run(rle, j, i, end);
+            Bit2_fill(bit2, i, j, end - i, 1, 1);
+            i = next_random(seed) % 3 == 0
+                ? end : end + (int) (next_random(seed) % 30) + 1;
+        }
+    }
+    good &= rle_matches(rle, bit2);
+
+    for (int round = 0; good && round < 3; round++) {
+        size_t count = Bit2RLE_run_count(rle);
+        unsigned char *remove = CALLOC((long) count + 1, 1);
+        for (size_t run = 0; run < count; run++) {
+            remove[run] = round == 2 || next_random(seed) % 3 == 0;
+        }
+        for (int j = 0; j < height; j++) {
+            size_t last = Bit2RLE_row_first(rle, j + 1);
+            for (size_t run = Bit2RLE_row_first(rle, j); run < last;
+                 run++) {
+                int start, end;
+                Bit2RLE_run(rle, run, &start, &end);
+                if (remove[run]) {
+                    Bit2_fill(bit2, start, j, end - start, 1, 0);
+                }
+            }
+        }
+        Bit2RLE_remove_runs(rle, remove);
+        good &= rle_matches(rle, bit2);
+        FREE(remove);
+    }
+    good &= Bit2RLE_run_count(rle) == 0;
+
+    Bit2_free(&bit2);
+    Bit2RLE_free(&rle);
+    return good;
+}
+
+/***********************************************************
+* check_unblack
+* Description: Unblack a noisy page both ways
+* Input: 1) Integer width and height of the page
+*        2) Integer noise, black pixels per 1000
+*        3) Pointer to the seed
+* Output: 1 if unblack on the bit array and unblack_runs on
+*         its runs leave the same black pixels, 0 if not
+* Implementation: A border of 1 to 3 pixels on some sides, so
+*                 the noise touching it is unblacked too, then
+*                 the noise. At 550 per 1000 most black pixels
+*                 join up with the edges, winding through long
+*                 chains of short runs.
+***********************************************************/
+int check_unblack(int width, int height, int noise, unsigned *seed)
+{
+    Bit2_T page = Bit2_new(width, height);
+    int border = (int) (next_random(seed) % 3) + 1;
+    border = border < width && border < height ? border : 0;
+    Bit2_fill(page, 0, 0, width, border, 1);
+    Bit2_fill(page, 0, 0, border, height, 1);
+    for (int j = 0; j < height; j++) {
+        for (int i = 0; i < width; i++) {
+            if ((int) (next_random(seed) % 1000) < noise) {
+                Bit2_put(page, i, j, 1);
+            }
+        }
+    }
+    Bit2RLE_T runs = Bit2RLE_from_bit2(page);
+
+    Arena_T arena = Arena_new();
+    Bit2_T visited = Bit2_new(width, height);
+    Index_stack stack = { arena, NULL, 0, 0, NULL };
+    get_edges(page, &stack, visited);
+    unblack_runs(runs, arena, NULL);
+    int good = rle_matches(runs, page);
+
+    Arena_dispose(&arena);
+    Bit2_free(&visited);
+    Bit2RLE_free(&runs);
+    Bit2_free(&page);
+    return good;
+}
+
+/***********************************************************
+* next_random
+* Description: Step a linear congruential generator
+* Input: Pointer to the seed, updated
+* Output: 15 random bits
+* Implementation: Same generator as pbmgen.
+***********************************************************/
+unsigned next_random(unsigned *seed)
+{
+    *seed = *seed * 1103515245 + 12345;
+    return (*seed / 65536) % 32768;
+}
@@ -0,0 +1,156 @@
+/*************************************************************************
+*                              useuarray2_typed.c
+*
+*
+*      Authors: Jae Hyun Cheigh (jcheig01), Khanh Nguyen (cnguye10)
+*
+*      Fall 2020 - COMP40
+*      HW 2 - Part B
+*
+*
+*      Summary: This program checks the typed arrays from uarray2_tmpl.h:
+*               UArray2_int_T and UArray2_u8_T from uarray2_typed.h,
+*               and UArray2_i64_T, made here to show the template can
+*               be included again for another type. For each, it puts
+*               random values in arrays of several sizes, including
+*               empty ones, beside a UArray2_T of the same element size,
+*               and checks get, put and at against it, then checks that
+*               both maps visit every element once, in order, with a
+*               pointer to it, and that writes through them stick. It
+*               prints whether the arrays are OK and exits 1 if not.
+*
+*               "make check" runs it.
+*
+**************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "uarray2.h"
+#include "uarray2_typed.h"
+
+#define UARRAY2_NAME UArray2_i64
+#define UARRAY2_TYPE int64_t
+#include "uarray2_tmpl.h"
+
+/* what a map has visited: element number next comes next */
+typedef struct Visit {
+    void *array;
+    int next;
+    int col_major;
+    int ordered;
+} Visit;
+
+/* next value of a fixed linear congruential generator */
+unsigned next_random(unsigned *seed);
+
+/*
+ * CHECK_TYPED defines check_NAME(width, height, seed), returning 1 if
+ * the NAME_T arrays of that size are OK, and the apply function
+ * visit_NAME for its maps, which checks the visit and adds one to the
+ * element. TYPE is the element type.
+ */
+#define CHECK_TYPED(NAME, TYPE)                                            \
+void visit_##NAME(int i, int j, NAME##_T array, TYPE *value, void *cl)     \
+{                                                                          \
+    Visit *visit = cl;                                                     \
+    int width = NAME##_width(array);                                       \
+    int height = NAME##_height(array);                                     \
+    int expected = visit->col_major ? i * height + j : j * width + i;      \
+    visit->ordered &= (void *) array == visit->array &&                    \
+                      expected == visit->next &&                           \
+                      value == NAME##_at(array, i, j);                     \
+    visit->next++;                                                         \
+    (*value)++;                                                            \
+}                                                                          \
+                                                                           \
+int check_##NAME(int width, int height, unsigned *seed)                    \
+{                                                                          \
+    NAME##_T array = NAME##_new(width, height);                            \
+    UArray2_T reference = UArray2_new(width, height, sizeof(TYPE));        \
+    int good = NAME##_width(array) == width &&                             \
+               NAME##_height(array) == height;                             \
+                                                                           \
+    for (int j = 0; j < height; j++) {                                     \
+        for (int i = 0; i < width; i++) {                                  \
+            TYPE value = (TYPE) next_random(seed);                         \
+            good &= NAME##_put(array, i, j, value) == 0;                   \
+            *(TYPE *) UArray2_at(reference, i, j) = value;                 \
+        }                                                                  \
+    }                                                                      \
+    for (int j = 0; j < height; j++) {                                     \
+        for (int i = 0; i < width; i++) {                                  \
+            TYPE value = *(TYPE *) UArray2_at(reference, i, j);            \
+            good &= NAME##_get(array, i, j) == value &&                    \
+                    *NAME##_at(array, i, j) == value;                      \
+        }                                                                  \
+    }                                                                      \
+                                                                           \
+    for (int col_major = 0; col_major <= 1; col_major++) {                 \
+        Visit visit = { array, 0, col_major, 1 };                          \
+        if (col_major) {                                                   \
+            NAME##_map_col_major(array, visit_##NAME, &visit);             \
+        }                                                                  \
+        else {                                                             \
+            NAME##_map_row_major(array, visit_##NAME, &visit);             \
+        }                                                                  \
+        good &= visit.ordered && visit.next == width * height;             \
+    }                                                                      \
+    for (int j = 0; j < height; j++) {                                     \
+        for (int i = 0; i < width; i++) {                                  \
+            TYPE value = (TYPE) (*(TYPE *) UArray2_at(reference, i, j) + 2);\
+            good &= NAME##_put(array, i, j, 0) == value;                   \
+        }                                                                  \
+    }                                                                      \
+                                                                           \
+    NAME##_free(&array);                                                   \
+    UArray2_free(&reference);                                              \
+    return good;                                                           \
+}
+
+CHECK_TYPED(UArray2_int, int)
+CHECK_TYPED(UArray2_u8, uint8_t)
+CHECK_TYPED(UArray2_i64, int64_t)
+
+int main(int argc, char *argv[])
+{
+    (void) argc;
+    (void) argv;
+
+    int sizes[][2] = { { 0, 0 }, { 0, 5 }, { 6, 0 }, { 1, 1 }, { 9, 9 },
+                       { 16, 16 }, { 257, 3 }, { 3, 257 }, { 640, 480 } };
+    int num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+    unsigned seed = 33;
+    int OK = 1;
+
+    const char *names[3] = { "UArray2_int_T", "UArray2_u8_T",
+                             "UArray2_i64_T" };
+    for (int type = 0; type < 3; type++) {
+        int good = 1;
+        for (int s = 0; s < num_sizes; s++) {
+            int width = sizes[s][0];
+            int height = sizes[s][1];
+            good &= type == 0 ? check_UArray2_int(width, height, &seed)
+                  : type == 1 ? check_UArray2_u8(width, height, &seed)
+                  : check_UArray2_i64(width, height, &seed);
+        }
+        printf("%s arrays are %sOK\n", names[type], good ? "" : "NOT ");
+        OK &= good;
+    }
+
+    printf("The typed arrays are %sOK!\n", OK ? "" : "NOT ");
+    return OK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/***********************************************************
+* next_random
+* Description: Step a linear congruential generator
+* Input: Pointer to the seed, updated
+* Output: 15 random bits
+* Implementation: Same generator as pbmgen.
+***********************************************************/
+unsigned next_random(unsigned *seed)
+{
+    *seed = *seed * 1103515245 + 12345;
+    return (*seed / 65536) % 32768;
+}
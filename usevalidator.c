@@ -0,0 +1,245 @@
+/*************************************************************************
+*                              usevalidator.c
+*
+*
+*      Authors: Jae Hyun Cheigh (jcheig01), Khanh Nguyen (cnguye10)
+*
+*      Fall 2020 - COMP40
+*      HW 2 - Part B
+*
+*
+*      Summary: This program exercises the Validator_T interface. It
+*               makes a few edits by hand and checks the conflict count
+*               and set after each, then makes many random edits on
+*               sudokus of every submap size, and after every one
+*               compares the validator against counting the digits of
+*               every row, column and submap from scratch. It prints
+*               whether the validator is OK and exits 1 if not.
+*
+*               "make check" runs it.
+*
+**************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "validator.h"
+#include "solver.h"
+
+/* random edits for each submap size */
+#define EDITS 2000
+
+/* what Validator_map_conflicts reported */
+typedef struct Reported {
+    int width;
+    int cells;
+    unsigned char seen[MAX_BOX * MAX_BOX * MAX_BOX * MAX_BOX];
+    int twice;
+} Reported;
+
+/* apply function for Validator_map_conflicts, noting each cell */
+void note_cell(int i, int j, int value, void *cl);
+/* check the validator against a count from scratch */
+int matches_scratch(Validator_T validator);
+/* check the conflict count and that exactly the cells listed conflict */
+int expect(Validator_T validator, int conflicts, int count, const int *cells);
+/* next value of a fixed linear congruential generator */
+unsigned next_random(unsigned *seed);
+
+int main(int argc, char *argv[])
+{
+    (void) argc;
+    (void) argv;
+
+    int OK = 1;
+
+    /* by hand, on a 9x9 sudoku: cells are listed as column, row */
+    Validator_T validator = Validator_new(3);
+    OK &= Validator_width(validator) == 9;
+    OK &= expect(validator, 0, 0, NULL);
+
+    /* a 5 twice in row 0 */
+    Validator_set(validator, 0, 0, 5);
+    OK &= Validator_set(validator, 4, 0, 5) == 1;
+    OK &= expect(validator, 1, 2, (int[]) { 0, 0, 4, 0 });
+
+    /* and twice in the top left submap, (0, 0) in both */
+    OK &= Validator_set(validator, 1, 1, 5) == 2;
+    OK &= expect(validator, 2, 3, (int[]) { 0, 0, 4, 0, 1, 1 });
+
+    /* a different digit in column 4 is no conflict */
+    Validator_set(validator, 4, 8, 7);
+    OK &= expect(validator, 2, 3, (int[]) { 0, 0, 4, 0, 1, 1 });
+
+    /* emptying (0, 0) ends both */
+    OK &= Validator_set(validator, 0, 0, 0) == 0;
+    OK &= Validator_get(validator, 0, 0) == 0;
+    OK &= expect(validator, 0, 0, NULL);
+
+    /* three of a digit in a column are one conflict, and changing
+       one of them leaves the other two */
+    Validator_set(validator, 8, 0, 3);
+    Validator_set(validator, 8, 4, 3);
+    Validator_set(validator, 8, 8, 3);
+    OK &= expect(validator, 1, 3, (int[]) { 8, 0, 8, 4, 8, 8 });
+    Validator_set(validator, 8, 4, 2);
+    OK &= expect(validator, 1, 2, (int[]) { 8, 0, 8, 8 });
+    Validator_free(&validator);
+    printf("Edits by hand are %sOK\n", OK ? "" : "NOT ");
+
+    /* random edits, a third of them emptying a cell */
+    unsigned seed = 40;
+    for (int box = 1; box <= MAX_BOX; box++) {
+        validator = Validator_new(box);
+        int width = box * box;
+        int good = 1;
+        for (int edit = 0; edit < EDITS && good; edit++) {
+            int i = next_random(&seed) % width;
+            int j = next_random(&seed) % width;
+            int value = next_random(&seed) % 3 == 0
+                        ? 0 : 1 + (int) (next_random(&seed) % width);
+            Validator_set(validator, i, j, value);
+            good = Validator_get(validator, i, j) == value &&
+                   matches_scratch(validator);
+        }
+        printf("Random edits with %dx%d submaps are %sOK\n", box, box,
+               good ? "" : "NOT ");
+        OK &= good;
+        Validator_free(&validator);
+    }
+
+    printf("The validator is %sOK!\n", OK ? "" : "NOT ");
+    return OK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/***********************************************************
+* note_cell
+* Description: Apply function for Validator_map_conflicts
+* Input: 1) Integer column i and row j of the cell
+*        2) Integer digit in it
+*        3) Pointer to the Reported record
+* Output: Void
+* Implementation: Mark the cell, and note if it was already
+*                 marked, since each should come once.
+***********************************************************/
+void note_cell(int i, int j, int value, void *cl)
+{
+    (void) value;
+
+    Reported *reported = cl;
+    unsigned char *seen = &reported->seen[j * reported->width + i];
+    if (*seen) {
+        reported->twice = 1;
+    }
+    *seen = 1;
+    reported->cells++;
+}
+
+/***********************************************************
+* matches_scratch
+* Description: Check a validator against counting from
+*              scratch
+* Input: Validator_T validator
+* Output: 1 if the conflict count, Validator_in_conflict of
+*         every cell and the cells Validator_map_conflicts
+*         reports all agree with the count, 0 if not
+* Implementation: Count each digit in each row, column and
+*                 submap. A digit counted twice or more is one
+*                 conflict of the unit, and every cell holding
+*                 it is in the conflict set.
+***********************************************************/
+int matches_scratch(Validator_T validator)
+{
+    int width = Validator_width(validator);
+    int box = 1;
+    while (box * box < width) {
+        box++;
+    }
+
+    static unsigned char in_set[MAX_BOX * MAX_BOX * MAX_BOX * MAX_BOX];
+    memset(in_set, 0, sizeof(in_set));
+    int conflicts = 0;
+
+    for (int kind = 0; kind < 3; kind++) {
+        for (int which = 0; which < width; which++) {
+            int count[MAX_BOX * MAX_BOX + 1] = { 0 };
+            int cols[MAX_BOX * MAX_BOX], rows[MAX_BOX * MAX_BOX];
+            for (int idx = 0; idx < width; idx++) {
+                int i = kind == 0 ? idx : kind == 1 ? which
+                        : (which % box) * box + idx % box;
+                int j = kind == 0 ? which : kind == 1 ? idx
+                        : (which / box) * box + idx / box;
+                cols[idx] = i;
+                rows[idx] = j;
+                count[Validator_get(validator, i, j)]++;
+            }
+            for (int digit = 1; digit <= width; digit++) {
+                conflicts += count[digit] > 1;
+            }
+            for (int idx = 0; idx < width; idx++) {
+                int value = Validator_get(validator, cols[idx], rows[idx]);
+                if (value != 0 && count[value] > 1) {
+                    in_set[rows[idx] * width + cols[idx]] = 1;
+                }
+            }
+        }
+    }
+
+    static Reported reported;
+    memset(&reported, 0, sizeof(reported));
+    reported.width = width;
+    Validator_map_conflicts(validator, note_cell, &reported);
+
+    int good = Validator_conflicts(validator) == conflicts &&
+               !reported.twice;
+    for (int j = 0; j < width; j++) {
+        for (int i = 0; i < width; i++) {
+            int member = in_set[j * width + i];
+            good &= Validator_in_conflict(validator, i, j) == member;
+            good &= reported.seen[j * width + i] == member;
+        }
+    }
+    return good;
+}
+
+/***********************************************************
+* expect
+* Description: Check the conflicts of a validator
+* Input: 1) Validator_T validator
+*        2) Integer number of conflicts expected
+*        3) Integer number of cells expected in conflict
+*        4) Their column and row indices, in pairs
+* Output: 1 if the count and the conflict set, both from
+*         Validator_map_conflicts and from
+*         Validator_in_conflict, are as expected, 0 if not
+***********************************************************/
+int expect(Validator_T validator, int conflicts, int count, const int *cells)
+{
+    static Reported reported;
+    memset(&reported, 0, sizeof(reported));
+    reported.width = Validator_width(validator);
+    Validator_map_conflicts(validator, note_cell, &reported);
+
+    int good = Validator_conflicts(validator) == conflicts &&
+               reported.cells == count && !reported.twice;
+    for (int c = 0; c < count; c++) {
+        int i = cells[2 * c];
+        int j = cells[2 * c + 1];
+        good &= reported.seen[j * reported.width + i] == 1;
+        good &= Validator_in_conflict(validator, i, j);
+    }
+    return good && matches_scratch(validator);
+}
+
+/***********************************************************
+* next_random
+* Description: Step a linear congruential generator
+* Input: Pointer to the seed, updated
+* Output: 15 random bits
+* Implementation: Same generator as pbmgen.
+***********************************************************/
+unsigned next_random(unsigned *seed)
+{
+    *seed = *seed * 1103515245 + 12345;
+    return (*seed / 65536) % 32768;
+}
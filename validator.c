@@ -0,0 +1,335 @@
+/*************************************************************************
+*                              validator.c
+*
+*
+*      Authors: Jae Hyun Cheigh (jcheig01), Khanh Nguyen (cnguye10)
+*
+*      Fall 2020 - COMP40
+*      HW 2 - Part B
+*
+*
+*      Summary: This file implements the incremental sudoku validator.
+*               Every row, column and submap (a "unit") counts how many
+*               times each digit appears in it, and keeps a 64-bit mask
+*               of the digits that appear more than once. Setting a cell
+*               only touches the counts of its three units, and the
+*               total number of repeated digits is kept up to date as
+*               the counts cross from 1 to 2 and back.
+*
+**************************************************************************/
+
+#include <stdlib.h>
+#include <stdint.h>
+#include "validator.h"
+#include "solver.h"
+#include "assert.h"
+#include "mem.h"
+
+#define T Validator_T
+
+/*
+ * data that our validator holds. Units are numbered rows first, then
+ * columns, then submaps. count has width + 1 entries per unit, one
+ * per digit, and dup has bit d - 1 set when digit d is repeated.
+ */
+struct T {
+    int box;
+    int width;
+    int conflicts;
+    unsigned char *cell;
+    unsigned char *count;
+    uint64_t *dup;
+};
+
+/* add delta to the count of a digit in a unit, updating conflicts */
+static void update_unit(T validator, int unit, int digit, int delta);
+/* call apply on the cells of a unit holding a repeated digit */
+static void map_unit(T validator, int unit, void apply(int i, int j,
+                     int value, void *cl), void *cl);
+
+/****************************************************************
+ * Validator_new
+ * Description: Create a new validator for an empty sudoku with
+ *              box x box submaps
+ * Inputs: Integer value of the submap size
+ * Output: Validator_T with every cell empty and no conflicts
+ * Implementation: Allocate the cells and the per-unit counts and
+ *                 masks, all zero since every cell is empty.
+ *****************************************************************/
+T Validator_new(int box)
+{
+    assert(box >= 1 && box <= MAX_BOX);
+
+    T validator;
+    NEW(validator);
+
+    int width = box * box;
+    validator->box = box;
+    validator->width = width;
+    validator->conflicts = 0;
+    validator->cell = CALLOC(width * width, sizeof(unsigned char));
+    validator->count = CALLOC(3 * width * (width + 1),
+                              sizeof(unsigned char));
+    validator->dup = CALLOC(3 * width, sizeof(uint64_t));
+
+    return validator;
+}
+
+/******************************************************************
+ * Validator_width
+ * Description: Get the width of the sudoku
+ * Inputs: Validator_T validator
+ * Output: Integer width of the sudoku
+ * Implementation: Check if validator is not null and return width.
+ ******************************************************************/
+int Validator_width(T validator)
+{
+    assert(validator != NULL);
+    return validator->width;
+}
+
+/******************************************************************
+ * Validator_get
+ * Description: Get the digit in the cell at column i, row j
+ * Inputs: 1) Validator_T validator
+ *         2) Integer column index i
+ *         3) Integer row index j
+ * Output: Integer digit in the cell, 0 if the cell is empty
+ * Implementation: Cells are stored row by row.
+ ******************************************************************/
+int Validator_get(T validator, int i, int j)
+{
+    assert(validator != NULL);
+
+    int width = validator->width;
+    assert(i >= 0 && i < width && j >= 0 && j < width);
+
+    return validator->cell[width * j + i];
+}
+
+/******************************************************************
+ * Validator_set
+ * Description: Put a digit in the cell at column i, row j, or empty
+ *              the cell with digit 0
+ * Inputs: 1) Validator_T validator
+ *         2) Integer column index i
+ *         3) Integer row index j
+ *         4) Integer digit from 0 to the width
+ * Output: Integer number of conflicts after the edit
+ * Implementation: Take the old digit out of the row, column and
+ *                 submap of the cell and put the new one in. Only
+ *                 these three units can gain or lose a conflict.
+ ******************************************************************/
+int Validator_set(T validator, int i, int j, int value)
+{
+    assert(validator != NULL);
+
+    int width = validator->width;
+    int box = validator->box;
+    assert(i >= 0 && i < width && j >= 0 && j < width);
+    assert(value >= 0 && value <= width);
+
+    int row = j;
+    int col = width + i;
+    int sub = 2 * width + (j / box) * box + i / box;
+    int old = validator->cell[width * j + i];
+
+    if (old == value) {
+        return validator->conflicts;
+    }
+    if (old != 0) {
+        update_unit(validator, row, old, -1);
+        update_unit(validator, col, old, -1);
+        update_unit(validator, sub, old, -1);
+    }
+    if (value != 0) {
+        update_unit(validator, row, value, 1);
+        update_unit(validator, col, value, 1);
+        update_unit(validator, sub, value, 1);
+    }
+    validator->cell[width * j + i] = (unsigned char) value;
+
+    return validator->conflicts;
+}
+
+/******************************************************************
+ * Validator_conflicts
+ * Description: Get the number of conflicts in the sudoku
+ * Inputs: Validator_T validator
+ * Output: Integer number of repeated digits over all units
+ * Implementation: Kept up to date by Validator_set.
+ ******************************************************************/
+int Validator_conflicts(T validator)
+{
+    assert(validator != NULL);
+    return validator->conflicts;
+}
+
+/******************************************************************
+ * Validator_in_conflict
+ * Description: Check if the cell at column i, row j is part of a
+ *              conflict
+ * Inputs: 1) Validator_T validator
+ *         2) Integer column index i
+ *         3) Integer row index j
+ * Output: 1 if the cell's digit is repeated in one of its units
+ * Implementation: Look for the digit's bit in the repeated-digit
+ *                 masks of the cell's row, column and submap.
+ ******************************************************************/
+int Validator_in_conflict(T validator, int i, int j)
+{
+    assert(validator != NULL);
+
+    int width = validator->width;
+    int box = validator->box;
+    assert(i >= 0 && i < width && j >= 0 && j < width);
+
+    int value = validator->cell[width * j + i];
+    if (value == 0) {
+        return 0;
+    }
+
+    uint64_t *dup = validator->dup;
+    uint64_t bit = (uint64_t) 1 << (value - 1);
+    uint64_t masks = dup[j] | dup[width + i] |
+                     dup[2 * width + (j / box) * box + i / box];
+
+    return (masks & bit) != 0;
+}
+
+/*****************************************************************
+* Validator_map_conflicts
+* Description: Call apply once for every cell that is part of a
+*              conflict
+* Inputs: 1) Validator_T validator
+*         2) A void apply function that takes in column and row
+*            indices, the digit in the cell and a void pointer closure
+*         3) A void pointer closure
+* Output: Void
+* Implementation: Skip units with no repeated digit, and look only
+*                 through the cells of those that have one.
+ ******************************************************************/
+void Validator_map_conflicts(T validator, void apply(int i, int j,
+                             int value, void *cl), void *cl)
+{
+    assert(validator != NULL);
+    assert(apply != NULL);
+
+    if (validator->conflicts == 0) {
+        return;
+    }
+    for (int unit = 0; unit < 3 * validator->width; unit++) {
+        if (validator->dup[unit] != 0) {
+            map_unit(validator, unit, apply, cl);
+        }
+    }
+}
+
+/******************************************************************
+ * Validator_free
+ * Description: Deallocate memory used by validator
+ * Inputs: An address to validator
+ * Output: Void
+ * Implementation: Free the cells, counts and masks, then the
+ *                 validator itself.
+ ******************************************************************/
+void Validator_free(T *validator)
+{
+    assert(validator != NULL && *validator != NULL);
+
+    FREE((*validator)->cell);
+    FREE((*validator)->count);
+    FREE((*validator)->dup);
+    FREE(*validator);
+}
+
+/******************************************************************
+ * update_unit
+ * Description: Change how many times a digit appears in a unit
+ * Inputs: 1) Validator_T validator
+ *         2) Integer index of the unit
+ *         3) Integer digit from 1 to the width
+ *         4) Integer delta, 1 or -1
+ * Output: Void
+ * Implementation: A digit becomes repeated when its count goes from
+ *                 1 to 2 and stops being repeated when it goes back
+ *                 from 2 to 1, so only those steps touch the mask
+ *                 and the number of conflicts.
+ ******************************************************************/
+static void update_unit(T validator, int unit, int digit, int delta)
+{
+    unsigned char *count = &validator->count[unit * (validator->width + 1)
+                                             + digit];
+    uint64_t bit = (uint64_t) 1 << (digit - 1);
+
+    if (delta > 0) {
+        (*count)++;
+        if (*count == 2) {
+            validator->dup[unit] |= bit;
+            validator->conflicts++;
+        }
+    }
+    else {
+        (*count)--;
+        if (*count == 1) {
+            validator->dup[unit] &= ~bit;
+            validator->conflicts--;
+        }
+    }
+}
+
+/******************************************************************
+ * map_unit
+ * Description: Call apply on the cells of a unit that hold one of
+ *              its repeated digits
+ * Inputs: 1) Validator_T validator
+ *         2) Integer index of a unit with a repeated digit
+ *         3) Apply function and closure from Validator_map_conflicts
+ * Output: Void
+ * Implementation: Walk the cells of the row, column or submap. A
+ *                 cell can be in conflict in more than one of its
+ *                 units, so it is only reported by the first of its
+ *                 units (row, then column, then submap) that flags
+ *                 its digit.
+ ******************************************************************/
+static void map_unit(T validator, int unit, void apply(int i, int j,
+                     int value, void *cl), void *cl)
+{
+    int width = validator->width;
+    int box = validator->box;
+    int kind = unit / width;
+    int which = unit % width;
+    uint64_t *dup = validator->dup;
+
+    for (int idx = 0; idx < width; idx++) {
+        int i, j;
+        if (kind == 0) {
+            i = idx;
+            j = which;
+        }
+        else if (kind == 1) {
+            i = which;
+            j = idx;
+        }
+        else {
+            i = (which % box) * box + idx % box;
+            j = (which / box) * box + idx / box;
+        }
+
+        int value = validator->cell[width * j + i];
+        if (value == 0) {
+            continue;
+        }
+        uint64_t bit = (uint64_t) 1 << (value - 1);
+        if ((dup[unit] & bit) == 0) {
+            continue;
+        }
+        if (kind >= 1 && (dup[j] & bit) != 0) {
+            continue;
+        }
+        if (kind == 2 && (dup[width + i] & bit) != 0) {
+            continue;
+        }
+        apply(i, j, value, cl);
+    }
+}
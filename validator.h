@@ -0,0 +1,136 @@
+/*************************************************************************
+*                              validator.h
+*
+*
+*      Authors: Jae Hyun Cheigh (jcheig01), Khanh Nguyen (cnguye10)
+*
+*      Fall 2020 - COMP40
+*      HW 2 - Part B
+*
+*
+*      Summary: This is the header file for the Validator data structure.
+*               A Validator_T holds a sudoku that is being edited one
+*               cell at a time, and keeps count of every digit in every
+*               row, column and submap so that each edit updates the
+*               conflicts in constant time instead of re-checking the
+*               whole grid.
+*
+**************************************************************************/
+
+#ifndef VALIDATOR_INCLUDED
+#define VALIDATOR_INCLUDED
+
+#define T Validator_T
+typedef struct T *T;
+
+/****************************************************************
+ * Validator_new
+ * Description: Create a new validator for an empty sudoku with
+ *              box x box submaps, so box*box cells wide and high.
+ * Inputs: Integer value of the submap size
+ * Expectation: Submap size must be between 1 and 8.
+ * Output: Validator_T with every cell empty and no conflicts
+ * Expectation: If the submap size is out of range, exit with assert.
+ *****************************************************************/
+extern T Validator_new(int box);
+
+/******************************************************************
+ * Validator_width
+ * Description: Get the width (and height) of the sudoku, which is
+ *              also the largest digit allowed
+ * Inputs: Validator_T validator
+ * Expectation: Parameter validator must not be null.
+ * Output: Integer width of the sudoku
+ * Expectation: If the parameter validator is null, exit with assert.
+ ******************************************************************/
+extern int Validator_width(T validator);
+
+/******************************************************************
+ * Validator_get
+ * Description: Get the digit in the cell at column i, row j
+ * Inputs: 1) Validator_T validator
+ *         2) Integer column index i
+ *         3) Integer row index j
+ * Expectation: Parameter validator must not be null and indices
+ *              must be inside the sudoku.
+ * Output: Integer digit in the cell, 0 if the cell is empty
+ * Expectation: If validator is null or an index is out of range,
+ *              exit with assert.
+ ******************************************************************/
+extern int Validator_get(T validator, int i, int j);
+
+/******************************************************************
+ * Validator_set
+ * Description: Put a digit in the cell at column i, row j, or empty
+ *              the cell with digit 0
+ * Inputs: 1) Validator_T validator
+ *         2) Integer column index i
+ *         3) Integer row index j
+ *         4) Integer digit from 0 to the width
+ * Expectation: Parameter validator must not be null, indices must
+ *              be inside the sudoku, and the digit in range.
+ * Output: Integer number of conflicts after the edit, 0 if valid
+ * Expectation: If validator is null or an index or the digit is out
+ *              of range, exit with assert.
+ *              Otherwise, only the row, column and submap of the cell
+ *              are updated, in constant time.
+ ******************************************************************/
+extern int Validator_set(T validator, int i, int j, int value);
+
+/******************************************************************
+ * Validator_conflicts
+ * Description: Get the number of conflicts in the sudoku, where a
+ *              conflict is a digit that appears more than once in
+ *              the same row, column or submap
+ * Inputs: Validator_T validator
+ * Expectation: Parameter validator must not be null.
+ * Output: Integer number of conflicts, 0 if the sudoku is valid
+ * Expectation: If the parameter validator is null, exit with assert.
+ ******************************************************************/
+extern int Validator_conflicts(T validator);
+
+/******************************************************************
+ * Validator_in_conflict
+ * Description: Check if the cell at column i, row j is part of a
+ *              conflict
+ * Inputs: 1) Validator_T validator
+ *         2) Integer column index i
+ *         3) Integer row index j
+ * Expectation: Parameter validator must not be null and indices
+ *              must be inside the sudoku.
+ * Output: 1 if the cell's digit is repeated in its row, column or
+ *         submap, otherwise 0
+ * Expectation: If validator is null or an index is out of range,
+ *              exit with assert.
+ ******************************************************************/
+extern int Validator_in_conflict(T validator, int i, int j);
+
+/*****************************************************************
+* Validator_map_conflicts
+* Description: Call apply once for every cell that is part of a
+*              conflict, which is the current conflict set
+* Inputs: 1) Validator_T validator
+*         2) A void apply function that takes in column and row
+*            indices, the digit in the cell and a void pointer closure
+*         3) A void pointer closure
+* Expectation: Parameter validator and apply must not be null.
+* Output: Void
+* Expectation: If the parameter validator or apply is null, exit with
+*              assert. Only rows, columns and submaps that have a
+*              conflict are looked at.
+ ******************************************************************/
+extern void Validator_map_conflicts(T validator, void apply(int i, int j,
+                                    int value, void *cl), void *cl);
+
+/******************************************************************
+ * Validator_free
+ * Description: Deallocate memory used by validator
+ * Inputs: An address to validator
+ * Expectation: An address must not be null.
+ * Output: Void
+ * Expectation: If the parameter address is null, exit with assert.
+ ******************************************************************/
+extern void Validator_free(T *validator);
+
+#undef T
+#endif